@@ -1,11 +1,20 @@
 #pragma once
 
 #include <cmath>
+#include <cstring>
+#include <limits>
+#include <map>
 #define M_PI 3.14159265358979323846
 #include <vector>
+#include <string>
+#include <algorithm>
 #include "gl_helper.h"
 #include "gl_base.h"
 #include "gl_debug.h"
+#include "gl_thread.h"
+#include "gl_transform.h"
+#include "gl_cull.h"
+#include "gl_lod.h"
 #include <glm/glm.hpp>
 #include <glm/gtc/quaternion.hpp>
 #include <glm/gtx/quaternion.hpp>
@@ -19,6 +28,58 @@
 namespace jikoLib{
 	namespace GLLib{
 
+		/**
+		 * std140 layout traits for glm types
+		 *
+		 */
+
+		template<typename VecType, std::size_t align>
+			struct Std140Vec
+			{
+				constexpr static std::size_t ALIGN = align;
+				constexpr static std::size_t SIZE = sizeof(VecType);
+				inline static void write(GLubyte* dst, const VecType &value)
+				{
+					std::memcpy(dst, glm::value_ptr(value), SIZE);
+				}
+			};
+
+		template<>
+			struct Std140<glm::vec2> : public Std140Vec<glm::vec2, 8>{};
+		template<>
+			struct Std140<glm::vec3> : public Std140Vec<glm::vec3, 16>{};
+		template<>
+			struct Std140<glm::vec4> : public Std140Vec<glm::vec4, 16>{};
+		template<>
+			struct Std140<glm::ivec2> : public Std140Vec<glm::ivec2, 8>{};
+		template<>
+			struct Std140<glm::ivec3> : public Std140Vec<glm::ivec3, 16>{};
+		template<>
+			struct Std140<glm::ivec4> : public Std140Vec<glm::ivec4, 16>{};
+
+		//matrix is stored as an array of column vectors (each column is aligned to vec4)
+		template<typename MatType, std::size_t col>
+			struct Std140Mat
+			{
+				constexpr static std::size_t ALIGN = 16;
+				constexpr static std::size_t SIZE = 16*col;
+				inline static void write(GLubyte* dst, const MatType &value)
+				{
+					std::memset(dst, 0, SIZE);
+					for(std::size_t i = 0; i < col; i++)
+					{
+						std::memcpy(dst+16*i, glm::value_ptr(value[i]), sizeof(value[i]));
+					}
+				}
+			};
+
+		template<>
+			struct Std140<glm::mat2> : public Std140Mat<glm::mat2, 2>{};
+		template<>
+			struct Std140<glm::mat3> : public Std140Mat<glm::mat3, 3>{};
+		template<>
+			struct Std140<glm::mat4> : public Std140Mat<glm::mat4, 4>{};
+
 		class Mesh3D{
 			private:
 				VBO vertex;
@@ -27,16 +88,64 @@ namespace jikoLib{
 				IBO index;
 				VAO v_array;
 
-				glm::vec3 pos;
-				glm::quat rot;
-				glm::vec3 scale;
+				//interleaved storage (VertexPNT or VertexPN)
+				VBO interleaved;
+				bool is_interleaved = false;
+
+				Transform transform;
+
+				//model space bounds of the vertices (set by copyData)
+				BoundingBox bound_box;
+				BoundingSphere bound_sphere;
+
+				//buffers set by setInstanceBuffer, keyed by their first location: (locations used, instances)
+				std::map<GLuint, std::pair<GLuint, GLsizei>> instance_buffers;
+
+				//LOD levels in the index buffer (empty: the whole buffer is drawn)
+				std::vector<LodLevel> lods;
+				std::size_t lod = 0;
+
+				//the buffers are stored in the vertex array at the fixed locations (see VertexLayout)
+				inline void bakeLayout()
+				{
+					if(vertex.getisSetArray())
+						v_array.setAttrib(AttribLocation::VERTEX, vertex);
+					if(normal.getisSetArray())
+						v_array.setAttrib(AttribLocation::NORMAL, normal);
+					if(texcrd.getisSetArray())
+						v_array.setAttrib(AttribLocation::TEXCRD, texcrd);
+				}
+
+				template<typename T>
+					void copyInterleaved(const T *vert, const T *norm, const T *tex, std::size_t Size_Elem)
+					{
+						if(tex != nullptr)
+						{
+							std::vector<VertexPNT> array(Size_Elem);
+							for(std::size_t i = 0; i < Size_Elem; i++)
+							{
+								std::copy(vert+3*i, vert+3*i+3, array[i].vertex);
+								std::copy(norm+3*i, norm+3*i+3, array[i].normal);
+								std::copy(tex +2*i, tex +2*i+2, array[i].texcrd);
+							}
+							copyData(array.data(), Size_Elem);
+						}
+						else
+						{
+							std::vector<VertexPN> array(Size_Elem);
+							for(std::size_t i = 0; i < Size_Elem; i++)
+							{
+								std::copy(vert+3*i, vert+3*i+3, array[i].vertex);
+								std::copy(norm+3*i, norm+3*i+3, array[i].normal);
+							}
+							copyData(array.data(), Size_Elem);
+							v_array.disableAttrib(AttribLocation::TEXCRD);
+						}
+					}
 
 			public:
 
-				Mesh3D()
-					:pos(0.0f, 0.0f, 0.0f),
-					rot(1.0f, 0.0f, 0.0f, 0.0f),
-					scale(1.0f, 1.0f, 1.0f)  {}
+				Mesh3D() {}
 
 				inline const VBO& getVertex() const
 				{
@@ -58,9 +167,26 @@ namespace jikoLib{
 				{
 					return v_array;
 				}
+				inline const VBO& getInterleaved() const
+				{
+					return interleaved;
+				}
+
+				//store vertex, normal and texcrd in one buffer. set this before copyData.
+				inline void setInterleaved(bool flag)
+				{
+					is_interleaved = flag;
+				}
+
+				inline bool getIsInterleaved() const
+				{
+					return is_interleaved;
+				}
 
 				inline bool getIsSetArray() const
 				{
+					if(is_interleaved)
+						return interleaved.getisSetArray();
 					return 
 						vertex.getisSetArray() &&
 						normal.getisSetArray() &&
@@ -75,85 +201,432 @@ namespace jikoLib{
 				template<typename T, std::size_t Size_Elem>
 					inline void copyData(const T (&vert)[Size_Elem][3], const T (&norm)[Size_Elem][3], const T (&tex)[Size_Elem][2])
 					{
+						if(is_interleaved)
+						{
+							copyInterleaved(&vert[0][0], &norm[0][0], &tex[0][0], Size_Elem);
+							return;
+						}
+						computeBounds(&vert[0][0], Size_Elem, 3, bound_box, bound_sphere);
 						vertex.copyData(vert);
 						normal.copyData(norm);
 						texcrd.copyData(tex );
+						bakeLayout();
 					}
 
 				template<typename T, std::size_t Size_Elem>
 					inline void copyData(const T (&vert)[Size_Elem][3], const T (&norm)[Size_Elem][3])
 					{
+						if(is_interleaved)
+						{
+							copyInterleaved(&vert[0][0], &norm[0][0], static_cast<const T*>(nullptr), Size_Elem);
+							return;
+						}
+						computeBounds(&vert[0][0], Size_Elem, 3, bound_box, bound_sphere);
 						vertex.copyData(vert);
 						normal.copyData(norm);
+						bakeLayout();
+					}
+
+				//interleaved vertex array (VertexType must have VertexTraits)
+				template<typename VertexType>
+					void copyData(const VertexType *vertices, std::size_t Size_Elem)
+					{
+						static_assert(std::is_class<VertexType>::value, "VertexType must be a vertex struct");
+						static_assert(sizeof(VertexType)%sizeof(GLfloat) == 0, "VertexType must consist of GLfloat");
+						is_interleaved = true;
+						computeBounds(&vertices[0].vertex[0], Size_Elem, sizeof(VertexType)/sizeof(GLfloat), bound_box, bound_sphere);
+						interleaved.copyData(reinterpret_cast<const GLfloat*>(vertices), Size_Elem, sizeof(VertexType)/sizeof(GLfloat));
+						v_array.template setAttrib<VertexType>(interleaved);
 					}
 
 				template<typename T, std::size_t Size_Elem>
 					inline void copyIndex(const T (&ind)[Size_Elem])
 					{
 						index.copyData(ind);
+						v_array.bindIBO(index);
+						lods.clear();
+						lod = 0;
 					}
 
 				template<typename T>
 					inline void copyData(const T *vert, const T *norm, const T *tex, std::size_t Size_Elem)
 					{
+						if(is_interleaved)
+						{
+							copyInterleaved(vert, norm, tex, Size_Elem);
+							return;
+						}
+						computeBounds(vert, Size_Elem, 3, bound_box, bound_sphere);
 						vertex.copyData(vert, Size_Elem, 3);
 						normal.copyData(norm, Size_Elem, 3);
 						texcrd.copyData( tex, Size_Elem, 2);
+						bakeLayout();
 					}
 
 				template<typename T>
 					inline void copyData(const T *vert, const T *norm, std::size_t Size_Elem)
 					{
+						if(is_interleaved)
+						{
+							copyInterleaved(vert, norm, static_cast<const T*>(nullptr), Size_Elem);
+							return;
+						}
+						computeBounds(vert, Size_Elem, 3, bound_box, bound_sphere);
 						vertex.copyData(vert, Size_Elem, 3);
 						normal.copyData(norm, Size_Elem, 3);
+						bakeLayout();
 					}
 
 				template<typename T>
 					inline void copyIndex(const T *ind, std::size_t Size_Elem)
 					{
 						index.copyData(ind, Size_Elem);
+						v_array.bindIBO(index);
+						lods.clear();
+						lod = 0;
 					}
 
+				//per-instance attribute stored in the vertex array (e.g. model matrices: Dim 16 at AttribLocation::INSTANCE).
+				//set once, then drawInstanced(mesh, program) draws one instance per element
+				template<typename UsageType, typename vbAlloc>
+					inline void setInstanceBuffer(const VertexBuffer<ArrayBuffer, UsageType, vbAlloc> &buffer, GLuint location = AttribLocation::INSTANCE, GLuint divisor = 1)
+					{
+						if(!buffer.getisSetArray())
+						{
+							std::cerr << "Array is not set! --did nothing" << std::endl;
+							return;
+						}
+						v_array.setInstanceAttrib(location, buffer, divisor);
+						//a buffer replaces the ones it overlaps (a mat4 uses 4 locations)
+						const GLuint slots = static_cast<GLuint>((buffer.getDim()+3)/4);
+						for(auto it = instance_buffers.begin(); it != instance_buffers.end();)
+						{
+							if(it->first < location+slots && location < it->first+it->second.first)
+								it = instance_buffers.erase(it);
+							else
+								++it;
+						}
+						instance_buffers[location] = std::make_pair(slots, static_cast<GLsizei>(buffer.getSizeElem()*divisor));
+					}
+
+				//the fewest instances over the buffers set (0: not set)
+				inline GLsizei getNumInstance() const
+				{
+					GLsizei num_instance = 0;
+					for(auto&& buffer : instance_buffers)
+						num_instance = (num_instance == 0) ? buffer.second.second : std::min(num_instance, buffer.second.second);
+					return num_instance;
+				}
+
+				//all levels of the chain in the index buffer (see buildLodChain). level 0 is drawn until setLod/selectLod
+				inline void copyLodChain(const LodChain &chain)
+				{
+					index.copyData(chain.indices.data(), chain.indices.size());
+					v_array.bindIBO(index);
+					lods = chain.levels;
+					lod = 0;
+				}
+
+				inline std::size_t getNumLod() const
+				{
+					return lods.size();
+				}
+
+				inline const std::vector<LodLevel>& getLodLevels() const
+				{
+					return lods;
+				}
+
+				inline std::size_t getLod() const
+				{
+					return lod;
+				}
+
+				inline void setLod(std::size_t level)
+				{
+					if(level >= lods.size())
+					{
+						std::cerr << "LOD level " << level << " doesn't exist --did nothing" << std::endl;
+						return;
+					}
+					lod = level;
+				}
+
+				//screen_size: Camera::getScreenSize of the world bounding sphere. returns the selected level
+				inline std::size_t selectLod(GLfloat screen_size, GLfloat viewport_height, GLfloat pixel_error = 1.0f)
+				{
+					lod = selectLodLevel(lods, screen_size*viewport_height*0.5f, pixel_error);
+					return lod;
+				}
+
+				//the range of the index buffer to draw (the current LOD level)
+				inline GLint getIndexFirst() const
+				{
+					return lods.empty() ? 0 : lods[lod].first;
+				}
+
+				inline GLsizei getIndexCount() const
+				{
+					return lods.empty() ? index.getSizeElem() : lods[lod].count;
+				}
+
 				inline void setPos(const glm::vec3 &vec)
 				{
-					this->pos = vec;
+					transform.setPos(vec);
 				}
 
-				inline const glm::vec3& getPos()
+				inline const glm::vec3& getPos() const
 				{
-					return this->pos;
+					return transform.getPos();
 				}
 
 				inline void setScale(const glm::vec3 &vec)
 				{
-					this->scale = vec;
+					transform.setScale(vec);
 				}
 
-				inline const glm::vec3& getScale()
+				inline const glm::vec3& getScale() const
 				{
-					return this->scale;
+					return transform.getScale();
 				}
 
 				inline void rotate(const glm::vec3 &axis, GLfloat angle)
 				{
-					this->rot = glm::rotate(this->rot, angle, glm::normalize(axis));
+					transform.rotate(axis, angle);
 				}
 
 				inline void resetRot()
 				{
-					this->rot = glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
+					transform.resetRot();
+				}
+
+				inline const glm::quat& getRot() const
+				{
+					return transform.getRot();
+				}
+
+				inline Transform& getTransform()
+				{
+					return transform;
+				}
+
+				inline const Transform& getTransform() const
+				{
+					return transform;
+				}
+
+				//cached until the position, the rotation or the scale changes
+				inline const glm::mat4& getModelMatrix() const
+				{
+					return transform.getMatrix();
 				}
 
-				inline const glm::quat& getRot()
+				//model space
+				inline const BoundingBox& getBoundingBox() const
 				{
-					return this->rot;
+					return bound_box;
 				}
 
-				inline glm::mat4 getModelMatrix()
+				inline const BoundingSphere& getBoundingSphere() const
 				{
-					glm::mat4 mat = glm::mat4_cast(rot);
-					glm::mat4 poyo = mat*glm::scale(glm::mat4(), scale);
-					return glm::translate(poyo, glm::inverse(glm::mat3(poyo))*pos);
+					return bound_sphere;
+				}
+
+				//world space (by the model matrix)
+				inline BoundingBox getWorldBoundingBox() const
+				{
+					return bound_box.transformed(getModelMatrix());
+				}
+
+				inline BoundingSphere getWorldBoundingSphere() const
+				{
+					return bound_sphere.transformed(getModelMatrix());
+				}
+
+				//false if the mesh is completely outside of the frustum (skip its draw)
+				inline bool isVisible(const Frustum &frustum) const
+				{
+					return frustum.isVisible(getWorldBoundingSphere()) && frustum.isVisible(getWorldBoundingBox());
+				}
+		};
+
+		/**
+		 * MeshPool
+		 * many meshes in one interleaved vertex buffer and one index buffer under one vertex array.
+		 * a mesh is a range of the buffers (base vertex, first index).
+		 * the draw list is submitted by one glMultiDrawElementsIndirect call.
+		 * the model matrix of a draw is the per-instance attribute at AttribLocation::INSTANCE,
+		 * indexed by the draw id through baseInstance.
+		 *
+		 */
+
+		class MeshPool{
+			public:
+				struct MeshRange
+				{
+					GLint baseVertex;
+					GLuint firstIndex;
+					GLuint count;
+				};
+
+			private:
+				std::vector<VertexPNT> vertices;
+				std::vector<GLuint> indices;
+				std::vector<MeshRange> ranges;
+
+				VBO vertex;
+				IBO index;
+				VAO v_array;
+
+				std::vector<DrawElementsIndirectCommand> commands;
+				std::vector<glm::mat4> transforms;
+				VertexBuffer<DrawIndirectBuffer, DynamicDraw> command_buffer;
+				VertexBuffer<ArrayBuffer, DynamicDraw> transform_buffer;
+				//the list of the last submit (the buffers and the fallback of draw use this, not the live list)
+				std::vector<DrawElementsIndirectCommand> submitted;
+
+				bool is_uploaded = false;
+
+			public:
+				//returns the mesh id
+				template<typename T>
+					std::size_t add(const GLfloat *vert, const GLfloat *norm, const GLfloat *tex, std::size_t num_vertex, const T *ind, std::size_t num_index)
+					{
+						static_assert(is_exist<T, GLubyte, GLushort, GLuint>::value, "index type must be GLushort or GLuint or GLubyte");
+						MeshRange range;
+						range.baseVertex = vertices.size();
+						range.firstIndex = indices.size();
+						range.count = num_index;
+						ranges.push_back(range);
+
+						for(std::size_t i = 0; i < num_vertex; i++)
+						{
+							VertexPNT v;
+							std::copy(vert+3*i, vert+3*i+3, v.vertex);
+							std::copy(norm+3*i, norm+3*i+3, v.normal);
+							if(tex != nullptr)
+								std::copy(tex+2*i, tex+2*i+2, v.texcrd);
+							else
+								v.texcrd[0] = v.texcrd[1] = 0.0f;
+							vertices.push_back(v);
+						}
+						indices.insert(indices.end(), ind, ind+num_index);
+						is_uploaded = false;
+						return ranges.size()-1;
+					}
+
+				//copy the added meshes to the GPU (call after add)
+				void upload()
+				{
+					if(vertices.empty() || indices.empty())
+					{
+						std::cerr << "no mesh is added --did nothing" << std::endl;
+						return;
+					}
+					vertex.copyData(reinterpret_cast<const GLfloat*>(vertices.data()), vertices.size(), sizeof(VertexPNT)/sizeof(GLfloat));
+					index.copyData(indices.data(), indices.size());
+					v_array.setAttrib<VertexPNT>(vertex);
+					v_array.bindIBO(index);
+					is_uploaded = true;
+					DEBUG_OUT("mesh pool uploaded. " << ranges.size() << " meshes, " << vertices.size() << " vertices, " << indices.size() << " indices");
+				}
+
+				//replace the pool with the buffers which are already packed (e.g. MeshCache).
+				//the arrays are passed to glBufferData directly and not kept
+				void assign(const VertexPNT *vert, std::size_t num_vertex, const GLuint *ind, std::size_t num_index, const std::vector<MeshRange> &mesh_ranges)
+				{
+					vertices.clear();
+					indices.clear();
+					ranges = mesh_ranges;
+					vertex.copyData(reinterpret_cast<const GLfloat*>(vert), num_vertex, sizeof(VertexPNT)/sizeof(GLfloat));
+					index.copyData(ind, num_index);
+					v_array.setAttrib<VertexPNT>(vertex);
+					v_array.bindIBO(index);
+					is_uploaded = true;
+				}
+
+				inline std::size_t getNumMesh() const
+				{
+					return ranges.size();
+				}
+
+				inline const MeshRange& getRange(std::size_t id) const
+				{
+					return ranges[id];
+				}
+
+				//draw list
+
+				inline void clearDraws()
+				{
+					commands.clear();
+					transforms.clear();
+				}
+
+				void addDraw(std::size_t id, const glm::mat4 &model)
+				{
+					if(ranges.size() <= id)
+					{
+						std::cerr << "invalid mesh id --did nothing" << std::endl;
+						return;
+					}
+					DrawElementsIndirectCommand command;
+					command.count = ranges[id].count;
+					command.instanceCount = 1;
+					command.firstIndex = ranges[id].firstIndex;
+					command.baseVertex = ranges[id].baseVertex;
+					command.baseInstance = transforms.size();
+					commands.push_back(command);
+					transforms.push_back(model);
+				}
+
+				inline std::size_t getNumDraw() const
+				{
+					return commands.size();
+				}
+
+				//upload the draw list (call once after the draws are added). an empty list draws nothing
+				void submit()
+				{
+					if(!is_uploaded)
+						upload();
+					submitted = commands;
+					if(commands.empty())
+						return;
+					command_buffer.copyData(reinterpret_cast<const GLuint*>(commands.data()), commands.size(), sizeof(DrawElementsIndirectCommand)/sizeof(GLuint));
+					transform_buffer.copyData(glm::value_ptr(transforms[0]), transforms.size(), 16);
+					v_array.setInstanceAttrib(AttribLocation::INSTANCE, transform_buffer);
+				}
+
+				inline const VAO& getVArray() const
+				{
+					return v_array;
+				}
+
+				inline const IBO& getIndex() const
+				{
+					return index;
+				}
+
+				inline const VertexBuffer<DrawIndirectBuffer, DynamicDraw>& getCommandBuffer() const
+				{
+					return command_buffer;
+				}
+
+				inline const std::vector<DrawElementsIndirectCommand>& getCommands() const
+				{
+					return commands;
+				}
+
+				//the number of the draws in the buffers (0 before submit or after an empty submit)
+				inline std::size_t getNumSubmitted() const
+				{
+					return submitted.size();
+				}
+
+				inline const std::vector<DrawElementsIndirectCommand>& getSubmittedCommands() const
+				{
+					return submitted;
 				}
 		};
 
@@ -229,8 +702,152 @@ namespace jikoLib{
 				{
 					return glm::perspective(fovy, aspect, _near, _far);
 				}
+
+				inline Frustum getFrustum()
+				{
+					return Frustum(getProjectionMatrix()*getViewMatrix());
+				}
+
+				//projected diameter of the sphere relative to the viewport height (1: as high as the viewport).
+				//infinity if the camera is inside the sphere
+				inline GLfloat getScreenSize(const BoundingSphere &sphere) const
+				{
+					const GLfloat distance = glm::length(sphere.center-pos);
+					if(distance <= sphere.radius)
+						return std::numeric_limits<GLfloat>::infinity();
+					return sphere.radius/(distance*std::tan(fovy*0.5f));
+				}
 		};
 
+		/**
+		 * MeshData
+		 * CPU side copy of a mesh (interleaved vertices, indices and bounds).
+		 * made on the worker threads and uploaded to Mesh3D on the context thread.
+		 *
+		 */
+
+		struct MeshData
+		{
+			std::string name;
+			std::vector<VertexPNT> vertices;
+			std::vector<GLuint> indices;
+			glm::vec3 bound_min;
+			glm::vec3 bound_max;
+			unsigned int material = 0;
+		};
+
+		//area weighted normals, shared by the vertices at the same position (like aiProcess_GenSmoothNormals)
+		inline void computeSmoothNormals(std::vector<VertexPNT> &vertices, const std::vector<GLuint> &indices)
+		{
+			std::vector<glm::vec3> face_sum(vertices.size(), glm::vec3(0.0f));
+			for(std::size_t i = 0; i+2 < indices.size(); i += 3)
+			{
+				const GLfloat *p0 = vertices[indices[i]].vertex;
+				const GLfloat *p1 = vertices[indices[i+1]].vertex;
+				const GLfloat *p2 = vertices[indices[i+2]].vertex;
+				glm::vec3 n = glm::cross(
+						glm::vec3(p1[0]-p0[0], p1[1]-p0[1], p1[2]-p0[2]),
+						glm::vec3(p2[0]-p0[0], p2[1]-p0[1], p2[2]-p0[2]));
+				for(std::size_t k = 0; k < 3; k++)
+				{
+					face_sum[indices[i+k]] += n;
+				}
+			}
+
+			//group the vertices by position
+			std::vector<GLuint> order(vertices.size());
+			for(std::size_t i = 0; i < order.size(); i++)
+			{
+				order[i] = i;
+			}
+			auto less = [&vertices](GLuint a, GLuint b)
+			{
+				return std::lexicographical_compare(vertices[a].vertex, vertices[a].vertex+3, vertices[b].vertex, vertices[b].vertex+3);
+			};
+			std::sort(order.begin(), order.end(), less);
+
+			for(std::size_t begin = 0; begin < order.size();)
+			{
+				std::size_t end = begin+1;
+				while(end < order.size() && !less(order[begin], order[end]))
+				{
+					end++;
+				}
+				glm::vec3 sum(0.0f);
+				for(std::size_t i = begin; i < end; i++)
+				{
+					sum += face_sum[order[i]];
+				}
+				GLfloat length = glm::length(sum);
+				glm::vec3 n = (length > 0.0f) ? sum/length : glm::vec3(0.0f, 0.0f, 1.0f);
+				for(std::size_t i = begin; i < end; i++)
+				{
+					std::copy(&n[0], &n[0]+3, vertices[order[i]].normal);
+				}
+				begin = end;
+			}
+		}
+
+		//GL upload of the converted meshes (call on the context thread)
+		inline std::vector<Mesh3D> uploadMeshData(const std::vector<MeshData> &data)
+		{
+			std::vector<Mesh3D> meshes(data.size());
+			for(std::size_t i = 0; i < data.size(); i++)
+			{
+				if(data[i].vertices.empty() || data[i].indices.empty())
+					continue;
+				meshes[i].copyData(data[i].vertices.data(), data[i].vertices.size());
+				meshes[i].copyIndex(data[i].indices.data(), data[i].indices.size());
+			}
+			return meshes;
+		}
+
+		inline LodChain buildLodChain(const MeshData &data, std::size_t max_levels = LodChain::MAX_LEVELS, float ratio = 0.5f)
+		{
+			if(data.vertices.empty())
+				return buildLodChain(nullptr, 0, 0, data.indices.data(), data.indices.size(), max_levels, ratio);
+			return buildLodChain(data.vertices[0].vertex, data.vertices.size(), sizeof(VertexPNT)/sizeof(GLfloat), data.indices.data(), data.indices.size(), max_levels, ratio);
+		}
+
+		//LOD chains of the meshes on the pool (no GL call). the result is in the order of data
+		inline std::vector<LodChain> buildLodChains(const std::vector<MeshData> &data, ThreadPool &pool = ThreadPool::getDefault(),
+				std::size_t max_levels = LodChain::MAX_LEVELS, float ratio = 0.5f)
+		{
+			std::vector<LodChain> chains(data.size());
+			//large meshes first for the balance
+			std::vector<std::size_t> order(data.size());
+			for(std::size_t i = 0; i < order.size(); i++)
+			{
+				order[i] = i;
+			}
+			std::sort(order.begin(), order.end(), [&data](std::size_t a, std::size_t b)
+					{
+					return data[a].indices.size() > data[b].indices.size();
+					});
+			pool.parallelFor(order.size(), [&](std::size_t i)
+					{
+					chains[order[i]] = buildLodChain(data[order[i]], max_levels, ratio);
+					});
+			return chains;
+		}
+
+		//GL upload with the LOD chains of buildLodChains (call on the context thread)
+		inline std::vector<Mesh3D> uploadMeshData(const std::vector<MeshData> &data, const std::vector<LodChain> &chains)
+		{
+			std::vector<Mesh3D> meshes(data.size());
+			for(std::size_t i = 0; i < data.size(); i++)
+			{
+				if(data[i].vertices.empty() || data[i].indices.empty())
+					continue;
+				meshes[i].copyData(data[i].vertices.data(), data[i].vertices.size());
+				if(i < chains.size() && !chains[i].levels.empty())
+					meshes[i].copyLodChain(chains[i]);
+				else
+					meshes[i].copyIndex(data[i].indices.data(), data[i].indices.size());
+			}
+			return meshes;
+		}
+
 		class AssimpLoader{
 			private:
 				AssimpLoader(const AssimpLoader&) = delete;
@@ -243,7 +860,14 @@ namespace jikoLib{
 
 			public:
 
-				AssimpLoader(const std::string &path) :scene(importer.ReadFile(path, aiProcess_Triangulate | aiProcess_GenSmoothNormals | aiProcess_FlipUVs))
+				//the flags for convert(): the normals are computed on the worker threads
+				constexpr static unsigned int CONVERT_FLAGS = aiProcess_Triangulate | aiProcess_FlipUVs;
+
+				AssimpLoader(const std::string &path) :AssimpLoader(path, aiProcess_Triangulate | aiProcess_GenSmoothNormals | aiProcess_FlipUVs)
+			{
+			};
+
+				AssimpLoader(const std::string &path, unsigned int flags) :scene(importer.ReadFile(path, flags))
 			{
 				if(scene == nullptr)
 				{
@@ -255,6 +879,95 @@ namespace jikoLib{
 				{
 					return this->scene; 
 				}
+
+				//flatten a mesh into MeshData (no GL call. safe on any thread)
+				static MeshData convertMesh(const aiMesh *mesh)
+				{
+					MeshData data;
+					data.name = mesh->mName.C_Str();
+					data.material = mesh->mMaterialIndex;
+					data.vertices.resize(mesh->mNumVertices);
+					data.bound_min = glm::vec3(0.0f);
+					data.bound_max = glm::vec3(0.0f);
+
+					for(unsigned int i = 0; i < mesh->mNumVertices; i++)
+					{
+						VertexPNT &v = data.vertices[i];
+						const aiVector3D &p = mesh->mVertices[i];
+						v.vertex[0] = p.x;
+						v.vertex[1] = p.y;
+						v.vertex[2] = p.z;
+						if(mesh->HasNormals())
+						{
+							v.normal[0] = mesh->mNormals[i].x;
+							v.normal[1] = mesh->mNormals[i].y;
+							v.normal[2] = mesh->mNormals[i].z;
+						}
+						if(mesh->HasTextureCoords(0))
+						{
+							v.texcrd[0] = mesh->mTextureCoords[0][i].x;
+							v.texcrd[1] = mesh->mTextureCoords[0][i].y;
+						}
+						else
+						{
+							v.texcrd[0] = v.texcrd[1] = 0.0f;
+						}
+
+						glm::vec3 pos(p.x, p.y, p.z);
+						data.bound_min = (i == 0) ? pos : glm::min(data.bound_min, pos);
+						data.bound_max = (i == 0) ? pos : glm::max(data.bound_max, pos);
+					}
+
+					//points and lines are dropped
+					data.indices.reserve(mesh->mNumFaces*3);
+					for(unsigned int f = 0; f < mesh->mNumFaces; f++)
+					{
+						const aiFace &face = mesh->mFaces[f];
+						if(face.mNumIndices != 3)
+							continue;
+						data.indices.insert(data.indices.end(), {face.mIndices[0], face.mIndices[1], face.mIndices[2]});
+					}
+
+					if(!mesh->HasNormals())
+						computeSmoothNormals(data.vertices, data.indices);
+
+					return data;
+				}
+
+				//convert all meshes of the scene on the pool. the result is in the order of scene->mMeshes
+				std::vector<MeshData> convert(ThreadPool &pool = ThreadPool::getDefault()) const
+				{
+					std::vector<MeshData> result;
+					if(scene == nullptr)
+					{
+						std::cerr << "scene is not loaded --did nothing" << std::endl;
+						return result;
+					}
+					result.resize(scene->mNumMeshes);
+
+					//large meshes first for the balance
+					std::vector<unsigned int> order(scene->mNumMeshes);
+					for(unsigned int i = 0; i < scene->mNumMeshes; i++)
+					{
+						order[i] = i;
+					}
+					std::sort(order.begin(), order.end(), [this](unsigned int a, unsigned int b)
+							{
+							return scene->mMeshes[a]->mNumVertices > scene->mMeshes[b]->mNumVertices;
+							});
+
+					pool.parallelFor(order.size(), [&](std::size_t i)
+							{
+							result[order[i]] = convertMesh(scene->mMeshes[order[i]]);
+							});
+					return result;
+				}
+
+				//GL upload (call on the context thread)
+				inline static std::vector<Mesh3D> upload(const std::vector<MeshData> &data)
+				{
+					return uploadMeshData(data);
+				}
 		};
 
 		namespace MeshSample{
@@ -264,7 +977,22 @@ namespace jikoLib{
 					std::vector<GLfloat> vertex;
 					std::vector<GLfloat> normal;
 					std::vector<GLfloat> texcrd;
-					std::vector<GLushort> index;
+					std::vector<GLuint> index;
+
+					//4 corners (counterclockwise) of the face. texcrd is (0,0),(1,0),(1,1),(0,1)
+					void addQuad(const GLfloat (&corner)[4][3], const GLfloat (&norm)[3], GLfloat scale)
+					{
+						const GLfloat quad_texcrd[4][2] = {{0.0f, 0.0f}, {1.0f, 0.0f}, {1.0f, 1.0f}, {0.0f, 1.0f}};
+						GLuint base = getNumVertex();
+						for(int i = 0; i < 4; i++)
+						{
+							vertex.insert(vertex.end(), {scale*corner[i][0], scale*corner[i][1], scale*corner[i][2]});
+							normal.insert(normal.end(), {norm[0], norm[1], norm[2]});
+							texcrd.insert(texcrd.end(), {quad_texcrd[i][0], quad_texcrd[i][1]});
+						}
+						index.insert(index.end(), {base, base+1, base+2, base+2, base+3, base});
+					}
+
 				public:
 					inline const GLfloat* getVertex()
 					{
@@ -281,7 +1009,7 @@ namespace jikoLib{
 						return texcrd.data();
 					}
 
-					inline const GLushort* getIndex()
+					inline const GLuint* getIndex()
 					{
 						return index.data();
 					}
@@ -307,559 +1035,163 @@ namespace jikoLib{
 					}
 			};
 
+			//24 vertices and 36 indices
 			class Cube : public AbstractShape{
 				private:
 
 				public:
 					Cube(GLfloat side)
 					{
-						vertex.reserve(108);
-						normal.reserve(108);
-						texcrd.reserve(72);
-
-						//forward
-						vertex.push_back(-side/2);
-						vertex.push_back(-side/2);
-						vertex.push_back( side/2);
-
-						vertex.push_back( side/2);
-						vertex.push_back(-side/2);
-						vertex.push_back( side/2);
-
-						vertex.push_back( side/2);
-						vertex.push_back( side/2);
-						vertex.push_back( side/2);
-
-						vertex.push_back( side/2);
-						vertex.push_back( side/2);
-						vertex.push_back( side/2);
-
-						vertex.push_back(-side/2);
-						vertex.push_back( side/2);
-						vertex.push_back( side/2);
-
-						vertex.push_back(-side/2);
-						vertex.push_back(-side/2);
-						vertex.push_back( side/2);
-
-						//back
-						vertex.push_back( side/2);
-						vertex.push_back(-side/2);
-						vertex.push_back(-side/2);
-
-						vertex.push_back(-side/2);
-						vertex.push_back(-side/2);
-						vertex.push_back(-side/2);
-
-						vertex.push_back(-side/2);
-						vertex.push_back( side/2);
-						vertex.push_back(-side/2);
-
-						vertex.push_back(-side/2);
-						vertex.push_back( side/2);
-						vertex.push_back(-side/2);
-
-						vertex.push_back( side/2);
-						vertex.push_back( side/2);
-						vertex.push_back(-side/2);
-
-						vertex.push_back( side/2);
-						vertex.push_back(-side/2);
-						vertex.push_back(-side/2);
-
-						//right
-						vertex.push_back( side/2);
-						vertex.push_back(-side/2);
-						vertex.push_back( side/2);
-
-						vertex.push_back( side/2);
-						vertex.push_back(-side/2);
-						vertex.push_back(-side/2);
-
-						vertex.push_back( side/2);
-						vertex.push_back( side/2);
-						vertex.push_back(-side/2);
-
-						vertex.push_back( side/2);
-						vertex.push_back( side/2);
-						vertex.push_back(-side/2);
-
-						vertex.push_back( side/2);
-						vertex.push_back( side/2);
-						vertex.push_back( side/2);
-
-						vertex.push_back( side/2);
-						vertex.push_back(-side/2);
-						vertex.push_back( side/2);
-
-						//left
-						vertex.push_back(-side/2);
-						vertex.push_back(-side/2);
-						vertex.push_back(-side/2);
-
-						vertex.push_back(-side/2);
-						vertex.push_back(-side/2);
-						vertex.push_back( side/2);
-
-						vertex.push_back(-side/2);
-						vertex.push_back( side/2);
-						vertex.push_back( side/2);
-
-						vertex.push_back(-side/2);
-						vertex.push_back( side/2);
-						vertex.push_back( side/2);
-
-						vertex.push_back(-side/2);
-						vertex.push_back( side/2);
-						vertex.push_back(-side/2);
-
-						vertex.push_back(-side/2);
-						vertex.push_back(-side/2);
-						vertex.push_back(-side/2);
-
-						//up
-						vertex.push_back(-side/2);
-						vertex.push_back( side/2);
-						vertex.push_back( side/2);
-
-						vertex.push_back( side/2);
-						vertex.push_back( side/2);
-						vertex.push_back( side/2);
-
-						vertex.push_back( side/2);
-						vertex.push_back( side/2);
-						vertex.push_back(-side/2);
-
-						vertex.push_back( side/2);
-						vertex.push_back( side/2);
-						vertex.push_back(-side/2);
-
-						vertex.push_back(-side/2);
-						vertex.push_back( side/2);
-						vertex.push_back(-side/2);
-
-						vertex.push_back(-side/2);
-						vertex.push_back( side/2);
-						vertex.push_back( side/2);
-
-						//down
-						vertex.push_back( side/2);
-						vertex.push_back(-side/2);
-						vertex.push_back( side/2);
-
-						vertex.push_back(-side/2);
-						vertex.push_back(-side/2);
-						vertex.push_back( side/2);
-
-						vertex.push_back(-side/2);
-						vertex.push_back(-side/2);
-						vertex.push_back(-side/2);
-
-						vertex.push_back(-side/2);
-						vertex.push_back(-side/2);
-						vertex.push_back(-side/2);
-
-						vertex.push_back( side/2);
-						vertex.push_back(-side/2);
-						vertex.push_back(-side/2);
-
-						vertex.push_back( side/2);
-						vertex.push_back(-side/2);
-						vertex.push_back( side/2);
-
-						for(int i = 0; i < 6; i++)
+						const GLfloat corner[6][4][3] =
 						{
-							normal.push_back(0.0f);
-							normal.push_back(0.0f);
-							normal.push_back(1.0f);
-						}
-
-						for(int i = 0; i < 6; i++)
+							//forward
+							{{-1,-1, 1}, { 1,-1, 1}, { 1, 1, 1}, {-1, 1, 1}},
+							//back
+							{{ 1,-1,-1}, {-1,-1,-1}, {-1, 1,-1}, { 1, 1,-1}},
+							//right
+							{{ 1,-1, 1}, { 1,-1,-1}, { 1, 1,-1}, { 1, 1, 1}},
+							//left
+							{{-1,-1,-1}, {-1,-1, 1}, {-1, 1, 1}, {-1, 1,-1}},
+							//up
+							{{-1, 1, 1}, { 1, 1, 1}, { 1, 1,-1}, {-1, 1,-1}},
+							//down
+							{{ 1,-1, 1}, {-1,-1, 1}, {-1,-1,-1}, { 1,-1,-1}}
+						};
+						const GLfloat norm[6][3] =
 						{
-							normal.push_back(0.0f);
-							normal.push_back(0.0f);
-							normal.push_back(-1.0f);
-						}
+							{ 0, 0, 1}, { 0, 0,-1}, { 1, 0, 0}, {-1, 0, 0}, { 0, 1, 0}, { 0,-1, 0}
+						};
 
-						for(int i = 0; i < 6; i++)
-						{
-							normal.push_back(1.0f);
-							normal.push_back(0.0f);
-							normal.push_back(0.0f);
-						}
+						vertex.reserve(72);
+						normal.reserve(72);
+						texcrd.reserve(48);
+						index.reserve(36);
 
 						for(int i = 0; i < 6; i++)
 						{
-							normal.push_back(-1.0f);
-							normal.push_back(0.0f);
-							normal.push_back(0.0f);
-						}
-
-						for(int i = 0; i < 6; i++)
-						{
-							normal.push_back(0.0f);
-							normal.push_back(1.0f);
-							normal.push_back(0.0f);
-						}
-
-						for(int i = 0; i < 6; i++)
-						{
-							normal.push_back(0.0f);
-							normal.push_back(-1.0f);
-							normal.push_back(0.0f);
-						}
-
-						for(int i = 0; i < 6; i++)
-						{
-							texcrd.push_back(0.0f);
-							texcrd.push_back(0.0f);
-							texcrd.push_back(1.0f);
-							texcrd.push_back(0.0f);
-							texcrd.push_back(1.0f);
-							texcrd.push_back(1.0f);
-							texcrd.push_back(1.0f);
-							texcrd.push_back(1.0f);
-							texcrd.push_back(0.0f);
-							texcrd.push_back(1.0f);
-							texcrd.push_back(0.0f);
-							texcrd.push_back(0.0f);
+							addQuad(corner[i], norm[i], side/2);
 						}
 					}
 
 			};
 
+			//inside-out cube for the sky map. 24 vertices and 36 indices
 			class CubeMap : public AbstractShape{
 				private:
 
 				public:
 					CubeMap(GLfloat side)
 					{
-						vertex.reserve(108);
-						normal.reserve(108);
-						texcrd.reserve(72);
-
-						//forward
-						vertex.push_back( side/2);
-						vertex.push_back( side/2);
-						vertex.push_back( side/2);
-
-						vertex.push_back( side/2);
-						vertex.push_back(-side/2);
-						vertex.push_back( side/2);
-
-						vertex.push_back(-side/2);
-						vertex.push_back(-side/2);
-						vertex.push_back( side/2);
-
-						vertex.push_back(-side/2);
-						vertex.push_back(-side/2);
-						vertex.push_back( side/2);
-
-						vertex.push_back(-side/2);
-						vertex.push_back( side/2);
-						vertex.push_back( side/2);
-
-						vertex.push_back( side/2);
-						vertex.push_back( side/2);
-						vertex.push_back( side/2);
-
-						//back
-						vertex.push_back(-side/2);
-						vertex.push_back( side/2);
-						vertex.push_back(-side/2);
-
-						vertex.push_back(-side/2);
-						vertex.push_back(-side/2);
-						vertex.push_back(-side/2);
-
-						vertex.push_back( side/2);
-						vertex.push_back(-side/2);
-						vertex.push_back(-side/2);
-
-						vertex.push_back( side/2);
-						vertex.push_back(-side/2);
-						vertex.push_back(-side/2);
-
-						vertex.push_back( side/2);
-						vertex.push_back( side/2);
-						vertex.push_back(-side/2);
-
-						vertex.push_back(-side/2);
-						vertex.push_back( side/2);
-						vertex.push_back(-side/2);
-
-						//right
-						vertex.push_back( side/2);
-						vertex.push_back( side/2);
-						vertex.push_back(-side/2);
-
-						vertex.push_back( side/2);
-						vertex.push_back(-side/2);
-						vertex.push_back(-side/2);
-
-						vertex.push_back( side/2);
-						vertex.push_back(-side/2);
-						vertex.push_back( side/2);
-
-						vertex.push_back( side/2);
-						vertex.push_back(-side/2);
-						vertex.push_back( side/2);
-
-						vertex.push_back( side/2);
-						vertex.push_back( side/2);
-						vertex.push_back( side/2);
-
-						vertex.push_back( side/2);
-						vertex.push_back( side/2);
-						vertex.push_back(-side/2);
-
-						//left
-						vertex.push_back(-side/2);
-						vertex.push_back( side/2);
-						vertex.push_back( side/2);
-
-						vertex.push_back(-side/2);
-						vertex.push_back(-side/2);
-						vertex.push_back( side/2);
-
-						vertex.push_back(-side/2);
-						vertex.push_back(-side/2);
-						vertex.push_back(-side/2);
-
-						vertex.push_back(-side/2);
-						vertex.push_back(-side/2);
-						vertex.push_back(-side/2);
-
-						vertex.push_back(-side/2);
-						vertex.push_back( side/2);
-						vertex.push_back(-side/2);
-
-						vertex.push_back(-side/2);
-						vertex.push_back( side/2);
-						vertex.push_back( side/2);
-
-						//up
-						vertex.push_back( side/2);
-						vertex.push_back( side/2);
-						vertex.push_back(-side/2);
-
-						vertex.push_back( side/2);
-						vertex.push_back( side/2);
-						vertex.push_back( side/2);
-
-						vertex.push_back(-side/2);
-						vertex.push_back( side/2);
-						vertex.push_back( side/2);
-
-						vertex.push_back(-side/2);
-						vertex.push_back( side/2);
-						vertex.push_back( side/2);
-
-						vertex.push_back(-side/2);
-						vertex.push_back( side/2);
-						vertex.push_back(-side/2);
-
-						vertex.push_back( side/2);
-						vertex.push_back( side/2);
-						vertex.push_back(-side/2);
-
-						//down
-						vertex.push_back(-side/2);
-						vertex.push_back(-side/2);
-						vertex.push_back(-side/2);
-
-						vertex.push_back(-side/2);
-						vertex.push_back(-side/2);
-						vertex.push_back( side/2);
-
-						vertex.push_back( side/2);
-						vertex.push_back(-side/2);
-						vertex.push_back( side/2);
-
-						vertex.push_back( side/2);
-						vertex.push_back(-side/2);
-						vertex.push_back( side/2);
-
-						vertex.push_back( side/2);
-						vertex.push_back(-side/2);
-						vertex.push_back(-side/2);
-
-						vertex.push_back(-side/2);
-						vertex.push_back(-side/2);
-						vertex.push_back(-side/2);
-
-						for(int i = 0; i < 6; i++)
-						{
-							normal.push_back(0.0f);
-							normal.push_back(0.0f);
-							normal.push_back(-1.0f);
-						}
-
-						for(int i = 0; i < 6; i++)
+						const GLfloat corner[6][4][3] =
 						{
-							normal.push_back(0.0f);
-							normal.push_back(0.0f);
-							normal.push_back( 1.0f);
-						}
-
-						for(int i = 0; i < 6; i++)
+							//forward
+							{{ 1, 1, 1}, { 1,-1, 1}, {-1,-1, 1}, {-1, 1, 1}},
+							//back
+							{{-1, 1,-1}, {-1,-1,-1}, { 1,-1,-1}, { 1, 1,-1}},
+							//right
+							{{ 1, 1,-1}, { 1,-1,-1}, { 1,-1, 1}, { 1, 1, 1}},
+							//left
+							{{-1, 1, 1}, {-1,-1, 1}, {-1,-1,-1}, {-1, 1,-1}},
+							//up
+							{{ 1, 1,-1}, { 1, 1, 1}, {-1, 1, 1}, {-1, 1,-1}},
+							//down
+							{{-1,-1,-1}, {-1,-1, 1}, { 1,-1, 1}, { 1,-1,-1}}
+						};
+						const GLfloat norm[6][3] =
 						{
-							normal.push_back(-1.0f);
-							normal.push_back(0.0f);
-							normal.push_back(0.0f);
-						}
+							{ 0, 0,-1}, { 0, 0, 1}, {-1, 0, 0}, { 1, 0, 0}, { 0,-1, 0}, { 0, 1, 0}
+						};
 
-						for(int i = 0; i < 6; i++)
-						{
-							normal.push_back( 1.0f);
-							normal.push_back(0.0f);
-							normal.push_back(0.0f);
-						}
-
-						for(int i = 0; i < 6; i++)
-						{
-							normal.push_back(0.0f);
-							normal.push_back(-1.0f);
-							normal.push_back(0.0f);
-						}
-
-						for(int i = 0; i < 6; i++)
-						{
-							normal.push_back(0.0f);
-							normal.push_back( 1.0f);
-							normal.push_back(0.0f);
-						}
+						vertex.reserve(72);
+						normal.reserve(72);
+						texcrd.reserve(48);
+						index.reserve(36);
 
 						for(int i = 0; i < 6; i++)
 						{
-							texcrd.push_back(0.0f);
-							texcrd.push_back(0.0f);
-							texcrd.push_back(1.0f);
-							texcrd.push_back(0.0f);
-							texcrd.push_back(1.0f);
-							texcrd.push_back(1.0f);
-							texcrd.push_back(1.0f);
-							texcrd.push_back(1.0f);
-							texcrd.push_back(0.0f);
-							texcrd.push_back(1.0f);
-							texcrd.push_back(0.0f);
-							texcrd.push_back(0.0f);
+							addQuad(corner[i], norm[i], side/2);
 						}
 					}
 
 			};
 
+			//(SLICES+1)*(STACKS+1) vertices. the seam and the poles are duplicated for texcrd.
 			class Sphere : public AbstractShape
 			{
 				private:
+					inline static GLuint ringIndex(int SLICES, int stack, int slice)
+					{
+						return stack*(SLICES+1) + slice;
+					}
+
 				public:
 					Sphere(GLfloat radius, int SLICES, int STACKS)
 					{
-						vertex.reserve(SLICES*(STACKS-1)*18);
-						normal.reserve(SLICES*(STACKS-1)*18);
-						texcrd.reserve(SLICES*(STACKS-1)*12);
-
-						for(int i = 0; i < SLICES; i++)
+						//trig tables
+						std::vector<GLfloat> slice_cos(SLICES+1), slice_sin(SLICES+1);
+						std::vector<GLfloat> stack_cos(STACKS+1), stack_sin(STACKS+1);
+						for(int i = 0; i <= SLICES; i++)
 						{
-							vertex.push_back(0);
-							vertex.push_back(0);
-							vertex.push_back(radius);
-
-							texcrd.push_back((GLfloat)i/SLICES);
-							texcrd.push_back(1.0f);
-
-							vertex.push_back(radius*sin(M_PI*(GLfloat)(1)/STACKS)*cos(2*M_PI*(GLfloat)(i)/SLICES));
-							vertex.push_back(radius*sin(M_PI*(GLfloat)(1)/STACKS)*sin(2*M_PI*(GLfloat)(i)/SLICES));
-							vertex.push_back(radius*cos(M_PI*(GLfloat)(1)/STACKS));
-
-							texcrd.push_back((GLfloat)i/SLICES);
-							texcrd.push_back(1.0f - 1.0f/STACKS);
-
-							vertex.push_back(radius*sin(M_PI*(GLfloat)(1)/STACKS)*cos(2*M_PI*(GLfloat)(i+1)/SLICES));
-							vertex.push_back(radius*sin(M_PI*(GLfloat)(1)/STACKS)*sin(2*M_PI*(GLfloat)(i+1)/SLICES));
-							vertex.push_back(radius*cos(M_PI*(GLfloat)(1)/STACKS));
-
-							texcrd.push_back((GLfloat)i/SLICES);
-							texcrd.push_back(1.0f - 1.0f/STACKS);
+							slice_cos[i] = cos(2*M_PI*(GLfloat)(i)/SLICES);
+							slice_sin[i] = sin(2*M_PI*(GLfloat)(i)/SLICES);
 						}
-
-						for(int i=0; i<SLICES; i++)
+						for(int j = 0; j <= STACKS; j++)
 						{
-							for(int j=1; j<STACKS-1; j++)
-							{
-								vertex.push_back(radius*sin(M_PI * (GLfloat)(j) / STACKS)*cos(2 * M_PI*(GLfloat)(i + 1) / SLICES));
-								vertex.push_back(radius*sin(M_PI * (GLfloat)(j) / STACKS)*sin(2 * M_PI*(GLfloat)(i + 1) / SLICES));
-								vertex.push_back(radius*cos(M_PI * (GLfloat)(j) / STACKS));
-
-								texcrd.push_back((GLfloat)(i+1)/SLICES);
-								texcrd.push_back(1.0f - (GLfloat)(j) / STACKS);
-
-								vertex.push_back(radius*sin(M_PI * (GLfloat)(j) / STACKS)*cos(2 * M_PI*(GLfloat)(i) / SLICES));
-								vertex.push_back(radius*sin(M_PI * (GLfloat)(j) / STACKS)*sin(2 * M_PI*(GLfloat)(i) / SLICES));
-								vertex.push_back(radius*cos(M_PI * (GLfloat)(j) / STACKS));
-
-								texcrd.push_back((GLfloat)(i)/SLICES);
-								texcrd.push_back(1.0f - (GLfloat)(j) / STACKS);
-
-								vertex.push_back(radius*sin(M_PI * (GLfloat)(j + 1) / STACKS)*cos(2 * M_PI*(GLfloat)(i) / SLICES));
-								vertex.push_back(radius*sin(M_PI * (GLfloat)(j + 1) / STACKS)*sin(2 * M_PI*(GLfloat)(i) / SLICES));
-								vertex.push_back(radius*cos(M_PI * (GLfloat)(j + 1) / STACKS));
-
-								texcrd.push_back((GLfloat)(i)/SLICES);
-								texcrd.push_back(1.0f - (GLfloat)(j+1) / STACKS);
-
-								vertex.push_back(radius*sin(M_PI * (GLfloat)(j) / STACKS)*cos(2 * M_PI*(GLfloat)(i + 1) / SLICES));
-								vertex.push_back(radius*sin(M_PI * (GLfloat)(j) / STACKS)*sin(2 * M_PI*(GLfloat)(i + 1) / SLICES));
-								vertex.push_back(radius*cos(M_PI * (GLfloat)(j) / STACKS));
-
-								texcrd.push_back((GLfloat)(i+1)/SLICES);
-								texcrd.push_back(1.0f - (GLfloat)(j) / STACKS);
-
-								vertex.push_back(radius*sin(M_PI * (GLfloat)(j + 1) / STACKS)*cos(2 * M_PI*(GLfloat)(i) / SLICES));
-								vertex.push_back(radius*sin(M_PI * (GLfloat)(j + 1) / STACKS)*sin(2 * M_PI*(GLfloat)(i) / SLICES));
-								vertex.push_back(radius*cos(M_PI * (GLfloat)(j + 1) / STACKS));
-
-								texcrd.push_back((GLfloat)(i)/SLICES);
-								texcrd.push_back(1.0f - (GLfloat)(j+1) / STACKS);
+							stack_cos[j] = cos(M_PI*(GLfloat)(j)/STACKS);
+							stack_sin[j] = sin(M_PI*(GLfloat)(j)/STACKS);
+						}
 
-								vertex.push_back(radius*sin(M_PI * (GLfloat)(j + 1) / STACKS)*cos(2 * M_PI*(GLfloat)(i + 1) / SLICES));
-								vertex.push_back(radius*sin(M_PI * (GLfloat)(j + 1) / STACKS)*sin(2 * M_PI*(GLfloat)(i + 1) / SLICES));
-								vertex.push_back(radius*cos(M_PI * (GLfloat)(j + 1) / STACKS));
+						vertex.reserve((SLICES+1)*(STACKS+1)*3);
+						normal.reserve((SLICES+1)*(STACKS+1)*3);
+						texcrd.reserve((SLICES+1)*(STACKS+1)*2);
+						index.reserve(SLICES*(STACKS-1)*6);
 
-								texcrd.push_back((GLfloat)(i+1)/SLICES);
-								texcrd.push_back(1.0f - (GLfloat)(j+1) / STACKS);
+						for(int j = 0; j <= STACKS; j++)
+						{
+							for(int i = 0; i <= SLICES; i++)
+							{
+								//unit normal
+								GLfloat nx = stack_sin[j]*slice_cos[i];
+								GLfloat ny = stack_sin[j]*slice_sin[i];
+								GLfloat nz = stack_cos[j];
+
+								vertex.insert(vertex.end(), {radius*nx, radius*ny, radius*nz});
+								normal.insert(normal.end(), {nx, ny, nz});
+								texcrd.insert(texcrd.end(), {(GLfloat)(i)/SLICES, 1.0f - (GLfloat)(j)/STACKS});
 							}
 						}
 
-						for (int i = 0; i < SLICES; i++)
+						//top
+						for(int i = 0; i < SLICES; i++)
 						{
-							vertex.push_back(radius*sin(M_PI * (GLfloat)(STACKS - 1) / STACKS)*cos(2 * M_PI*(GLfloat)(i + 1) / SLICES));
-							vertex.push_back(radius*sin(M_PI * (GLfloat)(STACKS - 1) / STACKS)*sin(2 * M_PI*(GLfloat)(i + 1) / SLICES));
-							vertex.push_back(radius*cos(M_PI * (GLfloat)(STACKS - 1) / STACKS));
-
-							texcrd.push_back((GLfloat)(i+1)/SLICES);
-							texcrd.push_back(1.0f / STACKS);
-
-							vertex.push_back(radius*sin(M_PI * (GLfloat)(STACKS - 1) / STACKS)*cos(2 * M_PI*(GLfloat)(i) / SLICES));
-							vertex.push_back(radius*sin(M_PI * (GLfloat)(STACKS - 1) / STACKS)*sin(2 * M_PI*(GLfloat)(i) / SLICES));
-							vertex.push_back(radius*cos(M_PI * (GLfloat)(STACKS - 1) / STACKS));
-
-							texcrd.push_back((GLfloat)(i)/SLICES);
-							texcrd.push_back(1.0f / STACKS);
-
-							vertex.push_back(0);
-							vertex.push_back(0);
-							vertex.push_back(-radius);
-
-							texcrd.push_back((GLfloat)(i)/SLICES);
-							texcrd.push_back(0.0f);
+							index.insert(index.end(), {
+									ringIndex(SLICES, 0, i),
+									ringIndex(SLICES, 1, i),
+									ringIndex(SLICES, 1, i+1)});
 						}
 
-						for(auto && v : vertex)
+						for(int i = 0; i < SLICES; i++)
 						{
-							normal.push_back(v/radius);
+							for(int j = 1; j < STACKS-1; j++)
+							{
+								index.insert(index.end(), {
+										ringIndex(SLICES, j, i+1),
+										ringIndex(SLICES, j, i),
+										ringIndex(SLICES, j+1, i),
+										ringIndex(SLICES, j, i+1),
+										ringIndex(SLICES, j+1, i),
+										ringIndex(SLICES, j+1, i+1)});
+							}
 						}
 
+						//bottom
+						for(int i = 0; i < SLICES; i++)
+						{
+							index.insert(index.end(), {
+									ringIndex(SLICES, STACKS-1, i+1),
+									ringIndex(SLICES, STACKS-1, i),
+									ringIndex(SLICES, STACKS, i)});
+						}
 					}
 			};
 		}
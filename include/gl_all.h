@@ -2,4 +2,14 @@
 
 #include "gl_base.h"
 #include "gl_3D.h"
+#include "gl_meshcache.h"
+#include "gl_objloader.h"
+#include "gl_texloader.h"
+#include "gl_compress.h"
+#include "gl_texcache.h"
+#include "gl_atlas.h"
+#include "gl_progcache.h"
+#include "gl_shaderbatch.h"
+#include "gl_scene.h"
+#include "gl_bvh.h"
 #include "gl_main.h"
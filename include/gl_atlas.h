@@ -0,0 +1,398 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+#include <glm/glm.hpp>
+#include "gl_debug.h"
+#include "gl_helper.h"
+#include "gl_base.h"
+#include "gl_3D.h"
+#include "gl_image.h"
+#include "gl_thread.h"
+
+namespace jikoLib{
+	namespace GLLib{
+
+		/**
+		 * TextureAtlas
+		 * packs many images into one texture, so the objects sharing it are drawn with one bind
+		 * and a per-object lookup (layer and uv rect) instead of a bind per material.
+		 * ARRAY: one layer of a Texture2DArray per image. the layer has the size of the largest image.
+		 * ATLAS: the images are packed on shelves (tallest first) into pages, the pages are the layers.
+		 * the borders are extruded, so the filtering does not bleed. uvs outside of [0, 1] (repeat) do not work in the atlas.
+		 *
+		 */
+
+		class TextureAtlas
+		{
+			public:
+				enum Mode
+				{
+					ARRAY,
+					ATLAS
+				};
+
+				//the place of an image: uv in the atlas = uv*scale + offset on the layer
+				struct Region
+				{
+					GLint layer = 0;
+					glm::vec2 offset = glm::vec2(0.0f);
+					glm::vec2 scale = glm::vec2(1.0f);
+					//in pixels
+					GLsizei x = 0;
+					GLsizei y = 0;
+					GLsizei width = 0;
+					GLsizei height = 0;
+
+					inline glm::vec2 transform(const glm::vec2 &uv) const
+					{
+						return uv*scale + offset;
+					}
+
+					//(offset, scale) for a vec4 uniform
+					inline glm::vec4 getRect() const
+					{
+						return glm::vec4(offset.x, offset.y, scale.x, scale.y);
+					}
+				};
+
+				constexpr static std::size_t NONE = static_cast<std::size_t>(-1);
+
+			private:
+				struct Entry
+				{
+					std::string name;
+					std::string path;
+					ImageData image;
+					Region region;
+				};
+
+				struct Shelf
+				{
+					std::size_t page;
+					GLsizei y;
+					GLsizei height;
+					GLsizei x;
+				};
+
+				std::vector<Entry> entries;
+				std::unordered_map<std::string, std::size_t> names;
+				std::vector<std::vector<GLubyte>> pages;
+				GLsizei page_width = 0;
+				GLsizei page_height = 0;
+				std::size_t num_pages = 0;
+				bool built = false;
+
+				//copy the image of entry to its region, the edge pixels repeated extrude pixels outwards
+				void blit(const Entry &entry, GLsizei extrude)
+				{
+					const ImageData &image = entry.image;
+					const Region &region = entry.region;
+					std::vector<GLubyte> &page = pages[region.layer];
+					const std::size_t c = image.channels;
+					const GLsizei x0 = std::max<GLsizei>(0, region.x-extrude);
+					const GLsizei x1 = std::min<GLsizei>(page_width, region.x+region.width+extrude);
+					const GLsizei y0 = std::max<GLsizei>(0, region.y-extrude);
+					const GLsizei y1 = std::min<GLsizei>(page_height, region.y+region.height+extrude);
+					for(GLsizei y = y0; y < y1; y++)
+					{
+						const GLsizei sy = std::min(std::max<GLsizei>(y-region.y, 0), image.height-1);
+						const GLubyte* row = &image.pixels[static_cast<std::size_t>(sy)*image.width*c];
+						GLubyte* dst = &page[(static_cast<std::size_t>(y)*page_width + x0)*4];
+						for(GLsizei x = x0; x < x1; x++, dst += 4)
+						{
+							const GLsizei sx = std::min(std::max<GLsizei>(x-region.x, 0), image.width-1);
+							const GLubyte* src = row + sx*c;
+							//1: gray, 2: gray + alpha, 3: RGB, 4: RGBA
+							const bool gray = (c < 3);
+							dst[0] = src[0];
+							dst[1] = gray ? src[0] : src[1];
+							dst[2] = gray ? src[0] : src[2];
+							dst[3] = (c == 2) ? src[1] : (c == 4) ? src[3] : 255;
+						}
+					}
+				}
+
+				//shelf packing. returns false if an image does not fit into a page
+				bool pack(GLsizei page_size, GLsizei padding)
+				{
+					std::vector<std::size_t> order(entries.size());
+					for(std::size_t i = 0; i < order.size(); i++)
+						order[i] = i;
+					std::sort(order.begin(), order.end(), [this](std::size_t a, std::size_t b)
+							{
+							const ImageData &ia = entries[a].image, &ib = entries[b].image;
+							return (ia.height != ib.height) ? ia.height > ib.height : (ia.width != ib.width) ? ia.width > ib.width : a < b;
+							});
+
+					std::vector<Shelf> shelves;
+					std::vector<GLsizei> page_used;
+					GLsizei used_height = 0;
+					for(auto&& i : order)
+					{
+						const GLsizei w = entries[i].image.width + 2*padding;
+						const GLsizei h = entries[i].image.height + 2*padding;
+						if(w > page_size || h > page_size)
+						{
+							std::cerr << "image " << entries[i].name << " is larger than the atlas page (" << page_size << ") --did nothing" << std::endl;
+							return false;
+						}
+						//first shelf with room
+						Shelf* shelf = nullptr;
+						for(auto&& s : shelves)
+						{
+							if(s.height >= h && s.x + w <= page_size)
+							{
+								shelf = &s;
+								break;
+							}
+						}
+						if(shelf == nullptr)
+						{
+							if(page_used.empty() || page_used.back() + h > page_size)
+								page_used.push_back(0);
+							shelves.push_back({page_used.size()-1, page_used.back(), h, 0});
+							page_used.back() += h;
+							shelf = &shelves.back();
+						}
+						Region &region = entries[i].region;
+						region.layer = shelf->page;
+						region.x = shelf->x + padding;
+						region.y = shelf->y + padding;
+						region.width = entries[i].image.width;
+						region.height = entries[i].image.height;
+						shelf->x += w;
+						used_height = std::max(used_height, shelf->y + shelf->height);
+					}
+					page_width = page_size;
+					//the height of a single page is trimmed (multiple of 4)
+					page_height = (page_used.size() == 1) ? (used_height+3)/4*4 : page_size;
+					pages.resize(page_used.size());
+					return true;
+				}
+
+			public:
+				TextureAtlas() {}
+
+				//add an image file (decoded in build). returns the index of the image
+				std::size_t add(const std::string &name, const std::string &path)
+				{
+					auto it = names.find(name);
+					if(it != names.end())
+					{
+						std::cerr << "image " << name << " is already in the atlas --did nothing" << std::endl;
+						return it->second;
+					}
+					Entry entry;
+					entry.name = name;
+					entry.path = path;
+					entries.push_back(std::move(entry));
+					names[name] = entries.size()-1;
+					built = false;
+					return entries.size()-1;
+				}
+
+				//add decoded pixels (1 to 4 channels: gray, gray + alpha, RGB, RGBA)
+				std::size_t add(const std::string &name, ImageData image)
+				{
+					std::size_t index = add(name, std::string());
+					if(entries[index].path.empty() && entries[index].image.pixels.empty())
+						entries[index].image = std::move(image);
+					return index;
+				}
+
+				//decode the files on the pool, place the images and copy them into the pages
+				bool build(Mode mode = ATLAS, GLsizei page_size = 2048, GLsizei padding = 4, ThreadPool &pool = ThreadPool::getDefault())
+				{
+					built = false;
+					pages.clear();
+					num_pages = 0;
+					if(entries.empty())
+					{
+						std::cerr << "texture atlas is empty --did nothing" << std::endl;
+						return false;
+					}
+
+					std::vector<unsigned char> success(entries.size(), 1);
+					pool.parallelFor(entries.size(), [&](std::size_t i)
+							{
+							Entry &entry = entries[i];
+							if(!entry.path.empty() && entry.image.pixels.empty())
+								success[i] = ImageDecoder::decode(entry.path, 4, entry.image);
+							else
+								success[i] = !entry.image.pixels.empty();
+							});
+					for(std::size_t i = 0; i < entries.size(); i++)
+					{
+						if(!success[i])
+						{
+							std::cerr << "cannot load image " << entries[i].name << " --did nothing" << std::endl;
+							return false;
+						}
+					}
+
+					GLsizei extrude = padding;
+					if(mode == ARRAY)
+					{
+						page_width = page_height = 0;
+						for(auto&& entry : entries)
+						{
+							page_width = std::max(page_width, entry.image.width);
+							page_height = std::max(page_height, entry.image.height);
+						}
+						for(std::size_t i = 0; i < entries.size(); i++)
+						{
+							Region &region = entries[i].region;
+							region.layer = i;
+							region.x = region.y = 0;
+							region.width = entries[i].image.width;
+							region.height = entries[i].image.height;
+						}
+						pages.resize(entries.size());
+						//the rest of the layer is filled with the edges
+						extrude = std::max(page_width, page_height);
+					}
+					else if(!pack(page_size, padding))
+						return false;
+
+					for(auto&& entry : entries)
+					{
+						Region &region = entry.region;
+						region.offset = glm::vec2(static_cast<float>(region.x)/page_width, static_cast<float>(region.y)/page_height);
+						region.scale = glm::vec2(static_cast<float>(region.width)/page_width, static_cast<float>(region.height)/page_height);
+					}
+					for(auto&& page : pages)
+						page.assign(static_cast<std::size_t>(page_width)*page_height*4, 0);
+					//the regions (with the padding) do not overlap
+					pool.parallelFor(entries.size(), [&](std::size_t i)
+							{
+							blit(entries[i], extrude);
+							});
+					num_pages = pages.size();
+					built = true;
+					DEBUG_OUT("texture atlas built. " << entries.size() << " images, " << pages.size() << " pages of " << page_width << "x" << page_height);
+					return true;
+				}
+
+				//Texture2DArray: all the pages. Texture2D: the atlas must have one page
+				template<typename TargetType, typename Allocator>
+					bool upload(Texture<TargetType, Allocator> &texture, bool mipmap = true) const
+					{
+						static_assert(is_exist<TargetType, Texture2D, Texture2DArray>::value, "invalid type");
+						const bool is_array = std::is_same<TargetType, Texture2DArray>::value;
+						if(!built)
+						{
+							std::cerr << "texture atlas isn't built --did nothing" << std::endl;
+							return false;
+						}
+						if(pages.empty())
+						{
+							std::cerr << "the pixels of the texture atlas are released --did nothing" << std::endl;
+							return false;
+						}
+						if(!is_array && pages.size() != 1)
+						{
+							std::cerr << "texture atlas has " << pages.size() << " pages. use Texture2DArray --did nothing" << std::endl;
+							return false;
+						}
+						texture.bind();
+						glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+						if(is_array)
+						{
+							glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_RGBA8, page_width, page_height, pages.size(), 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+							CHECK_GL_ERROR;
+							for(std::size_t l = 0; l < pages.size(); l++)
+							{
+								glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, 0, l, page_width, page_height, 1, GL_RGBA, GL_UNSIGNED_BYTE, pages[l].data());
+								CHECK_GL_ERROR;
+							}
+						}
+						else
+						{
+							glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, page_width, page_height, 0, GL_RGBA, GL_UNSIGNED_BYTE, pages[0].data());
+							CHECK_GL_ERROR;
+						}
+						if(mipmap)
+							glGenerateMipmap(TargetType::TEXTURE_TARGET);
+						else
+							glTexParameteri(TargetType::TEXTURE_TARGET, GL_TEXTURE_MAX_LEVEL, 0);
+						CHECK_GL_ERROR;
+						texture.unbind();
+						return true;
+					}
+
+				//free the pixels after the upload (the regions stay. build again needs the images added again)
+				void releasePixels()
+				{
+					for(auto&& entry : entries)
+					{
+						entry.image = ImageData();
+						entry.path.clear();
+					}
+					pages.clear();
+					pages.shrink_to_fit();
+				}
+
+				//index of name, or NONE
+				inline std::size_t find(const std::string &name) const
+				{
+					auto it = names.find(name);
+					return (it == names.end()) ? NONE : it->second;
+				}
+
+				inline const Region& getRegion(std::size_t index) const
+				{
+					return entries[index].region;
+				}
+
+				inline const std::string& getName(std::size_t index) const
+				{
+					return entries[index].name;
+				}
+
+				inline std::size_t getNumImages() const
+				{
+					return entries.size();
+				}
+
+				inline std::size_t getNumPages() const
+				{
+					return num_pages;
+				}
+
+				inline GLsizei getPageWidth() const
+				{
+					return page_width;
+				}
+
+				inline GLsizei getPageHeight() const
+				{
+					return page_height;
+				}
+
+				//layer and uv rect of index to the uniforms (vec4 rect: offset.xy, scale.zw. float layer)
+				template<typename Sp_Alloc>
+					void setUniform(ShaderProg<Sp_Alloc> &program, std::size_t index, const std::string &rect_name = "atlas_rect", const std::string &layer_name = "atlas_layer") const
+					{
+						const Region &region = entries[index].region;
+						program.setUniformXt(rect_name, region.offset.x, region.offset.y, region.scale.x, region.scale.y);
+						program.setUniformXt(layer_name, static_cast<GLfloat>(region.layer));
+					}
+
+				//bake the uv rect of index into the texture coordinates of the mesh (no uniform per object on a single page)
+				void remapUV(MeshData &mesh, std::size_t index) const
+				{
+					const Region &region = entries[index].region;
+					for(auto&& vertex : mesh.vertices)
+					{
+						const glm::vec2 uv = region.transform(glm::vec2(vertex.texcrd[0], vertex.texcrd[1]));
+						vertex.texcrd[0] = uv.x;
+						vertex.texcrd[1] = uv.y;
+					}
+				}
+		};
+	}
+}
@@ -10,6 +10,9 @@
 #include <vector>
 #include <tuple>
 #include <functional>
+#include <unordered_map>
+#include <algorithm>
+#include <cstring>
 #include "gl_helper.h"
 
 namespace jikoLib{
@@ -30,6 +33,10 @@ namespace jikoLib{
 			class ShaderProg;
 		template<typename TargetType, typename UsageType, typename Allocator>
 			class VertexBuffer;
+		template<typename UsageType, typename Allocator>
+			class UniformBuffer;
+		template<typename TargetType, typename Allocator>
+			class RingBuffer;
 		template<typename Allocator> 
 			class VertexArray;
 
@@ -108,6 +115,14 @@ namespace jikoLib{
 
 					Shader& operator<<(const std::string& str)
 						//read shader source and compile
+					{
+						submit(str);
+						checkCompile();
+						return *this;
+					}
+
+					//start the compile of str without waiting for the result (see ShaderBatch)
+					void submit(const std::string& str)
 					{
 						const char *source = str.c_str();
 						const int length = str.length();
@@ -115,7 +130,22 @@ namespace jikoLib{
 						CHECK_GL_ERROR;
 						glCompileShader(shader_id);
 						CHECK_GL_ERROR;
+					}
+
+					//false while the driver is still compiling (KHR_parallel_shader_compile). always true without it
+					bool isCompletionReady() const
+					{
+						if(!(GLEW_KHR_parallel_shader_compile || GLEW_ARB_parallel_shader_compile))
+							return true;
+						GLint completed = GL_TRUE;
+						glGetShaderiv(shader_id, GL_COMPLETION_STATUS_KHR, &completed);
+						CHECK_GL_ERROR;
+						return completed == GL_TRUE;
+					}
 
+					//wait for the compile and print the log if it failed
+					bool checkCompile()
+					{
 						GLint compiled, size;
 						GLsizei len;
 						char* buf = nullptr;
@@ -125,6 +155,7 @@ namespace jikoLib{
 						if(compiled == GL_FALSE)
 						{
 							//compile failed
+							is_compiled = false;
 							std::cerr << "id " << shader_id << " Compile Failed!: " << std::endl;
 							glGetShaderiv(shader_id, GL_INFO_LOG_LENGTH, &size);
 							CHECK_GL_ERROR;
@@ -143,13 +174,18 @@ namespace jikoLib{
 							is_compiled = true;
 							DEBUG_OUT("shader compiled!");
 						}
-						return *this;
+						return is_compiled;
 					}
 
 					inline GLuint getID() const
 					{
 						return this->shader_id;
 					}
+
+					inline bool getIsCompiled() const
+					{
+						return is_compiled;
+					}
 			};
 
 		//shaderprog
@@ -160,17 +196,88 @@ namespace jikoLib{
 					GLuint shaderprog_id;
 					bool isLinked = false;
 					Allocator a;
+
+					//uniform name hash -> (name, location) (filled at link time). the name is compared on lookup
+					std::unordered_map<std::uint32_t, std::pair<std::string, GLint>> uniform_table;
+
+					inline void registerUniform(const std::string &name, GLint loc)
+					{
+						auto result = uniform_table.insert(std::make_pair(uniformHash(name.c_str()), std::make_pair(name, loc)));
+						if(!result.second && result.first->second.first != name)
+						{
+							std::cerr << "uniform name hash collision of " << name << " and " << result.first->second.first << ". " << name << " cannot be found --ignored" << std::endl;
+						}
+					}
+
+					void loadUniformTable()
+					{
+						uniform_table.clear();
+
+						GLint num = 0, max_len = 0;
+						glGetProgramiv(shaderprog_id, GL_ACTIVE_UNIFORMS, &num);
+						CHECK_GL_ERROR;
+						glGetProgramiv(shaderprog_id, GL_ACTIVE_UNIFORM_MAX_LENGTH, &max_len);
+						CHECK_GL_ERROR;
+						std::vector<char> buf(max_len+1);
+
+						for(GLint i = 0; i < num; i++)
+						{
+							GLsizei len = 0;
+							GLint size = 0;
+							GLenum type;
+							glGetActiveUniform(shaderprog_id, i, buf.size(), &len, &size, &type, buf.data());
+							CHECK_GL_ERROR;
+							std::string name(buf.data(), len);
+
+							//uniform block members have no location
+							GLint loc = glGetUniformLocation(shaderprog_id, name.c_str());
+							if(loc == -1)
+								continue;
+							registerUniform(name, loc);
+
+							//array is reported as "name[0]". register "name" and the other elements too.
+							auto bracket = name.find('[');
+							if(bracket != std::string::npos)
+							{
+								std::string base = name.substr(0, bracket);
+								registerUniform(base, loc);
+								for(GLint j = 1; j < size; j++)
+								{
+									std::string elem = base + "[" + std::to_string(j) + "]";
+									registerUniform(elem, glGetUniformLocation(shaderprog_id, elem.c_str()));
+								}
+							}
+						}
+						DEBUG_OUT(uniform_table.size() << " uniform locations cached. shaderprog id is " << shaderprog_id);
+					}
+
+					inline GLint findUniform(const UniformName &name) const
+					{
+						auto it = uniform_table.find(name.hash);
+						if(it == uniform_table.end() || it->second.first != name.name)
+						{
+							std::cerr << "uniform variable " << name.name << " cannot be found" << std::endl;
+							return -1;
+						}
+						return it->second.second;
+					}
+
+					//glProgramUniform* does not need glUseProgram
+					inline static bool hasProgramUniform()
+					{
+						static const bool has = GLEW_VERSION_4_1 || GLEW_ARB_separate_shader_objects;
+						return has;
+					}
+
 				public:
 					inline void bind() const
 					{
-						glUseProgram(shaderprog_id);
-						CHECK_GL_ERROR;
+						BindState::current().bindProgram(shaderprog_id);
 					}
 
 					inline void unbind() const
 					{
-						glUseProgram(0);
-						CHECK_GL_ERROR;
+						BindState::current().unbindProgram();
 					}
 
 					ShaderProg()
@@ -191,6 +298,7 @@ namespace jikoLib{
 					{
 						this->shaderprog_id = obj.shaderprog_id;
 						this->isLinked = obj.isLinked;
+						this->uniform_table = obj.uniform_table;
 
 						a.copy(obj.a);
 						CHECK_GL_ERROR;
@@ -201,6 +309,7 @@ namespace jikoLib{
 					{
 						this->shaderprog_id = obj.shaderprog_id;
 						this->isLinked = obj.isLinked;
+						this->uniform_table = obj.uniform_table;
 
 						a.move(std::move(obj.a));
 						CHECK_GL_ERROR;
@@ -212,10 +321,12 @@ namespace jikoLib{
 						a.destruct(shaderprog_id);
 						this->shaderprog_id = obj.shaderprog_id;
 						this->isLinked = obj.isLinked;
+						this->uniform_table = obj.uniform_table;
 
 						a.copy(obj.a);
 						CHECK_GL_ERROR;
 						DEBUG_OUT("shaderprog copied! shaderprog id is " << shaderprog_id);
+						return *this;
 					}
 
 					ShaderProg& operator=(ShaderProg<Allocator>&& obj)
@@ -223,10 +334,12 @@ namespace jikoLib{
 						a.destruct(shaderprog_id);
 						this->shaderprog_id = obj.shaderprog_id;
 						this->isLinked = obj.isLinked;
+						this->uniform_table = obj.uniform_table;
 
 						a.move(std::move(obj.a));
 						CHECK_GL_ERROR;
 						DEBUG_OUT("shaderprog moved! shaderprog id is " << shaderprog_id);
+						return *this;
 					}
 
 					inline GLuint getID() const
@@ -234,6 +347,63 @@ namespace jikoLib{
 						return shaderprog_id;
 					}
 
+					inline bool getIsLinked() const
+					{
+						return isLinked;
+					}
+
+					//ask the driver to keep the binary of the next link (for getProgramBinary)
+					void setBinaryRetrievable()
+					{
+						if(GLEW_VERSION_4_1 || GLEW_ARB_get_program_binary)
+						{
+							glProgramParameteri(shaderprog_id, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+							CHECK_GL_ERROR;
+						}
+					}
+
+					//the linked program as a driver specific binary. returns false if it is not available
+					bool getProgramBinary(GLenum &format, std::vector<GLubyte> &binary) const
+					{
+						if(!isLinked || !(GLEW_VERSION_4_1 || GLEW_ARB_get_program_binary))
+							return false;
+						GLint length = 0;
+						glGetProgramiv(shaderprog_id, GL_PROGRAM_BINARY_LENGTH, &length);
+						CHECK_GL_ERROR;
+						if(length <= 0)
+							return false;
+						binary.resize(length);
+						GLsizei written = 0;
+						glGetProgramBinary(shaderprog_id, length, &written, &format, binary.data());
+						CHECK_GL_ERROR;
+						binary.resize(written);
+						return written > 0;
+					}
+
+					//link from a binary of getProgramBinary. returns false (quietly) if the driver rejects it
+					bool programBinary(GLenum format, const GLvoid* binary, GLsizei length)
+					{
+						if(!(GLEW_VERSION_4_1 || GLEW_ARB_get_program_binary))
+							return false;
+						//errors of the earlier calls are reported here, not taken for the result of the binary
+						CHECK_GL_ERROR;
+						glProgramBinary(shaderprog_id, format, binary, length);
+						//a rejected binary sets GL_INVALID_ENUM on some drivers (the link status decides)
+						glGetError();
+						GLint linked = GL_FALSE;
+						glGetProgramiv(shaderprog_id, GL_LINK_STATUS, &linked);
+						CHECK_GL_ERROR;
+						if(linked == GL_FALSE)
+						{
+							DEBUG_OUT("program binary is rejected. shaderprog id is " << shaderprog_id);
+							return false;
+						}
+						isLinked = true;
+						DEBUG_OUT("shader linked from binary!");
+						loadUniformTable();
+						return true;
+					}
+
 					template<typename Shader_type, typename Shader_Allocator>
 						ShaderProg& operator<<(const Shader<Shader_type, Shader_Allocator> &shader)
 						//attach shader
@@ -247,12 +417,51 @@ namespace jikoLib{
 							return *this;
 						}
 
+					ShaderProg& operator<<(const VertexLayout &layout)
+						//bind attribute locations (effective at the next link)
+					{
+						if(isLinked)
+						{
+							std::cerr << "vertex layout is set after link. relink the program to apply it." << std::endl;
+						}
+						for(auto&& attr : layout.getAttribs())
+						{
+							glBindAttribLocation(shaderprog_id, attr.first, attr.second.c_str());
+							CHECK_GL_ERROR;
+						}
+						DEBUG_OUT("vertex layout is set. shaderprog id is " << shaderprog_id);
+						return *this;
+					}
+
 					ShaderProg& operator<<(link_these&&)
 						//link shader
+					{
+						submitLink();
+						checkLink();
+						return *this;
+					}
+
+					//start the link without waiting for the result (see ShaderBatch)
+					void submitLink()
 					{
 						glLinkProgram(shaderprog_id);
 						CHECK_GL_ERROR;
+					}
+
+					//false while the driver is still linking (KHR_parallel_shader_compile). always true without it
+					bool isCompletionReady() const
+					{
+						if(!(GLEW_KHR_parallel_shader_compile || GLEW_ARB_parallel_shader_compile))
+							return true;
+						GLint completed = GL_TRUE;
+						glGetProgramiv(shaderprog_id, GL_COMPLETION_STATUS_KHR, &completed);
+						CHECK_GL_ERROR;
+						return completed == GL_TRUE;
+					}
 
+					//wait for the link, print the log if it failed, otherwise cache the uniform locations
+					bool checkLink()
+					{
 						GLint linked;
 						int size=0, len=0;
 
@@ -260,6 +469,7 @@ namespace jikoLib{
 						CHECK_GL_ERROR;
 						if(linked == GL_FALSE)
 						{
+							isLinked = false;
 							std::cerr << "id "<< shaderprog_id <<" Link Failed!: " << std::endl;
 							glGetProgramiv(shaderprog_id, GL_INFO_LOG_LENGTH, &size);
 							CHECK_GL_ERROR;
@@ -277,14 +487,43 @@ namespace jikoLib{
 						{
 							isLinked = true;
 							DEBUG_OUT("shader linked!");
+							loadUniformTable();
 						}
-						return *this;
+						return isLinked;
 					}
 
 
+					//connect the uniform block to the binding point
+					void bindUniformBlock(const std::string &name, GLuint binding)
+					{
+						GLuint index = glGetUniformBlockIndex(shaderprog_id, name.c_str());
+						CHECK_GL_ERROR;
+						if(index == GL_INVALID_INDEX)
+						{
+							std::cerr << "uniform block " << name << " cannot be found --did nothing" << std::endl;
+							return;
+						}
+						glUniformBlockBinding(shaderprog_id, index, binding);
+						CHECK_GL_ERROR;
+						DEBUG_OUT("uniform block " << name << " is bound to " << binding << ". shaderprog id is " << shaderprog_id);
+					}
+
+					//returns -1 if the block is not found
+					GLint getUniformBlockSize(const std::string &name) const
+					{
+						GLuint index = glGetUniformBlockIndex(shaderprog_id, name.c_str());
+						CHECK_GL_ERROR;
+						if(index == GL_INVALID_INDEX)
+							return -1;
+						GLint size = 0;
+						glGetActiveUniformBlockiv(shaderprog_id, index, GL_UNIFORM_BLOCK_DATA_SIZE, &size);
+						CHECK_GL_ERROR;
+						return size;
+					}
+
 					//select appropriate glUniform function
 					template <typename... ArgTypes>
-						void setUniformXt(const std::string &str, ArgTypes... args)
+						void setUniformXt(const UniformName &name, ArgTypes... args)
 						{
 							//for glUniformXi, glUniformXf
 							using first_type = typename std::tuple_element<0, std::tuple<ArgTypes...>>::type;
@@ -292,16 +531,18 @@ namespace jikoLib{
 							static_assert(is_all_same<first_type, ArgTypes...>::value, "ArgTypes must be all same");
 							static_assert(is_exist<first_type, GLint, GLfloat>::value, "ArgType must be GLint or GLfloat");
 							static_assert((1 <= sizeof...(ArgTypes))&&(sizeof...(ArgTypes) <= 4), "invalid ArgTypes Num");
-							bind();
 
-							auto loc = glGetUniformLocation(shaderprog_id, str.c_str());
-							CHECK_GL_ERROR;
+							auto loc = findUniform(name);
 							if(loc == -1)
+								return;
+
+							if(hasProgramUniform())
 							{
-								std::cerr << "uniform variable " << str << " cannot be found" << std::endl;
+								glProgramUniformXt<sizeof...(ArgTypes), first_type>::func(shaderprog_id, loc, args...);
+								CHECK_GL_ERROR;
 								return;
 							}
-
+							bind();
 							glUniformXt<sizeof...(ArgTypes), first_type>::func(loc, args...);
 							CHECK_GL_ERROR;
 							unbind();
@@ -309,42 +550,46 @@ namespace jikoLib{
 
 
 					template <std::size_t Size_Elem, std::size_t Dim, typename T>
-						void setUniformXtv(const std::string &str, const T (&array)[Size_Elem][Dim])
+						void setUniformXtv(const UniformName &name, const T (&array)[Size_Elem][Dim])
 						{
 							//for glUniformXiv, glUniformXfv
 							static_assert((1 <= Dim)&&(Dim <= 4), "invalid Dim");
 							static_assert(is_exist<T,GLint, GLfloat>::value,"array type must be GLint for GLfloat");
-							bind();
 
-							auto loc = glGetUniformLocation(shaderprog_id, str.c_str());
-							CHECK_GL_ERROR;
+							auto loc = findUniform(name);
 							if(loc == -1)
+								return;
+
+							if(hasProgramUniform())
 							{
-								std::cerr << "uniform variable " << str << " cannot be found" << std::endl;
+								glProgramUniformXtv<Dim, T>::func(shaderprog_id, loc, Size_Elem, &array[0][0]);
+								CHECK_GL_ERROR;
 								return;
 							}
-
-							glUniformXtv<Dim, T>::func(loc, Size_Elem, array);
+							bind();
+							glUniformXtv<Dim, T>::func(loc, Size_Elem, &array[0][0]);
 							CHECK_GL_ERROR;
 							unbind();
 						}
 
 					template <std::size_t Dim, typename T>
-						void setUniformXtv(const std::string &str, const T (&array)[Dim])
+						void setUniformXtv(const UniformName &name, const T (&array)[Dim])
 						{
 							//for glUniformXiv, glUniformXfv
 							static_assert((1 <= Dim)&&(Dim <= 4), "invalid Dim");
 							static_assert(is_exist<T,GLint, GLfloat>::value,"array type must be GLint for GLfloat");
-							bind();
 
-							auto loc = glGetUniformLocation(shaderprog_id, str.c_str());
-							CHECK_GL_ERROR;
+							auto loc = findUniform(name);
 							if(loc == -1)
+								return;
+
+							if(hasProgramUniform())
 							{
-								std::cerr << "uniform variable " << str << " cannot be found" << std::endl;
+								glProgramUniformXtv<Dim, T>::func(shaderprog_id, loc, 1, array);
+								CHECK_GL_ERROR;
 								return;
 							}
-
+							bind();
 							glUniformXtv<Dim, T>::func(loc, 1, array);
 							CHECK_GL_ERROR;
 							unbind();
@@ -352,102 +597,119 @@ namespace jikoLib{
 
 
 					template<typename T>
-						void setUniformXtv(const std::string &str, const T *array, std::size_t Size_Elem, std::size_t Dim = 1)
+						void setUniformXtv(const UniformName &name, const T *array, std::size_t Size_Elem, std::size_t Dim = 1)
 						{
 							static_assert(is_exist<T,GLint, GLfloat>::value,"array type must be GLint for GLfloat");
-							bind();
-							auto loc = glGetUniformLocation(shaderprog_id, str.c_str());
-							CHECK_GL_ERROR;
+							auto loc = findUniform(name);
 							if(loc == -1)
-							{
-								std::cerr << "uniform variable " << str << " cannot be found" << std::endl;
 								return;
-							}
+
+							const bool direct = hasProgramUniform();
+							if(!direct)
+								bind();
 							switch (Dim) {
 								case 1:
-									glUniformXtv<1, T>::func(loc, Size_Elem, array);
+									if(direct) glProgramUniformXtv<1, T>::func(shaderprog_id, loc, Size_Elem, array);
+									else glUniformXtv<1, T>::func(loc, Size_Elem, array);
 									break;
 								case 2:
-									glUniformXtv<2, T>::func(loc, Size_Elem, array);
+									if(direct) glProgramUniformXtv<2, T>::func(shaderprog_id, loc, Size_Elem, array);
+									else glUniformXtv<2, T>::func(loc, Size_Elem, array);
 									break;
 								case 3:
-									glUniformXtv<3, T>::func(loc, Size_Elem, array);
+									if(direct) glProgramUniformXtv<3, T>::func(shaderprog_id, loc, Size_Elem, array);
+									else glUniformXtv<3, T>::func(loc, Size_Elem, array);
 									break;
 								case 4:
-									glUniformXtv<4, T>::func(loc, Size_Elem, array);
+									if(direct) glProgramUniformXtv<4, T>::func(shaderprog_id, loc, Size_Elem, array);
+									else glUniformXtv<4, T>::func(loc, Size_Elem, array);
 									break;
 								default:
 									std::cerr << "invalid Dim Number --did nothing." << std::endl;
 									break;
 							}
-							unbind();
+							CHECK_GL_ERROR;
+							if(!direct)
+								unbind();
 
 						}
 
 					template<std::size_t Size_Elem, std::size_t Dim, typename T>
-						void setUniformMatrixXtv(const std::string &str, const T (&array)[Size_Elem][Dim][Dim])
+						void setUniformMatrixXtv(const UniformName &name, const T (&array)[Size_Elem][Dim][Dim])
 						{
 							static_assert(is_exist<T, GLfloat>::value, "array must be GLfloat.");
 							static_assert((2 <= Dim)&&(Dim <= 4), "invalid Dim");
 
-							bind();
-							auto loc = glGetUniformLocation(shaderprog_id, str.c_str());
-							CHECK_GL_ERROR;
+							auto loc = findUniform(name);
 							if(loc == -1)
+								return;
+
+							if(hasProgramUniform())
 							{
-								std::cerr << "uniform variable " << str << " cannot be found" << std::endl;
+								glProgramUniformMatrixXtv<Dim, T>::func(shaderprog_id, loc, Size_Elem, GL_FALSE, &array[0][0][0]);
+								CHECK_GL_ERROR;
 								return;
 							}
-							glUniformMatrixXtv<Dim, T>::func(loc, Size_Elem, GL_FALSE, array);
+							bind();
+							glUniformMatrixXtv<Dim, T>::func(loc, Size_Elem, GL_FALSE, &array[0][0][0]);
+							CHECK_GL_ERROR;
 							unbind();
 						}
 
 					template<std::size_t Dim, typename T>
-						void setUniformMatrixXtv(const std::string &str, const T (&array)[Dim][Dim])
+						void setUniformMatrixXtv(const UniformName &name, const T (&array)[Dim][Dim])
 						{
 							static_assert(is_exist<T, GLfloat>::value, "array must be GLfloat.");
 							static_assert((2 <= Dim)&&(Dim <= 4), "invalid Dim");
 
-							bind();
-							auto loc = glGetUniformLocation(shaderprog_id, str.c_str());
-							CHECK_GL_ERROR;
+							auto loc = findUniform(name);
 							if(loc == -1)
+								return;
+
+							if(hasProgramUniform())
 							{
-								std::cerr << "uniform variable " << str << " cannot be found" << std::endl;
+								glProgramUniformMatrixXtv<Dim, T>::func(shaderprog_id, loc, 1, GL_FALSE, &array[0][0]);
+								CHECK_GL_ERROR;
 								return;
 							}
-							glUniformMatrixXtv<Dim, T>::func(loc, 1, GL_FALSE, array);
+							bind();
+							glUniformMatrixXtv<Dim, T>::func(loc, 1, GL_FALSE, &array[0][0]);
+							CHECK_GL_ERROR;
 							unbind();
 						}
 
 					template<typename T>
-						void setUniformMatrixXtv(const std::string &str, const T *array, std::size_t Size_Elem, std::size_t Dim)
+						void setUniformMatrixXtv(const UniformName &name, const T *array, std::size_t Size_Elem, std::size_t Dim)
 						{
 							static_assert(is_exist<T, GLfloat>::value, "array must be GLfloat.");
-							bind();
-							auto loc = glGetUniformLocation(shaderprog_id, str.c_str());
-							CHECK_GL_ERROR;
+							auto loc = findUniform(name);
 							if(loc == -1)
-							{
-								std::cerr << "uniform variable " << str << " cannot be found" << std::endl;
 								return;
-							}
+
+							const bool direct = hasProgramUniform();
+							if(!direct)
+								bind();
 							switch(Dim)
 							{
 								case 2:
-									glUniformMatrixXtv<2, T>::func(loc, Size_Elem, GL_FALSE, array);
+									if(direct) glProgramUniformMatrixXtv<2, T>::func(shaderprog_id, loc, Size_Elem, GL_FALSE, array);
+									else glUniformMatrixXtv<2, T>::func(loc, Size_Elem, GL_FALSE, array);
 									break;
 								case 3:
-									glUniformMatrixXtv<3, T>::func(loc, Size_Elem, GL_FALSE, array);
+									if(direct) glProgramUniformMatrixXtv<3, T>::func(shaderprog_id, loc, Size_Elem, GL_FALSE, array);
+									else glUniformMatrixXtv<3, T>::func(loc, Size_Elem, GL_FALSE, array);
 									break;
 								case 4:
-									glUniformMatrixXtv<4, T>::func(loc, Size_Elem, GL_FALSE, array);
+									if(direct) glProgramUniformMatrixXtv<4, T>::func(shaderprog_id, loc, Size_Elem, GL_FALSE, array);
+									else glUniformMatrixXtv<4, T>::func(loc, Size_Elem, GL_FALSE, array);
 									break;
 								default:
 									std::cerr << "invalid Dim Number --did nothing." << std::endl;
 									break;
 							}
-							unbind();
+							CHECK_GL_ERROR;
+							if(!direct)
+								unbind();
 						}
 
 			};
@@ -476,6 +738,28 @@ namespace jikoLib{
 							isSetArray = true;
 						}
 
+					//element array binding is a part of the bound vertex array. unbind it before editing the buffer
+					inline void bindEdit() const
+					{
+						if(std::is_same<TargetType, ElementArrayBuffer>::value)
+							BindState::current().bindVertexArray(0);
+						bind();
+					}
+
+					//keep the storage if the size is not changed (see BUFFER_REUSE)
+					inline void upload(const GLvoid* array, std::size_t size)
+					{
+						if(UsageType::BUFFER_REUSE && isSetArray && Size_Elem*Dim*getSizeof(ArrayEnum) == size)
+						{
+							glBufferSubData(TargetType::BUFFER_TARGET, 0, size, array);
+							CHECK_GL_ERROR;
+							return;
+						}
+						glBufferData(TargetType::BUFFER_TARGET, size, array, UsageType::BUFFER_USAGE);
+						CHECK_GL_ERROR;
+						DEBUG_OUT("allocate "<< size <<" B success! buffer id is " << buffer_id);
+					}
+
 				public:
 
 					inline bool getisSetArray() const
@@ -497,21 +781,19 @@ namespace jikoLib{
 
 					inline void bind() const
 					{
-						glBindBuffer(TargetType::BUFFER_TARGET, buffer_id);
-						CHECK_GL_ERROR;
+						BindState::current().bindBuffer(TargetType::BUFFER_TARGET, buffer_id);
 					}
 
 					inline void unbind() const
 					{
-						glBindBuffer(TargetType::BUFFER_TARGET, 0);
-						CHECK_GL_ERROR;
+						BindState::current().unbindBuffer(TargetType::BUFFER_TARGET);
 					}
 
 					VertexBuffer()
 					{
 						buffer_id = a.construct();
 						CHECK_GL_ERROR;
-						bind();
+						bindEdit();
 						DEBUG_OUT("vbuffer created! id is " << buffer_id);
 						unbind();
 					}
@@ -591,10 +873,8 @@ namespace jikoLib{
 							static_assert( is_exist<T, GLbyte, GLubyte, GLshort, GLushort, GLint, GLuint, GLfloat, GLdouble>::value, "Invalid type" );
 							static_assert((!std::is_same<TargetType,ElementArrayBuffer>::value)||((std::is_same<TargetType,ElementArrayBuffer>::value)&&(is_exist<T,GLubyte,GLushort,GLuint>::value)),
 									"IBO array type must be GLushort or GLuint or GLubyte");
-							bind();
-							glBufferData(TargetType::BUFFER_TARGET, Size_Elem*Dim*sizeof(T), array, UsageType::BUFFER_USAGE);
-							CHECK_GL_ERROR;
-							DEBUG_OUT("allocate "<< Size_Elem*Dim*sizeof(T) <<" B success! buffer id is " << buffer_id);
+							bindEdit();
+							upload(array, Size_Elem*Dim*sizeof(T));
 							setSizeElem_Dim_Type<T>(Size_Elem, Dim);
 							unbind();
 						}
@@ -607,10 +887,8 @@ namespace jikoLib{
 							static_assert( (Size_Elem != 0)&&(Dim != 0), "Zero Elem" );
 							static_assert((!std::is_same<TargetType,ElementArrayBuffer>::value)||((std::is_same<TargetType,ElementArrayBuffer>::value)&&(is_exist<T,GLubyte,GLushort,GLuint>::value)),
 									"IBO array type must be GLushort or GLuint or GLubyte");
-							bind();
-							glBufferData(TargetType::BUFFER_TARGET, Size_Elem*Dim*sizeof(T), array, UsageType::BUFFER_USAGE);
-							CHECK_GL_ERROR;
-							DEBUG_OUT("allocate "<< Size_Elem*Dim*sizeof(T) <<" B success! buffer id is " << buffer_id);
+							bindEdit();
+							upload(array, Size_Elem*Dim*sizeof(T));
 							setSizeElem_Dim_Type<T>(Size_Elem, Dim);
 							unbind();
 						}
@@ -622,273 +900,427 @@ namespace jikoLib{
 							static_assert( (Size_Elem != 0), "Zero Elem" );
 							static_assert((!std::is_same<TargetType,ElementArrayBuffer>::value)||((std::is_same<TargetType,ElementArrayBuffer>::value)&&(is_exist<T,GLubyte,GLushort,GLuint>::value)),
 									"IBO array type must be GLushort or GLuint or GLubyte");
-							bind();
-							glBufferData(TargetType::BUFFER_TARGET, Size_Elem*sizeof(T), array, UsageType::BUFFER_USAGE);
-							CHECK_GL_ERROR;
-							DEBUG_OUT("allocate "<< Size_Elem*sizeof(T) <<" B success! buffer id is " << buffer_id);
+							bindEdit();
+							upload(array, Size_Elem*sizeof(T));
 							setSizeElem_Dim_Type<T>(Size_Elem, 1);
 							unbind();
 						}
 
-					VertexBuffer operator+(const VertexBuffer<TargetType, UsageType, Allocator> &obj)
-						//merge buffer data
-					{
-						if(!(this->isSetArray && obj.isSetArray))
+					//overwrite a part of the buffer. offset and Size_Num are counted in T
+					template<typename T>
+						void copySubData(const T* array, std::size_t offset, std::size_t Size_Num)
 						{
-							std::cerr << "Array is not set. --did nothing" << std::endl;
-							return *this;
+							if(!isSetArray)
+							{
+								std::cerr << "Array is not set. --did nothing" << std::endl;
+								return;
+							}
+							if(getEnum<T>::value != ArrayEnum)
+							{
+								std::cerr << "two types is not same --did nothing" << std::endl;
+								return;
+							}
+							if(this->Size_Elem*this->Dim < offset+Size_Num)
+							{
+								std::cerr << "out of range --did nothing" << std::endl;
+								return;
+							}
+							bindEdit();
+							glBufferSubData(TargetType::BUFFER_TARGET, offset*sizeof(T), Size_Num*sizeof(T), array);
+							CHECK_GL_ERROR;
+							unbind();
 						}
-						if(this->ArrayEnum != obj.ArrayEnum)
+
+					inline std::size_t getByteSize() const
+					{
+						return isSetArray ? Size_Elem*Dim*getSizeof(ArrayEnum) : 0;
+					}
+
+					//merge buffer data (copied on the GPU side)
+					VertexBuffer operator+(const VertexBuffer<TargetType, UsageType, Allocator> &obj) const
+					{
+						return concat({this, &obj});
+					}
+
+					//append buffer data. the buffer is reallocated and the id changes
+					//(set it to the vertex array again)
+					VertexBuffer& operator+=(const VertexBuffer<TargetType, UsageType, Allocator> &obj)
+					{
+						append({&obj});
+						return *this;
+					}
+
+					void append(const std::vector<const VertexBuffer<TargetType, UsageType, Allocator>*> &objs)
+					{
+						if(objs.empty())
+							return;
+						std::vector<const VertexBuffer<TargetType, UsageType, Allocator>*> list;
+						list.reserve(objs.size()+1);
+						list.push_back(this);
+						list.insert(list.end(), objs.begin(), objs.end());
+						VertexBuffer<TargetType, UsageType, Allocator> buffer = concat(list);
+						if(buffer.buffer_id != this->buffer_id)
+							*this = std::move(buffer);
+					}
+
+					//allocate the destination at once and copy every source with glCopyBufferSubData
+					static VertexBuffer concat(const std::vector<const VertexBuffer<TargetType, UsageType, Allocator>*> &objs)
+					{
+						VertexBuffer<TargetType, UsageType, Allocator> buffer;
+						if(objs.empty())
 						{
-							std::cerr << "two types is not same --did nothing" << std::endl;
-							return *this;
+							std::cerr << "no buffer --did nothing" << std::endl;
+							return buffer;
 						}
-						if(this->Dim != obj.Dim)
+						const VertexBuffer<TargetType, UsageType, Allocator> &first = *objs.front();
+						std::size_t Size_Elem = 0;
+						for(auto&& obj : objs)
 						{
-							std::cerr << "two arrays' dimension is no same --did nothing" << std::endl;
-							return *this;
+							if(!obj->isSetArray)
+							{
+								std::cerr << "Array is not set. --did nothing" << std::endl;
+								return first;
+							}
+							if(obj->ArrayEnum != first.ArrayEnum)
+							{
+								std::cerr << "two types is not same --did nothing" << std::endl;
+								return first;
+							}
+							if(obj->Dim != first.Dim)
+							{
+								std::cerr << "two arrays' dimension is no same --did nothing" << std::endl;
+								return first;
+							}
+							Size_Elem += obj->Size_Elem;
 						}
 
-						//TODO: this code looks ugly.
+						BindState &state = BindState::current();
+						state.bindBuffer(GL_COPY_WRITE_BUFFER, buffer.buffer_id);
+						glBufferData(GL_COPY_WRITE_BUFFER, Size_Elem*first.Dim*getSizeof(first.ArrayEnum), nullptr, UsageType::BUFFER_USAGE);
+						CHECK_GL_ERROR;
+						DEBUG_OUT("allocate "<< Size_Elem*first.Dim*getSizeof(first.ArrayEnum) <<" B success! buffer id is " << buffer.buffer_id);
 
-						if(this->ArrayEnum == GL_BYTE)
+						std::size_t offset = 0;
+						for(auto&& obj : objs)
 						{
-							std::vector<GLbyte> t_array(this->Dim*this->Size_Elem);
-							std::vector<GLbyte> o_array(obj.Dim*obj.Size_Elem);
-							std::vector<GLbyte> array(this->Dim*this->Size_Elem+obj.Dim*obj.Size_Elem);
-
-							this->bind();
-							GLbyte *temp_t_array = static_cast<GLbyte*>(glMapBuffer(TargetType::BUFFER_TARGET, GL_READ_ONLY));
-							CHECK_GL_ERROR;
-							std::copy(temp_t_array, temp_t_array+this->Dim*this->Size_Elem, t_array.begin());
-							glUnmapBuffer(TargetType::BUFFER_TARGET);
-							CHECK_GL_ERROR;
-							this->unbind();
+							std::size_t size = obj->getByteSize();
+							if(size != 0)
+							{
+								state.bindBuffer(GL_COPY_READ_BUFFER, obj->buffer_id);
+								glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, offset, size);
+								CHECK_GL_ERROR;
+							}
+							offset += size;
+						}
+						state.unbindBuffer(GL_COPY_READ_BUFFER);
+						state.unbindBuffer(GL_COPY_WRITE_BUFFER);
 
-							obj.bind();
-							GLbyte *temp_o_array = static_cast<GLbyte*>(glMapBuffer(TargetType::BUFFER_TARGET, GL_READ_ONLY));
-							CHECK_GL_ERROR;
-							std::copy(temp_o_array, temp_o_array+obj.Dim*obj.Size_Elem, o_array.begin());
-							glUnmapBuffer(TargetType::BUFFER_TARGET);
-							CHECK_GL_ERROR;
-							obj.unbind();
+						buffer.isSetArray = true;
+						buffer.ArrayEnum = first.ArrayEnum;
+						buffer.Size_Elem = Size_Elem;
+						buffer.Dim = first.Dim;
+						return buffer;
+					}
+			};
 
-							array.insert(array.begin(), t_array.begin(), t_array.end());
-							array.insert(array.begin()+t_array.size(), o_array.begin(), o_array.end());
+		//uniformbuffer
+		//CPU copy of a uniform block in std140 layout. update() uploads only the modified range.
+		template<typename UsageType = DynamicDraw, typename Allocator = GLAllocator<Alloc_VertexBuffer>>
+			class UniformBuffer
+			{
+				private:
+					VertexBuffer<UniformBufferTarget, UsageType, Allocator> buffer;
+					std::vector<GLubyte> data;
 
-							VertexBuffer<TargetType, UsageType, Allocator> buffer;
-							buffer.copyData(array.data(), this->Size_Elem+obj.Size_Elem, this->Dim);
+					std::size_t dirty_begin;
+					std::size_t dirty_end;
 
-							return buffer;
-						}
-						if(this->ArrayEnum == GL_UNSIGNED_BYTE)
+					inline void markDirty(std::size_t begin, std::size_t end)
+					{
+						if(dirty_begin == dirty_end)
 						{
-							std::vector<GLubyte> t_array(this->Dim*this->Size_Elem);
-							std::vector<GLubyte> o_array(obj.Dim*obj.Size_Elem);
-							std::vector<GLubyte> array(this->Dim*this->Size_Elem+obj.Dim*obj.Size_Elem);
+							dirty_begin = begin;
+							dirty_end = end;
+							return;
+						}
+						dirty_begin = std::min(dirty_begin, begin);
+						dirty_end = std::max(dirty_end, end);
+					}
 
-							this->bind();
-							GLubyte *temp_t_array = static_cast<GLubyte*>(glMapBuffer(TargetType::BUFFER_TARGET, GL_READ_ONLY));
-							CHECK_GL_ERROR;
-							std::copy(temp_t_array, temp_t_array+this->Dim*this->Size_Elem, t_array.begin());
-							glUnmapBuffer(TargetType::BUFFER_TARGET);
-							CHECK_GL_ERROR;
-							this->unbind();
+					//returns true if the bytes are changed
+					inline bool write(std::size_t offset, const GLubyte* bytes, std::size_t size)
+					{
+						if(std::memcmp(&data[offset], bytes, size) == 0)
+							return false;
+						std::memcpy(&data[offset], bytes, size);
+						markDirty(offset, offset+size);
+						return true;
+					}
 
-							obj.bind();
-							GLubyte *temp_o_array = static_cast<GLubyte*>(glMapBuffer(TargetType::BUFFER_TARGET, GL_READ_ONLY));
-							CHECK_GL_ERROR;
-							std::copy(temp_o_array, temp_o_array+obj.Dim*obj.Size_Elem, o_array.begin());
-							glUnmapBuffer(TargetType::BUFFER_TARGET);
-							CHECK_GL_ERROR;
-							obj.unbind();
+				public:
+					UniformBuffer() :dirty_begin(0), dirty_end(0) {}
 
-							array.insert(array.begin(), t_array.begin(), t_array.end());
-							array.insert(array.begin()+t_array.size(), o_array.begin(), o_array.end());
+					explicit UniformBuffer(std::size_t size) :dirty_begin(0), dirty_end(0)
+					{
+						resize(size);
+					}
 
-							VertexBuffer<TargetType, UsageType, Allocator> buffer;
-							buffer.copyData(array.data(), this->Size_Elem+obj.Size_Elem, this->Dim);
-							return buffer;
-						}
-						if(this->ArrayEnum == GL_SHORT)
-						{
-							std::vector<GLshort> t_array(this->Dim*this->Size_Elem);
-							std::vector<GLshort> o_array(obj.Dim*obj.Size_Elem);
-							std::vector<GLshort> array(this->Dim*this->Size_Elem+obj.Dim*obj.Size_Elem);
+					explicit UniformBuffer(const Std140Layout &layout) :dirty_begin(0), dirty_end(0)
+					{
+						resize(layout.size());
+					}
 
-							this->bind();
-							GLshort *temp_t_array = static_cast<GLshort*>(glMapBuffer(TargetType::BUFFER_TARGET, GL_READ_ONLY));
-							CHECK_GL_ERROR;
-							std::copy(temp_t_array, temp_t_array+this->Dim*this->Size_Elem, t_array.begin());
-							glUnmapBuffer(TargetType::BUFFER_TARGET);
-							CHECK_GL_ERROR;
-							this->unbind();
+					inline GLuint getID() const
+					{
+						return buffer.getID();
+					}
 
-							obj.bind();
-							GLshort *temp_o_array = static_cast<GLshort*>(glMapBuffer(TargetType::BUFFER_TARGET, GL_READ_ONLY));
-							CHECK_GL_ERROR;
-							std::copy(temp_o_array, temp_o_array+obj.Dim*obj.Size_Elem, o_array.begin());
-							glUnmapBuffer(TargetType::BUFFER_TARGET);
-							CHECK_GL_ERROR;
-							obj.unbind();
+					inline const VertexBuffer<UniformBufferTarget, UsageType, Allocator>& getBuffer() const
+					{
+						return buffer;
+					}
+
+					inline std::size_t getSize() const
+					{
+						return data.size();
+					}
 
-							array.insert(array.begin(), t_array.begin(), t_array.end());
-							array.insert(array.begin()+t_array.size(), o_array.begin(), o_array.end());
+					inline bool isDirty() const
+					{
+						return dirty_begin != dirty_end;
+					}
 
-							VertexBuffer<TargetType, UsageType, Allocator> buffer;
-							buffer.copyData(array.data(), this->Size_Elem+obj.Size_Elem, this->Dim);
-							return buffer;
-						}
-						if(this->ArrayEnum == GL_UNSIGNED_SHORT)
+					//allocate the block (zero cleared)
+					void resize(std::size_t size)
+					{
+						data.assign(size, 0);
+						buffer.copyData(data.data(), data.size());
+						dirty_begin = dirty_end = 0;
+					}
+
+					template<typename T>
+						void set(std::size_t offset, const T &value)
 						{
-							std::vector<GLushort> t_array(this->Dim*this->Size_Elem);
-							std::vector<GLushort> o_array(obj.Dim*obj.Size_Elem);
-							std::vector<GLushort> array(this->Dim*this->Size_Elem+obj.Dim*obj.Size_Elem);
+							if(data.size() < offset+Std140<T>::SIZE)
+							{
+								std::cerr << "offset " << offset << " is out of the uniform block --did nothing" << std::endl;
+								return;
+							}
+							GLubyte bytes[Std140<T>::SIZE];
+							Std140<T>::write(bytes, value);
+							write(offset, bytes, Std140<T>::SIZE);
+						}
 
-							this->bind();
-							GLushort *temp_t_array = static_cast<GLushort*>(glMapBuffer(TargetType::BUFFER_TARGET, GL_READ_ONLY));
-							CHECK_GL_ERROR;
-							std::copy(temp_t_array, temp_t_array+this->Dim*this->Size_Elem, t_array.begin());
-							glUnmapBuffer(TargetType::BUFFER_TARGET);
-							CHECK_GL_ERROR;
-							this->unbind();
+					template<typename T>
+						void setArray(std::size_t offset, const T* values, std::size_t num)
+						{
+							const std::size_t stride = Std140Layout::arrayStride<T>();
+							if(num == 0 || data.size() < offset+stride*(num-1)+Std140<T>::SIZE)
+							{
+								std::cerr << "offset " << offset << " is out of the uniform block --did nothing" << std::endl;
+								return;
+							}
+							GLubyte bytes[Std140<T>::SIZE];
+							for(std::size_t i = 0; i < num; i++)
+							{
+								Std140<T>::write(bytes, values[i]);
+								write(offset+stride*i, bytes, Std140<T>::SIZE);
+							}
+						}
 
-							obj.bind();
-							GLushort *temp_o_array = static_cast<GLushort*>(glMapBuffer(TargetType::BUFFER_TARGET, GL_READ_ONLY));
-							CHECK_GL_ERROR;
-							std::copy(temp_o_array, temp_o_array+obj.Dim*obj.Size_Elem, o_array.begin());
-							glUnmapBuffer(TargetType::BUFFER_TARGET);
-							CHECK_GL_ERROR;
-							obj.unbind();
+					//upload the modified range. returns false if nothing is changed
+					bool update()
+					{
+						if(!isDirty())
+							return false;
+						buffer.copySubData(data.data()+dirty_begin, dirty_begin, dirty_end-dirty_begin);
+						DEBUG_OUT("uniform block updated " << dirty_end-dirty_begin << " B. buffer id is " << buffer.getID());
+						dirty_begin = dirty_end = 0;
+						return true;
+					}
 
-							array.insert(array.begin(), t_array.begin(), t_array.end());
-							array.insert(array.begin()+t_array.size(), o_array.begin(), o_array.end());
+					//bind to the binding point shared by the programs (see ShaderProg::bindUniformBlock)
+					inline void bindBase(GLuint binding) const
+					{
+						BindState::current().bindBufferBase(UniformBufferTarget::BUFFER_TARGET, binding, buffer.getID());
+					}
+			};
 
-							VertexBuffer<TargetType, UsageType, Allocator> buffer;
-							buffer.copyData(array.data(), this->Size_Elem+obj.Size_Elem, this->Dim);
-							return buffer;
-						}
-						if(this->ArrayEnum == GL_INT)
-						{
-							std::vector<GLint> t_array(this->Dim*this->Size_Elem);
-							std::vector<GLint> o_array(obj.Dim*obj.Size_Elem);
-							std::vector<GLint> array(this->Dim*this->Size_Elem+obj.Dim*obj.Size_Elem);
+		//ringbuffer
+		//persistently mapped buffer split into the regions of the frames in flight.
+		//write into the region of the current frame and draw with the returned offset.
+		//the region is reused after the fence of the frame is signaled.
+		template<typename TargetType, typename Allocator = GLAllocator<Alloc_VertexBuffer>>
+			class RingBuffer
+			{
+				private:
+					GLuint buffer_id;
+					Allocator a;
 
-							this->bind();
-							GLint *temp_t_array = static_cast<GLint*>(glMapBuffer(TargetType::BUFFER_TARGET, GL_READ_ONLY));
-							CHECK_GL_ERROR;
-							std::copy(temp_t_array, temp_t_array+this->Dim*this->Size_Elem, t_array.begin());
-							glUnmapBuffer(TargetType::BUFFER_TARGET);
-							CHECK_GL_ERROR;
-							this->unbind();
+					GLubyte* mapped = nullptr;
+					std::size_t frame_size;
+					std::size_t frames;
 
-							obj.bind();
-							GLint *temp_o_array = static_cast<GLint*>(glMapBuffer(TargetType::BUFFER_TARGET, GL_READ_ONLY));
-							CHECK_GL_ERROR;
-							std::copy(temp_o_array, temp_o_array+obj.Dim*obj.Size_Elem, o_array.begin());
-							glUnmapBuffer(TargetType::BUFFER_TARGET);
-							CHECK_GL_ERROR;
-							obj.unbind();
+					std::size_t current_frame = 0;
+					std::size_t head = 0;
+					std::vector<GLsync> fences;
 
-							array.insert(array.begin(), t_array.begin(), t_array.end());
-							array.insert(array.begin()+t_array.size(), o_array.begin(), o_array.end());
+					std::size_t wait_count = 0;
 
-							VertexBuffer<TargetType, UsageType, Allocator> buffer;
-							buffer.copyData(array.data(), this->Size_Elem+obj.Size_Elem, this->Dim);
-							return buffer;
-						}
-						if(this->ArrayEnum == GL_UNSIGNED_INT)
-						{
-							std::vector<GLuint> t_array(this->Dim*this->Size_Elem);
-							std::vector<GLuint> o_array(obj.Dim*obj.Size_Elem);
-							std::vector<GLuint> array(this->Dim*this->Size_Elem+obj.Dim*obj.Size_Elem);
+				public:
+					constexpr static std::size_t npos = static_cast<std::size_t>(-1);
 
-							this->bind();
-							GLuint *temp_t_array = static_cast<GLuint*>(glMapBuffer(TargetType::BUFFER_TARGET, GL_READ_ONLY));
-							CHECK_GL_ERROR;
-							std::copy(temp_t_array, temp_t_array+this->Dim*this->Size_Elem, t_array.begin());
-							glUnmapBuffer(TargetType::BUFFER_TARGET);
-							CHECK_GL_ERROR;
-							this->unbind();
+					inline void bind() const
+					{
+						BindState::current().bindBuffer(TargetType::BUFFER_TARGET, buffer_id);
+					}
 
-							obj.bind();
-							GLuint *temp_o_array = static_cast<GLuint*>(glMapBuffer(TargetType::BUFFER_TARGET, GL_READ_ONLY));
-							CHECK_GL_ERROR;
-							std::copy(temp_o_array, temp_o_array+obj.Dim*obj.Size_Elem, o_array.begin());
-							glUnmapBuffer(TargetType::BUFFER_TARGET);
-							CHECK_GL_ERROR;
-							obj.unbind();
+					inline void unbind() const
+					{
+						BindState::current().unbindBuffer(TargetType::BUFFER_TARGET);
+					}
 
-							array.insert(array.begin(), t_array.begin(), t_array.end());
-							array.insert(array.begin()+t_array.size(), o_array.begin(), o_array.end());
+					RingBuffer(std::size_t frame_size, std::size_t frames = 3)
+						:frame_size(frame_size), frames(frames), fences(frames, nullptr)
+					{
+						buffer_id = a.construct();
+						CHECK_GL_ERROR;
+						if(!GLEW_ARB_buffer_storage)
+						{
+							std::cerr << "GL_ARB_buffer_storage is not supported. --did nothing" << std::endl;
+							return;
+						}
+						const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+						BindState &state = BindState::current();
+						state.bindBuffer(GL_COPY_WRITE_BUFFER, buffer_id);
+						glBufferStorage(GL_COPY_WRITE_BUFFER, frame_size*frames, nullptr, flags);
+						CHECK_GL_ERROR;
+						mapped = static_cast<GLubyte*>(glMapBufferRange(GL_COPY_WRITE_BUFFER, 0, frame_size*frames, flags));
+						CHECK_GL_ERROR;
+						state.unbindBuffer(GL_COPY_WRITE_BUFFER);
+						DEBUG_OUT("ring buffer created! id is " << buffer_id << ", " << frames << " x " << frame_size << " B");
+					}
 
-							VertexBuffer<TargetType, UsageType, Allocator> buffer;
-							buffer.copyData(array.data(), this->Size_Elem+obj.Size_Elem, this->Dim);
-							return buffer;
+					~RingBuffer()
+					{
+						for(auto&& fence : fences)
+						{
+							if(fence != nullptr)
+								glDeleteSync(fence);
 						}
-						if(this->ArrayEnum == GL_FLOAT)
+						if(mapped != nullptr)
 						{
-							std::vector<GLfloat> t_array(this->Dim*this->Size_Elem);
-							std::vector<GLfloat> o_array(obj.Dim*obj.Size_Elem);
-							std::vector<GLfloat> array(this->Dim*this->Size_Elem+obj.Dim*obj.Size_Elem);
-
-							this->bind();
-							GLfloat *temp_t_array = static_cast<GLfloat*>(glMapBuffer(TargetType::BUFFER_TARGET, GL_READ_ONLY));
-							CHECK_GL_ERROR;
-							std::copy(temp_t_array, temp_t_array+this->Dim*this->Size_Elem, t_array.begin());
-							glUnmapBuffer(TargetType::BUFFER_TARGET);
+							BindState::current().bindBuffer(GL_COPY_WRITE_BUFFER, buffer_id);
+							glUnmapBuffer(GL_COPY_WRITE_BUFFER);
 							CHECK_GL_ERROR;
-							this->unbind();
+							BindState::current().unbindBuffer(GL_COPY_WRITE_BUFFER);
+						}
+						a.destruct(buffer_id);
+						CHECK_GL_ERROR;
+						DEBUG_OUT("ring buffer id " << buffer_id << " destructed!");
+					}
 
-							obj.bind();
-							GLfloat *temp_o_array = static_cast<GLfloat*>(glMapBuffer(TargetType::BUFFER_TARGET, GL_READ_ONLY));
-							CHECK_GL_ERROR;
-							std::copy(temp_o_array, temp_o_array+obj.Dim*obj.Size_Elem, o_array.begin());
-							glUnmapBuffer(TargetType::BUFFER_TARGET);
-							CHECK_GL_ERROR;
-							obj.unbind();
+					//the mapping belongs to one object
+					RingBuffer(const RingBuffer&) = delete;
+					RingBuffer& operator=(const RingBuffer&) = delete;
 
-							array.insert(array.begin(), t_array.begin(), t_array.end());
-							array.insert(array.begin()+t_array.size(), o_array.begin(), o_array.end());
+					inline GLuint getID() const
+					{
+						return buffer_id;
+					}
 
-							VertexBuffer<TargetType, UsageType, Allocator> buffer;
-							buffer.copyData(array.data(), this->Size_Elem+obj.Size_Elem, this->Dim);
-							return buffer;
-						}
-						if(this->ArrayEnum == GL_DOUBLE)
-						{
-							std::vector<GLdouble> t_array(this->Dim*this->Size_Elem);
-							std::vector<GLdouble> o_array(obj.Dim*obj.Size_Elem);
-							std::vector<GLdouble> array(this->Dim*this->Size_Elem+obj.Dim*obj.Size_Elem);
+					inline bool isMapped() const
+					{
+						return mapped != nullptr;
+					}
 
-							this->bind();
-							GLdouble *temp_t_array = static_cast<GLdouble*>(glMapBuffer(TargetType::BUFFER_TARGET, GL_READ_ONLY));
-							CHECK_GL_ERROR;
-							std::copy(temp_t_array, temp_t_array+this->Dim*this->Size_Elem, t_array.begin());
-							glUnmapBuffer(TargetType::BUFFER_TARGET);
-							CHECK_GL_ERROR;
-							this->unbind();
+					inline std::size_t getFrameSize() const
+					{
+						return frame_size;
+					}
 
-							obj.bind();
-							GLdouble *temp_o_array = static_cast<GLdouble*>(glMapBuffer(TargetType::BUFFER_TARGET, GL_READ_ONLY));
-							CHECK_GL_ERROR;
-							std::copy(temp_o_array, temp_o_array+obj.Dim*obj.Size_Elem, o_array.begin());
-							glUnmapBuffer(TargetType::BUFFER_TARGET);
-							CHECK_GL_ERROR;
-							obj.unbind();
+					inline std::size_t getFrames() const
+					{
+						return frames;
+					}
 
-							array.insert(array.begin(), t_array.begin(), t_array.end());
-							array.insert(array.begin()+t_array.size(), o_array.begin(), o_array.end());
+					//bytes left in the region of the current frame
+					inline std::size_t getFreeSize() const
+					{
+						return (mapped == nullptr) ? 0 : frame_size-head;
+					}
 
-							VertexBuffer<TargetType, UsageType, Allocator> buffer;
-							buffer.copyData(array.data(), this->Size_Elem+obj.Size_Elem, this->Dim);
-							return buffer;
+					//how many times beginFrame() had to wait for the GPU
+					inline std::size_t getWaitCount() const
+					{
+						return wait_count;
+					}
+
+					//wait until the GPU finished the draws which read the region of this frame
+					void beginFrame()
+					{
+						head = 0;
+						GLsync &fence = fences[current_frame];
+						if(fence == nullptr)
+							return;
+						GLenum result = glClientWaitSync(fence, 0, 0);
+						if(result == GL_TIMEOUT_EXPIRED)
+						{
+							wait_count++;
+							do
+							{
+								result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);
+							}
+							while(result == GL_TIMEOUT_EXPIRED);
+						}
+						if(result == GL_WAIT_FAILED)
+						{
+							std::cerr << "glClientWaitSync failed!" << std::endl;
 						}
+						glDeleteSync(fence);
+						fence = nullptr;
+					}
 
-						std::cerr << "invalid enum --did nothing" << std::endl;
-						return *this;
+					//call after the last draw which reads this frame
+					void endFrame()
+					{
+						fences[current_frame] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+						CHECK_GL_ERROR;
+						current_frame = (current_frame+1)%frames;
+					}
 
+					//reserve size bytes in the current frame. offset (from the beginning of the buffer) is a multiple of align.
+					//returns the pointer to fill, or nullptr if the region is full
+					GLvoid* allocate(std::size_t size, std::size_t align, std::size_t &offset)
+					{
+						if(mapped == nullptr)
+						{
+							std::cerr << "ring buffer is not mapped. --did nothing" << std::endl;
+							return nullptr;
+						}
+						const std::size_t base = current_frame*frame_size;
+						std::size_t pos = (align > 1) ? (base+head+align-1)/align*align : base+head;
+						if(base+frame_size < pos+size)
+						{
+							std::cerr << "ring buffer is full. --did nothing" << std::endl;
+							return nullptr;
+						}
+						head = pos+size-base;
+						offset = pos;
+						return mapped+pos;
 					}
+
+					//copy num elements. returns the offset in bytes (a multiple of sizeof(T)) or npos
+					template<typename T>
+						std::size_t write(const T* array, std::size_t num)
+						{
+							std::size_t offset;
+							GLvoid* ptr = allocate(num*sizeof(T), sizeof(T), offset);
+							if(ptr == nullptr)
+								return npos;
+							std::memcpy(ptr, array, num*sizeof(T));
+							return offset;
+						}
 			};
 
 		//vertexarray
@@ -903,28 +1335,128 @@ namespace jikoLib{
 
 					inline void bind() const
 					{
-						glBindVertexArray(varray_id);
-						CHECK_GL_ERROR;
+						BindState::current().bindVertexArray(varray_id);
 					}
 
 					inline void unbind() const
 					{
-						glBindVertexArray(0);
+						BindState::current().unbindVertexArray();
+					}
+
+					//set the buffer to the attribute location. this is stored in the vertex array.
+					template<typename UsageType, typename vbAlloc>
+						void setAttrib(GLuint location, const VertexBuffer<ArrayBuffer, UsageType, vbAlloc> &buffer) const
+						{
+							if(!buffer.getisSetArray())
+							{
+								std::cerr << "Array is not set! --did nothing" << std::endl;
+								return;
+							}
+							if(getSizeof(buffer.getArrayEnum()) == 0)
+							{
+								std::cerr << "buffer ArrayEnum is invalid! --did nothing" << std::endl;
+								return;
+							}
+							bind();
+							buffer.bind();
+							glVertexAttribPointer(location, buffer.getDim(), buffer.getArrayEnum(), GL_FALSE, buffer.getDim()*getSizeof(buffer.getArrayEnum()), 0);
+							CHECK_GL_ERROR;
+							glEnableVertexAttribArray(location);
+							CHECK_GL_ERROR;
+							buffer.unbind();
+							unbind();
+						}
+
+					//set all members of the interleaved vertex (see VertexTraits)
+					template<typename VertexType, typename UsageType, typename vbAlloc>
+						void setAttrib(const VertexBuffer<ArrayBuffer, UsageType, vbAlloc> &buffer) const
+						{
+							if(!buffer.getisSetArray())
+							{
+								std::cerr << "Array is not set! --did nothing" << std::endl;
+								return;
+							}
+							if(buffer.getArrayEnum() != GL_FLOAT || buffer.getDim()*sizeof(GLfloat) != sizeof(VertexType))
+							{
+								std::cerr << "buffer is not an array of the vertex type! --did nothing" << std::endl;
+								return;
+							}
+							bind();
+							buffer.bind();
+							VertexTraits<VertexType>::attrib::func();
+							buffer.unbind();
+							unbind();
+						}
+
+					//per-instance attribute (advances once per divisor instances).
+					//Dim > 4 (e.g. mat4: 16) is split into consecutive locations of 4 components
+					template<typename UsageType, typename vbAlloc>
+						void setInstanceAttrib(GLuint location, const VertexBuffer<ArrayBuffer, UsageType, vbAlloc> &buffer, GLuint divisor = 1) const
+						{
+							if(!buffer.getisSetArray())
+							{
+								std::cerr << "Array is not set! --did nothing" << std::endl;
+								return;
+							}
+							const std::size_t size = getSizeof(buffer.getArrayEnum());
+							if(size == 0)
+							{
+								std::cerr << "buffer ArrayEnum is invalid! --did nothing" << std::endl;
+								return;
+							}
+							bind();
+							buffer.bind();
+							for(std::size_t i = 0; i*4 < buffer.getDim(); i++)
+							{
+								const GLint dim = std::min<std::size_t>(4, buffer.getDim()-i*4);
+								glVertexAttribPointer(location+i, dim, buffer.getArrayEnum(), GL_FALSE, buffer.getDim()*size, reinterpret_cast<const GLvoid*>(i*4*size));
+								CHECK_GL_ERROR;
+								glEnableVertexAttribArray(location+i);
+								CHECK_GL_ERROR;
+								glVertexAttribDivisor(location+i, divisor);
+								CHECK_GL_ERROR;
+							}
+							buffer.unbind();
+							unbind();
+						}
+
+					//the interleaved vertex in the ring buffer. draw from offset/sizeof(VertexType)
+					template<typename VertexType, typename rbAlloc>
+						void setAttrib(const RingBuffer<ArrayBuffer, rbAlloc> &buffer) const
+						{
+							if(!buffer.isMapped())
+							{
+								std::cerr << "ring buffer is not mapped! --did nothing" << std::endl;
+								return;
+							}
+							bind();
+							buffer.bind();
+							VertexTraits<VertexType>::attrib::func();
+							buffer.unbind();
+							unbind();
+						}
+
+					inline void disableAttrib(GLuint location) const
+					{
+						bind();
+						glDisableVertexAttribArray(location);
 						CHECK_GL_ERROR;
+						unbind();
 					}
 
-					template<typename IBOAlloc>
-						inline void bindIBO(const VertexBuffer<ElementArrayBuffer, IBOAlloc> &ibo) const
+					template<typename IBOUsage, typename IBOAlloc>
+						inline void bindIBO(const VertexBuffer<ElementArrayBuffer, IBOUsage, IBOAlloc> &ibo) const
 						{
 							bind();
 							ibo.bind();
 							unbind();
 						}
-					template<typename IBOAlloc>
-						inline void unbindIBO(const VertexBuffer<ElementArrayBuffer, IBOAlloc> &ibo) const
+					template<typename IBOUsage, typename IBOAlloc>
+						inline void unbindIBO(const VertexBuffer<ElementArrayBuffer, IBOUsage, IBOAlloc> &) const
 						{
 							bind();
-							ibo.unbind();
+							//detach even if unbind-to-zero is off
+							BindState::current().bindBuffer(ElementArrayBuffer::BUFFER_TARGET, 0);
 							unbind();
 						}
 
@@ -1018,15 +1550,12 @@ namespace jikoLib{
 							std::cerr << "TextureUnit must be between 0 to 32. --set TextureUnit 0" << std::endl;
 							TexUnitNum = 0;
 						}
-						glActiveTexture(GL_TEXTURE0 + TexUnitNum);
-						glBindTexture(TargetType::TEXTURE_TARGET, texture_id);
-						CHECK_GL_ERROR;
+						BindState::current().bindTexture(TargetType::TEXTURE_TARGET, texture_id, TexUnitNum);
 					}
 
 					inline void unbind() const
 					{
-						glBindTexture(TargetType::TEXTURE_TARGET, 0);
-						CHECK_GL_ERROR;
+						BindState::current().unbindTexture(TargetType::TEXTURE_TARGET);
 					}
 
 					Texture()
@@ -1101,6 +1630,15 @@ namespace jikoLib{
 							unbind();
 						}
 
+					template<GLint level = 0, typename int_format = BC1, typename... Args>
+						inline void compressedTexImage2D(Args&&... args)
+						{
+							static_assert(std::is_same<TargetType, Texture2D>::value, "invalid type");
+							bind();
+							TextureTraits<TargetType, level, int_format, int_format>::compressedTexImage2D(std::forward<Args>(args)...);
+							unbind();
+						}
+
 					template<typename... Args>
 						void setParameter()
 						{
@@ -1123,8 +1661,9 @@ namespace jikoLib{
 
 					void generateMipmap()
 					{
-						bind();
+						//setParameter unbinds
 						setParameter<GenerateMipmap<GL_TRUE>>();
+						bind();
 						glGenerateMipmap(TargetType::TEXTURE_TARGET);
 						unbind();
 					}
@@ -1147,14 +1686,12 @@ namespace jikoLib{
 				public:
 					inline void bind() const
 					{
-						glBindFramebuffer(TargetType::FRAMEBUFFER_TARGET, framebuffer_id);
-						CHECK_GL_ERROR;
+						BindState::current().bindFramebuffer(TargetType::FRAMEBUFFER_TARGET, framebuffer_id);
 					}
 
 					inline void unbind() const
 					{
-						glBindFramebuffer(TargetType::FRAMEBUFFER_TARGET, 0);
-						CHECK_GL_ERROR;
+						BindState::current().unbindFramebuffer(TargetType::FRAMEBUFFER_TARGET);
 					}
 
 					FrameBuffer()
@@ -1365,14 +1902,12 @@ namespace jikoLib{
 				public:
 					inline void bind() const
 					{
-						glBindRenderbuffer(TargetType::RENDERBUFFER_TARGET, renderbuffer_id);
-						CHECK_GL_ERROR;
+						BindState::current().bindRenderbuffer(TargetType::RENDERBUFFER_TARGET, renderbuffer_id);
 					}
 
 					inline void unbind() const
 					{
-						glBindRenderbuffer(TargetType::RENDERBUFFER_TARGET, 0);
-						CHECK_GL_ERROR;
+						BindState::current().unbindRenderbuffer(TargetType::RENDERBUFFER_TARGET);
 					}
 
 					RenderBuffer()
@@ -1454,6 +1989,8 @@ namespace jikoLib{
 		using ShaderProgram = ShaderProg<>;
 		using VBO = VertexBuffer<ArrayBuffer, StaticDraw>;
 		using IBO = VertexBuffer<ElementArrayBuffer, StaticDraw>;
+		using UBO = UniformBuffer<>;
+		using RingVBO = RingBuffer<ArrayBuffer>;
 		using VAO = VertexArray<>;
 		using FBO = FrameBuffer<>;
 		using RBO = RenderBuffer<>;
@@ -0,0 +1,676 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cmath>
+#include <limits>
+#include <vector>
+#include <algorithm>
+#include <glm/glm.hpp>
+#include "gl_debug.h"
+#include "gl_thread.h"
+#include "gl_cull.h"
+#include "gl_3D.h"
+
+namespace jikoLib{
+	namespace GLLib{
+
+		/**
+		 * BVH
+		 * bounding volume hierarchy over the world boxes of objects (e.g. Mesh3D::getWorldBoundingBox).
+		 * built top down with binned SAH (along the longest axis): the top levels bin in parallel, then the subtrees are built on the pool.
+		 * the children of a node are a pair after it in the array, so refit() is one pass from the back
+		 * and update() refits one leaf and its ancestors. queries: frustum culling, ray cast and the nearest object.
+		 *
+		 */
+
+		class BVH
+		{
+			public:
+				constexpr static std::uint32_t NONE = 0xFFFFFFFFu;
+
+				struct Node
+				{
+					glm::vec3 min;
+					//leaf: first index in the object list. interior: the left child (the right one is first+1)
+					std::uint32_t first;
+					glm::vec3 max;
+					//objects of the leaf (0: interior)
+					std::uint32_t count;
+				};
+				static_assert(sizeof(Node) == 32, "unexpected padding in BVH::Node");
+
+				struct Ray
+				{
+					glm::vec3 origin;
+					glm::vec3 direction;
+					Ray() {}
+					Ray(const glm::vec3 &origin, const glm::vec3 &direction) :origin(origin), direction(direction) {}
+				};
+
+				struct RayHit
+				{
+					std::uint32_t object = NONE;
+					float distance = std::numeric_limits<float>::infinity();
+				};
+
+			private:
+				constexpr static std::size_t BINS = 16;
+				//always a leaf at or below it. a leaf up to MAX_LEAF if SAH finds no better split
+				constexpr static std::size_t MIN_LEAF = 2;
+				constexpr static std::size_t MAX_LEAF = 8;
+				//objects per task of the parallel binning / smallest subtree of a task
+				constexpr static std::size_t TASK_OBJECTS = 16384;
+				constexpr static std::size_t MIN_SUBTREE = 4096;
+				//rays per task of the batch raycast
+				constexpr static std::size_t TASK_RAYS = 1024;
+				//deeper nodes are leaves, so the traversal stacks are fixed arrays
+				constexpr static std::size_t MAX_DEPTH = 60;
+				constexpr static std::size_t STACK_SIZE = MAX_DEPTH+4;
+
+				struct Bin
+				{
+					glm::vec3 min;
+					glm::vec3 max;
+					std::uint32_t count;
+				};
+
+				struct Bins
+				{
+					Bin bins[BINS];
+				};
+
+				struct Item
+				{
+					std::uint32_t node;
+					std::uint32_t begin;
+					std::uint32_t end;
+					std::uint32_t depth;
+				};
+
+				//a subtree built by one task: its root (in the top nodes) and its nodes [begin, end)
+				struct Subtree
+				{
+					std::uint32_t root;
+					std::uint32_t begin;
+					std::uint32_t end;
+				};
+
+				//the box of an object in the leaf order (the build partitions these, so the passes are sequential)
+				struct Ref
+				{
+					BoundingBox box;
+					glm::vec3 center;
+					std::uint32_t object;
+				};
+
+				std::vector<Node> nodes;
+				std::vector<Ref> refs;
+				//per object: the position in refs and the leaf
+				std::vector<std::uint32_t> slots;
+				std::vector<std::uint32_t> leaf_of;
+				std::vector<std::uint32_t> parents;
+				std::vector<Subtree> subtrees;
+				std::uint32_t top_nodes = 0;
+
+				inline static float area(const glm::vec3 &min, const glm::vec3 &max)
+				{
+					const glm::vec3 d = max-min;
+					return d.x*d.y + d.y*d.z + d.z*d.x;
+				}
+
+				//per component (this is the inner loop of the build)
+				inline static void grow(glm::vec3 &min, glm::vec3 &max, const glm::vec3 &bmin, const glm::vec3 &bmax)
+				{
+					min.x = std::min(min.x, bmin.x);
+					min.y = std::min(min.y, bmin.y);
+					min.z = std::min(min.z, bmin.z);
+					max.x = std::max(max.x, bmax.x);
+					max.y = std::max(max.y, bmax.y);
+					max.z = std::max(max.z, bmax.z);
+				}
+
+				inline static void empty(glm::vec3 &min, glm::vec3 &max)
+				{
+					min = glm::vec3(std::numeric_limits<float>::max());
+					max = glm::vec3(-std::numeric_limits<float>::max());
+				}
+
+				//bounds of the objects and of their centroids in [begin, end)
+				void rangeBounds(std::uint32_t begin, std::uint32_t end, glm::vec3 &min, glm::vec3 &max, glm::vec3 &cmin, glm::vec3 &cmax) const
+				{
+					empty(min, max);
+					empty(cmin, cmax);
+					for(std::uint32_t i = begin; i < end; i++)
+					{
+						grow(min, max, refs[i].box.min, refs[i].box.max);
+						grow(cmin, cmax, refs[i].center, refs[i].center);
+					}
+				}
+
+				inline static std::size_t binOf(float c, float cmin, float scale)
+				{
+					return std::min(static_cast<int>(BINS)-1, std::max(0, static_cast<int>((c-cmin)*scale)));
+				}
+
+				void binRange(std::uint32_t begin, std::uint32_t end, int axis, float cmin, float scale, Bins &out) const
+				{
+					for(auto&& bin : out.bins)
+					{
+						empty(bin.min, bin.max);
+						bin.count = 0;
+					}
+					for(std::uint32_t i = begin; i < end; i++)
+					{
+						const Ref &ref = refs[i];
+						Bin &bin = out.bins[binOf(ref.center[axis], cmin, scale)];
+						grow(bin.min, bin.max, ref.box.min, ref.box.max);
+						bin.count++;
+					}
+				}
+
+				//set the bounds of node and choose the split of [begin, end) at mid. returns false for a leaf.
+				//the passes over the objects are split on pool when it is given (not from a task of it)
+				bool split(Node &node, std::uint32_t begin, std::uint32_t end, std::uint32_t &mid, ThreadPool* pool)
+				{
+					const std::uint32_t count = end-begin;
+					const std::size_t tasks = (pool == nullptr) ? 1 : (count+TASK_OBJECTS-1)/TASK_OBJECTS;
+					glm::vec3 cmin, cmax;
+					if(tasks <= 1)
+						rangeBounds(begin, end, node.min, node.max, cmin, cmax);
+					else
+					{
+						std::vector<glm::vec3> parts(tasks*4);
+						pool->parallelFor(tasks, [&](std::size_t t)
+								{
+								rangeBounds(begin+t*TASK_OBJECTS, std::min<std::size_t>(end, begin+(t+1)*TASK_OBJECTS), parts[4*t], parts[4*t+1], parts[4*t+2], parts[4*t+3]);
+								});
+						empty(node.min, node.max);
+						empty(cmin, cmax);
+						for(std::size_t t = 0; t < tasks; t++)
+						{
+							grow(node.min, node.max, parts[4*t], parts[4*t+1]);
+							grow(cmin, cmax, parts[4*t+2], parts[4*t+3]);
+						}
+					}
+					node.first = begin;
+					node.count = count;
+					if(count <= MIN_LEAF)
+						return false;
+
+					//binned along the longest axis of the centroids
+					const glm::vec3 extent = cmax-cmin;
+					const int axis = (extent.x >= extent.y && extent.x >= extent.z) ? 0 : ((extent.y >= extent.z) ? 1 : 2);
+					if(extent[axis] <= 0.0f)
+					{
+						//all the centroids at one point: split by the index
+						if(count <= MAX_LEAF)
+							return false;
+						mid = begin + count/2;
+						node.count = 0;
+						return true;
+					}
+					const float axis_min = cmin[axis];
+					const float scale = BINS/extent[axis];
+					Bins bins;
+					if(tasks <= 1)
+						binRange(begin, end, axis, axis_min, scale, bins);
+					else
+					{
+						std::vector<Bins> parts(tasks);
+						pool->parallelFor(tasks, [&](std::size_t t)
+								{
+								binRange(begin+t*TASK_OBJECTS, std::min<std::size_t>(end, begin+(t+1)*TASK_OBJECTS), axis, axis_min, scale, parts[t]);
+								});
+						bins = parts[0];
+						for(std::size_t t = 1; t < tasks; t++)
+						{
+							for(std::size_t b = 0; b < BINS; b++)
+							{
+								grow(bins.bins[b].min, bins.bins[b].max, parts[t].bins[b].min, parts[t].bins[b].max);
+								bins.bins[b].count += parts[t].bins[b].count;
+							}
+						}
+					}
+
+					//SAH: sweep from the right for the suffix costs, then from the left
+					float right_cost[BINS];
+					glm::vec3 min, max;
+					empty(min, max);
+					std::uint32_t right_count = 0;
+					for(std::size_t b = BINS-1; b > 0; b--)
+					{
+						grow(min, max, bins.bins[b].min, bins.bins[b].max);
+						right_count += bins.bins[b].count;
+						right_cost[b] = (right_count == 0) ? 0.0f : area(min, max)*right_count;
+					}
+					float best_cost = std::numeric_limits<float>::max();
+					std::size_t best_bin = 0;
+					empty(min, max);
+					std::uint32_t left_count = 0;
+					for(std::size_t b = 1; b < BINS; b++)
+					{
+						grow(min, max, bins.bins[b-1].min, bins.bins[b-1].max);
+						left_count += bins.bins[b-1].count;
+						if(left_count == 0 || left_count == count)
+							continue;
+						const float cost = area(min, max)*left_count + right_cost[b];
+						if(cost < best_cost)
+						{
+							best_cost = cost;
+							best_bin = b;
+						}
+					}
+					//a traversal step costs about one object test
+					const float node_area = area(node.min, node.max);
+					if(count <= MAX_LEAF && (best_bin == 0 || best_cost + node_area >= node_area*count))
+						return false;
+
+					if(best_bin > 0)
+					{
+						mid = std::partition(refs.begin()+begin, refs.begin()+end, [&](const Ref &ref)
+								{
+								return binOf(ref.center[axis], axis_min, scale) < best_bin;
+								}) - refs.begin();
+					}
+					else
+					{
+						//one bin holds all: split at the median
+						mid = begin + count/2;
+						std::nth_element(refs.begin()+begin, refs.begin()+mid, refs.begin()+end, [&](const Ref &l, const Ref &r)
+								{
+								return l.center[axis] < r.center[axis];
+								});
+					}
+					node.count = 0;
+					return true;
+				}
+
+				//split and push the children of item to stack (nothing for a leaf)
+				void buildNode(std::vector<Node> &out, const Item &item, std::vector<Item> &stack, ThreadPool* pool)
+				{
+					std::uint32_t mid;
+					if(!split(out[item.node], item.begin, item.end, mid, pool))
+						return;
+					if(item.depth >= MAX_DEPTH)
+					{
+						out[item.node].first = item.begin;
+						out[item.node].count = item.end-item.begin;
+						return;
+					}
+					const std::uint32_t left = out.size();
+					out[item.node].first = left;
+					out.resize(out.size()+2);
+					stack.push_back(Item{left+1, mid, item.end, item.depth+1});
+					stack.push_back(Item{left, item.begin, mid, item.depth+1});
+				}
+
+				//build the subtree of item into out, with its root at out[0]. the children are pairs after their parent
+				void buildSubtree(std::vector<Node> &out, const Item &item)
+				{
+					out.assign(1, Node());
+					std::vector<Item> stack(1, Item{0, item.begin, item.end, item.depth});
+					while(!stack.empty())
+					{
+						const Item next = stack.back();
+						stack.pop_back();
+						buildNode(out, next, stack, nullptr);
+					}
+				}
+
+				//object_boxes: the new boxes of the objects of a leaf are taken from it
+				void refitNode(std::uint32_t n, const std::vector<BoundingBox>* object_boxes = nullptr)
+				{
+					Node &node = nodes[n];
+					if(node.count == 0)
+					{
+						const Node &left = nodes[node.first];
+						const Node &right = nodes[node.first+1];
+						node.min = glm::min(left.min, right.min);
+						node.max = glm::max(left.max, right.max);
+						return;
+					}
+					empty(node.min, node.max);
+					for(std::uint32_t i = node.first; i < node.first+node.count; i++)
+					{
+						if(object_boxes != nullptr)
+							refs[i].box = (*object_boxes)[refs[i].object];
+						grow(node.min, node.max, refs[i].box.min, refs[i].box.max);
+					}
+				}
+
+				//distance along the ray to the box (negative: missed, or beyond max_distance)
+				inline static float rayBox(const glm::vec3 &origin, const glm::vec3 &inv_dir, const glm::vec3 &min, const glm::vec3 &max, float max_distance)
+				{
+					const glm::vec3 t0 = (min-origin)*inv_dir;
+					const glm::vec3 t1 = (max-origin)*inv_dir;
+					const glm::vec3 tmin = glm::min(t0, t1);
+					const glm::vec3 tmax = glm::max(t0, t1);
+					const float enter = std::max(std::max(tmin.x, tmin.y), std::max(tmin.z, 0.0f));
+					const float exit = std::min(std::min(tmax.x, tmax.y), std::min(tmax.z, max_distance));
+					return (enter <= exit) ? enter : -1.0f;
+				}
+
+				inline static float pointBox2(const glm::vec3 &point, const glm::vec3 &min, const glm::vec3 &max)
+				{
+					const glm::vec3 d = glm::max(glm::max(min-point, point-max), glm::vec3(0.0f));
+					return glm::dot(d, d);
+				}
+
+			public:
+				BVH() {}
+
+				//build over the world boxes of the objects (index in boxes = object id)
+				void build(const std::vector<BoundingBox> &object_boxes, ThreadPool &pool = ThreadPool::getDefault())
+				{
+					const std::uint32_t n = object_boxes.size();
+					nodes.clear();
+					subtrees.clear();
+					refs.resize(n);
+					for(std::uint32_t i = 0; i < n; i++)
+					{
+						refs[i].box = object_boxes[i];
+						refs[i].center = object_boxes[i].getCenter();
+						refs[i].object = i;
+					}
+					slots.resize(n);
+					leaf_of.resize(n);
+					if(n == 0)
+					{
+						parents.clear();
+						top_nodes = 0;
+						return;
+					}
+
+					//top levels: one node at a time, the object passes on the pool
+					const std::size_t subtree_size = std::max<std::size_t>(MIN_SUBTREE, n/(8*(pool.size()+1)));
+					std::vector<Item> jobs;
+					std::vector<Item> stack(1, Item{0, 0, n, 0});
+					nodes.resize(1);
+					while(!stack.empty())
+					{
+						const Item item = stack.back();
+						stack.pop_back();
+						if(item.end-item.begin <= subtree_size)
+							jobs.push_back(item);
+						else
+							buildNode(nodes, item, stack, &pool);
+					}
+					top_nodes = nodes.size();
+
+					//subtrees on the pool (the large ones first), then appended
+					std::sort(jobs.begin(), jobs.end(), [](const Item &a, const Item &b){ return a.end-a.begin > b.end-b.begin; });
+					std::vector<std::vector<Node>> built(jobs.size());
+					pool.parallelFor(jobs.size(), [&](std::size_t j)
+							{
+							buildSubtree(built[j], jobs[j]);
+							});
+					std::size_t total = nodes.size();
+					for(auto&& sub : built)
+						total += sub.size()-1;
+					nodes.reserve(total);
+					for(std::size_t j = 0; j < jobs.size(); j++)
+					{
+						//local 0 is the root in the top nodes, local k > 0 is base+k-1
+						const std::vector<Node> &sub = built[j];
+						const std::uint32_t base = nodes.size();
+						for(std::size_t k = 0; k < sub.size(); k++)
+						{
+							Node node = sub[k];
+							if(node.count == 0)
+								node.first = base+node.first-1;
+							if(k == 0)
+								nodes[jobs[j].node] = node;
+							else
+								nodes.push_back(node);
+						}
+						subtrees.push_back(Subtree{jobs[j].node, base, static_cast<std::uint32_t>(nodes.size())});
+					}
+
+					parents.assign(nodes.size(), std::uint32_t(NONE));
+					for(std::uint32_t i = 0; i < nodes.size(); i++)
+					{
+						const Node &node = nodes[i];
+						if(node.count == 0)
+						{
+							parents[node.first] = i;
+							parents[node.first+1] = i;
+						}
+						else
+						{
+							for(std::uint32_t k = node.first; k < node.first+node.count; k++)
+							{
+								slots[refs[k].object] = k;
+								leaf_of[refs[k].object] = i;
+							}
+						}
+					}
+					DEBUG_OUT("BVH built. " << n << " objects, " << nodes.size() << " nodes, " << jobs.size() << " subtrees");
+				}
+
+				void build(const std::vector<Mesh3D> &meshes, ThreadPool &pool = ThreadPool::getDefault())
+				{
+					std::vector<BoundingBox> world(meshes.size());
+					for(std::size_t i = 0; i < meshes.size(); i++)
+						world[i] = meshes[i].getWorldBoundingBox();
+					build(world, pool);
+				}
+
+				//all the objects moved (the same count as the build). the tree is kept, only the bounds are recomputed
+				void refit(const std::vector<BoundingBox> &object_boxes, ThreadPool &pool = ThreadPool::getDefault())
+				{
+					if(object_boxes.size() != refs.size())
+					{
+						std::cerr << "the number of the objects changed. build again --did nothing" << std::endl;
+						return;
+					}
+					pool.parallelFor(subtrees.size(), [&](std::size_t s)
+							{
+							for(std::uint32_t i = subtrees[s].end; i > subtrees[s].begin; i--)
+								refitNode(i-1, &object_boxes);
+							refitNode(subtrees[s].root, &object_boxes);
+							});
+					//the roots of the subtrees are done again (their children are)
+					for(std::uint32_t i = top_nodes; i > 0; i--)
+						refitNode(i-1, &object_boxes);
+				}
+
+				void refit(const std::vector<Mesh3D> &meshes, ThreadPool &pool = ThreadPool::getDefault())
+				{
+					std::vector<BoundingBox> world(meshes.size());
+					for(std::size_t i = 0; i < meshes.size(); i++)
+						world[i] = meshes[i].getWorldBoundingBox();
+					refit(world, pool);
+				}
+
+				//one object moved: its leaf and the ancestors (until a bound does not change)
+				void update(std::uint32_t object, const BoundingBox &box)
+				{
+					refs[slots[object]].box = box;
+					for(std::uint32_t n = leaf_of[object]; n != NONE; n = parents[n])
+					{
+						const glm::vec3 min = nodes[n].min, max = nodes[n].max;
+						refitNode(n);
+						//the ancestors are the same if this did not change
+						if(nodes[n].min == min && nodes[n].max == max)
+							break;
+					}
+				}
+
+				inline std::size_t size() const
+				{
+					return refs.size();
+				}
+
+				inline const std::vector<Node>& getNodes() const
+				{
+					return nodes;
+				}
+
+				inline const BoundingBox& getBox(std::uint32_t object) const
+				{
+					return refs[slots[object]].box;
+				}
+
+				//objects not outside of the frustum (not sorted). a node inside a plane skips that plane for its subtree
+				std::size_t cull(const Frustum &frustum, std::vector<std::uint32_t> &visible) const
+				{
+					visible.clear();
+					if(nodes.empty())
+						return 0;
+					constexpr unsigned int ALL_PLANES = (1u << Frustum::NUM_PLANES)-1;
+					std::uint32_t stack[STACK_SIZE];
+					unsigned int masks[STACK_SIZE];
+					std::size_t top = 0;
+					stack[top] = 0;
+					masks[top++] = ALL_PLANES;
+					while(top > 0)
+					{
+						top--;
+						const Node &node = nodes[stack[top]];
+						unsigned int mask = masks[top];
+						bool outside = false;
+						const glm::vec3 center = (node.min+node.max)*0.5f;
+						const glm::vec3 extent = (node.max-node.min)*0.5f;
+						for(std::size_t p = 0; p < Frustum::NUM_PLANES && !outside; p++)
+						{
+							if(!(mask & (1u << p)))
+								continue;
+							const glm::vec4 &plane = frustum.getPlane(p);
+							const float distance = plane.x*center.x + plane.y*center.y + plane.z*center.z + plane.w;
+							const float radius = std::fabs(plane.x)*extent.x + std::fabs(plane.y)*extent.y + std::fabs(plane.z)*extent.z;
+							if(distance + radius < 0.0f)
+								outside = true;
+							else if(distance - radius >= 0.0f)
+								mask &= ~(1u << p);
+						}
+						if(outside)
+							continue;
+						if(node.count > 0)
+						{
+							for(std::uint32_t i = node.first; i < node.first+node.count; i++)
+							{
+								if(mask == 0 || frustum.isVisible(refs[i].box))
+									visible.push_back(refs[i].object);
+							}
+							continue;
+						}
+						stack[top] = node.first+1;
+						masks[top++] = mask;
+						stack[top] = node.first;
+						masks[top++] = mask;
+					}
+					return visible.size();
+				}
+
+				//nearest hit along the ray. hit_func(object, box_distance) returns the distance of the exact hit
+				//(negative: missed), e.g. a test against the triangles of the mesh
+				template<typename HitFunc>
+					bool raycast(const Ray &ray, RayHit &hit, HitFunc hit_func, float max_distance = std::numeric_limits<float>::infinity()) const
+					{
+						hit = RayHit();
+						if(nodes.empty())
+							return false;
+						const glm::vec3 inv_dir = glm::vec3(1.0f)/ray.direction;
+						float best = max_distance;
+						std::uint32_t stack[STACK_SIZE];
+						std::size_t top = 0;
+						if(rayBox(ray.origin, inv_dir, nodes[0].min, nodes[0].max, best) >= 0.0f)
+							stack[top++] = 0;
+						while(top > 0)
+						{
+							const Node &node = nodes[stack[--top]];
+							if(node.count > 0)
+							{
+								for(std::uint32_t i = node.first; i < node.first+node.count; i++)
+								{
+									const std::uint32_t o = refs[i].object;
+									const float box_distance = rayBox(ray.origin, inv_dir, refs[i].box.min, refs[i].box.max, best);
+									if(box_distance < 0.0f)
+										continue;
+									const float distance = hit_func(o, box_distance);
+									if(distance >= 0.0f && distance < best)
+									{
+										best = distance;
+										hit.object = o;
+										hit.distance = distance;
+									}
+								}
+								continue;
+							}
+							//the nearer child is popped first. the children are tested again after best gets shorter
+							const float left = rayBox(ray.origin, inv_dir, nodes[node.first].min, nodes[node.first].max, best);
+							const float right = rayBox(ray.origin, inv_dir, nodes[node.first+1].min, nodes[node.first+1].max, best);
+							if(left >= 0.0f && right >= 0.0f)
+							{
+								const bool left_first = (left <= right);
+								stack[top++] = left_first ? node.first+1 : node.first;
+								stack[top++] = left_first ? node.first : node.first+1;
+							}
+							else if(left >= 0.0f)
+								stack[top++] = node.first;
+							else if(right >= 0.0f)
+								stack[top++] = node.first+1;
+						}
+						return hit.object != NONE;
+					}
+
+				//nearest box along the ray (picking by the bounds)
+				inline bool raycast(const Ray &ray, RayHit &hit, float max_distance = std::numeric_limits<float>::infinity()) const
+				{
+					return raycast(ray, hit, [](std::uint32_t, float box_distance){ return box_distance; }, max_distance);
+				}
+
+				//many rays on the pool (hits[i].object is NONE for a miss)
+				void raycast(const std::vector<Ray> &rays, std::vector<RayHit> &hits, float max_distance = std::numeric_limits<float>::infinity(), ThreadPool &pool = ThreadPool::getDefault()) const
+				{
+					hits.resize(rays.size());
+					const std::size_t tasks = (rays.size()+TASK_RAYS-1)/TASK_RAYS;
+					pool.parallelFor(tasks, [&](std::size_t t)
+							{
+							const std::size_t end = std::min(rays.size(), (t+1)*TASK_RAYS);
+							for(std::size_t i = t*TASK_RAYS; i < end; i++)
+								raycast(rays[i], hits[i], max_distance);
+							});
+				}
+
+				//object with the nearest box to point (distance 0 inside the box). NONE if nothing is within max_distance
+				std::uint32_t nearest(const glm::vec3 &point, float &distance, float max_distance = std::numeric_limits<float>::infinity()) const
+				{
+					std::uint32_t best_object = NONE;
+					float best2 = max_distance*max_distance;
+					std::uint32_t stack[STACK_SIZE];
+					std::size_t top = 0;
+					if(!nodes.empty())
+						stack[top++] = 0;
+					while(top > 0)
+					{
+						const Node &node = nodes[stack[--top]];
+						if(pointBox2(point, node.min, node.max) > best2)
+							continue;
+						if(node.count > 0)
+						{
+							for(std::uint32_t i = node.first; i < node.first+node.count; i++)
+							{
+								const std::uint32_t o = refs[i].object;
+								const float d2 = pointBox2(point, refs[i].box.min, refs[i].box.max);
+								if(d2 < best2 || (d2 == best2 && best_object == NONE))
+								{
+									best2 = d2;
+									best_object = o;
+								}
+							}
+							continue;
+						}
+						const float left = pointBox2(point, nodes[node.first].min, nodes[node.first].max);
+						const float right = pointBox2(point, nodes[node.first+1].min, nodes[node.first+1].max);
+						const bool left_first = (left <= right);
+						stack[top++] = left_first ? node.first+1 : node.first;
+						stack[top++] = left_first ? node.first : node.first+1;
+					}
+					distance = (best_object == NONE) ? max_distance : std::sqrt(best2);
+					return best_object;
+				}
+		};
+	}
+}
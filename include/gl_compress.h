@@ -0,0 +1,384 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+#include <vector>
+#include <algorithm>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+#include "gl_helper.h"
+#include "gl_image.h"
+#include "gl_thread.h"
+
+namespace jikoLib{
+	namespace GLLib{
+
+		/**
+		 * CompressedImage
+		 * 4x4 blocks row by row (the layout of glCompressedTexImage2D)
+		 *
+		 */
+
+		struct CompressedImage
+		{
+			GLsizei width = 0;
+			GLsizei height = 0;
+			GLenum format = 0;
+			std::size_t block_bytes = 0;
+			std::vector<GLubyte> data;
+		};
+
+		/**
+		 * BlockCompressor
+		 * BC1/BC3 (S3TC) encoder. the block rows are split over the pool.
+		 * color: endpoints on the principal axis of the block (4 color mode), nearest of the 4 palette colors.
+		 * alpha (BC3): min/max endpoints (8 value mode).
+		 *
+		 */
+
+		class BlockCompressor
+		{
+			private:
+				//16 pixels RGBA, row major
+				using Block = GLubyte[64];
+
+				static void fetchBlock(const ImageData &image, GLsizei bx, GLsizei by, Block block)
+				{
+					const std::size_t c = image.channels;
+					for(GLsizei y = 0; y < 4; y++)
+					{
+						const GLsizei sy = std::min(by*4+y, image.height-1);
+						const GLubyte* row = &image.pixels[static_cast<std::size_t>(sy)*image.width*c];
+						if(c == 4 && bx*4+3 < image.width)
+						{
+							std::memcpy(block+y*16, row+bx*16, 16);
+							continue;
+						}
+						for(GLsizei x = 0; x < 4; x++)
+						{
+							const GLubyte* src = row + std::min(bx*4+x, image.width-1)*c;
+							GLubyte* dst = block + (y*4+x)*4;
+							dst[0] = src[0];
+							dst[1] = src[1];
+							dst[2] = src[2];
+							dst[3] = (c == 4) ? src[3] : 255;
+						}
+					}
+				}
+
+				//per channel min/max of the 16 pixels
+				static void bounds(const Block block, GLubyte min[4], GLubyte max[4])
+				{
+#ifdef __SSE2__
+					__m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block));
+					__m128i hi = lo;
+					for(int i = 1; i < 4; i++)
+					{
+						__m128i row = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block+i*16));
+						lo = _mm_min_epu8(lo, row);
+						hi = _mm_max_epu8(hi, row);
+					}
+					//4 pixels -> 1
+					lo = _mm_min_epu8(lo, _mm_srli_si128(lo, 8));
+					hi = _mm_max_epu8(hi, _mm_srli_si128(hi, 8));
+					lo = _mm_min_epu8(lo, _mm_srli_si128(lo, 4));
+					hi = _mm_max_epu8(hi, _mm_srli_si128(hi, 4));
+					const std::uint32_t min_bits = _mm_cvtsi128_si32(lo);
+					const std::uint32_t max_bits = _mm_cvtsi128_si32(hi);
+					std::memcpy(min, &min_bits, 4);
+					std::memcpy(max, &max_bits, 4);
+#else
+					for(int k = 0; k < 4; k++)
+					{
+						min[k] = max[k] = block[k];
+					}
+					for(int i = 1; i < 16; i++)
+					{
+						for(int k = 0; k < 4; k++)
+						{
+							min[k] = std::min(min[k], block[i*4+k]);
+							max[k] = std::max(max[k], block[i*4+k]);
+						}
+					}
+#endif
+				}
+
+				inline static std::uint16_t to565(int r, int g, int b)
+				{
+					return static_cast<std::uint16_t>(((r*31+127)/255) << 11 | ((g*63+127)/255) << 5 | ((b*31+127)/255));
+				}
+
+				inline static void from565(std::uint16_t c, int rgb[3])
+				{
+					const int r = (c >> 11) & 31, g = (c >> 5) & 63, b = c & 31;
+					rgb[0] = (r << 3) | (r >> 2);
+					rgb[1] = (g << 2) | (g >> 4);
+					rgb[2] = (b << 3) | (b >> 2);
+				}
+
+				inline static void put16(GLubyte* out, std::uint16_t value)
+				{
+					out[0] = value & 0xFF;
+					out[1] = value >> 8;
+				}
+
+				static void encodeColor(const Block block, GLubyte out[8])
+				{
+					GLubyte min[4], max[4];
+					bounds(block, min, max);
+
+					//principal axis (power iteration on the covariance, starting from the diagonal of the bounds)
+					int mean[3] = {0, 0, 0};
+					for(int i = 0; i < 16; i++)
+					{
+						for(int k = 0; k < 3; k++)
+							mean[k] += block[i*4+k];
+					}
+					float cov[6] = {0, 0, 0, 0, 0, 0};
+					for(int i = 0; i < 16; i++)
+					{
+						const float r = block[i*4+0] - mean[0]/16.0f;
+						const float g = block[i*4+1] - mean[1]/16.0f;
+						const float b = block[i*4+2] - mean[2]/16.0f;
+						cov[0] += r*r;
+						cov[1] += r*g;
+						cov[2] += r*b;
+						cov[3] += g*g;
+						cov[4] += g*b;
+						cov[5] += b*b;
+					}
+					float axis[3] = {static_cast<float>(max[0]-min[0]), static_cast<float>(max[1]-min[1]), static_cast<float>(max[2]-min[2])};
+					for(int iter = 0; iter < 4; iter++)
+					{
+						const float x = axis[0]*cov[0] + axis[1]*cov[1] + axis[2]*cov[2];
+						const float y = axis[0]*cov[1] + axis[1]*cov[3] + axis[2]*cov[4];
+						const float z = axis[0]*cov[2] + axis[1]*cov[4] + axis[2]*cov[5];
+						const float length = std::max(std::max(std::fabs(x), std::fabs(y)), std::fabs(z));
+						if(length < 1e-6f)
+							break;
+						axis[0] = x/length;
+						axis[1] = y/length;
+						axis[2] = z/length;
+					}
+
+					//the extreme pixels on the axis, moved 1/16 inwards
+					int lo = 0, hi = 0;
+					float lo_dot = 0.0f, hi_dot = 0.0f;
+					for(int i = 0; i < 16; i++)
+					{
+						const float dot = block[i*4+0]*axis[0] + block[i*4+1]*axis[1] + block[i*4+2]*axis[2];
+						if(i == 0 || dot < lo_dot)
+						{
+							lo = i;
+							lo_dot = dot;
+						}
+						if(i == 0 || dot > hi_dot)
+						{
+							hi = i;
+							hi_dot = dot;
+						}
+					}
+					int end0[3], end1[3];
+					for(int k = 0; k < 3; k++)
+					{
+						const int a = block[hi*4+k], b = block[lo*4+k];
+						const int inset = (a-b)/16;
+						end0[k] = a-inset;
+						end1[k] = b+inset;
+					}
+					std::uint16_t c0 = to565(end0[0], end0[1], end0[2]);
+					std::uint16_t c1 = to565(end1[0], end1[1], end1[2]);
+					if(c0 < c1)
+						std::swap(c0, c1);
+					put16(out, c0);
+					put16(out+2, c1);
+					std::uint32_t indices = 0;
+					if(c0 != c1)
+					{
+						int palette[4][3];
+						from565(c0, palette[0]);
+						from565(c1, palette[1]);
+						for(int k = 0; k < 3; k++)
+						{
+							palette[2][k] = (2*palette[0][k] + palette[1][k])/3;
+							palette[3][k] = (palette[0][k] + 2*palette[1][k])/3;
+						}
+						for(int i = 15; i >= 0; i--)
+						{
+							int best = 0, best_dist = 0;
+							for(int p = 0; p < 4; p++)
+							{
+								const int dr = block[i*4+0]-palette[p][0];
+								const int dg = block[i*4+1]-palette[p][1];
+								const int db = block[i*4+2]-palette[p][2];
+								const int dist = dr*dr + dg*dg + db*db;
+								if(p == 0 || dist < best_dist)
+								{
+									best = p;
+									best_dist = dist;
+								}
+							}
+							indices = (indices << 2) | best;
+						}
+					}
+					//c0 == c1: every pixel is c0 (index 0)
+					out[4] = indices & 0xFF;
+					out[5] = (indices >> 8) & 0xFF;
+					out[6] = (indices >> 16) & 0xFF;
+					out[7] = indices >> 24;
+				}
+
+				static void encodeAlpha(const Block block, GLubyte out[8])
+				{
+					GLubyte min[4], max[4];
+					bounds(block, min, max);
+					const int a0 = max[3], a1 = min[3];
+					out[0] = a0;
+					out[1] = a1;
+					std::uint64_t indices = 0;
+					if(a0 != a1)
+					{
+						//index 0: a0, 1: a1, 2..7: a0 -> a1 in 1/7 steps
+						for(int i = 15; i >= 0; i--)
+						{
+							const int t = ((a0-block[i*4+3])*14 + (a0-a1)) / (2*(a0-a1));
+							const int index = (t == 0) ? 0 : (t == 7) ? 1 : t+1;
+							indices = (indices << 3) | index;
+						}
+					}
+					for(int k = 0; k < 6; k++)
+					{
+						out[2+k] = (indices >> (8*k)) & 0xFF;
+					}
+				}
+
+				static void decodeColor(const GLubyte in[8], GLubyte* pixels, std::size_t pitch, bool has_alpha)
+				{
+					const std::uint16_t c0 = in[0] | (in[1] << 8);
+					const std::uint16_t c1 = in[2] | (in[3] << 8);
+					int palette[4][4];
+					from565(c0, palette[0]);
+					from565(c1, palette[1]);
+					palette[0][3] = palette[1][3] = palette[2][3] = 255;
+					palette[3][3] = (c0 > c1 || has_alpha) ? 255 : 0;
+					for(int k = 0; k < 3; k++)
+					{
+						if(c0 > c1 || has_alpha)
+						{
+							palette[2][k] = (2*palette[0][k] + palette[1][k])/3;
+							palette[3][k] = (palette[0][k] + 2*palette[1][k])/3;
+						}
+						else
+						{
+							palette[2][k] = (palette[0][k] + palette[1][k])/2;
+							palette[3][k] = 0;
+						}
+					}
+					const std::uint32_t indices = in[4] | (in[5] << 8) | (in[6] << 16) | (static_cast<std::uint32_t>(in[7]) << 24);
+					for(int i = 0; i < 16; i++)
+					{
+						const int* color = palette[(indices >> (2*i)) & 3];
+						GLubyte* dst = pixels + (i/4)*pitch + (i%4)*4;
+						dst[0] = color[0];
+						dst[1] = color[1];
+						dst[2] = color[2];
+						dst[3] = color[3];
+					}
+				}
+
+				static void decodeAlpha(const GLubyte in[8], GLubyte* pixels, std::size_t pitch)
+				{
+					int palette[8];
+					palette[0] = in[0];
+					palette[1] = in[1];
+					for(int k = 1; k < 7; k++)
+					{
+						palette[k+1] = (in[0] > in[1]) ? ((7-k)*in[0] + k*in[1])/7 : (k < 5) ? ((5-k)*in[0] + k*in[1])/5 : (k == 5) ? 0 : 255;
+					}
+					std::uint64_t indices = 0;
+					for(int k = 5; k >= 0; k--)
+					{
+						indices = (indices << 8) | in[2+k];
+					}
+					for(int i = 0; i < 16; i++)
+					{
+						pixels[(i/4)*pitch + (i%4)*4 + 3] = palette[(indices >> (3*i)) & 7];
+					}
+				}
+
+			public:
+
+				inline static std::size_t compressedSize(GLsizei width, GLsizei height, std::size_t block_bytes)
+				{
+					return static_cast<std::size_t>((width+3)/4)*((height+3)/4)*block_bytes;
+				}
+
+				//int_format: BC1 or BC3. image: 3 or 4 channels (BC1 drops the alpha)
+				template<typename int_format>
+					static CompressedImage encode(const ImageData &image, ThreadPool &pool = ThreadPool::getDefault())
+					{
+						static_assert(is_exist<int_format, BC1, BC3>::value, "invalid format");
+						CompressedImage result;
+						result.width = image.width;
+						result.height = image.height;
+						result.format = int_format::TEXTURE_COLOR;
+						result.block_bytes = int_format::BLOCK_BYTES;
+						result.data.resize(compressedSize(image.width, image.height, int_format::BLOCK_BYTES));
+						const GLsizei blocks_x = (image.width+3)/4;
+						const GLsizei blocks_y = (image.height+3)/4;
+						pool.parallelFor(blocks_y, [&](std::size_t by)
+								{
+								Block block;
+								GLubyte* out = &result.data[by*blocks_x*int_format::BLOCK_BYTES];
+								for(GLsizei bx = 0; bx < blocks_x; bx++)
+								{
+									fetchBlock(image, bx, by, block);
+									if(int_format::BLOCK_BYTES == 16)
+									{
+										encodeAlpha(block, out);
+										out += 8;
+									}
+									encodeColor(block, out);
+									out += 8;
+								}
+								});
+						return result;
+					}
+
+				//RGBA pixels of the blocks (for the check, or when S3TC is not supported)
+				static ImageData decode(const CompressedImage &image)
+				{
+					ImageData result;
+					result.width = image.width;
+					result.height = image.height;
+					result.channels = 4;
+					result.pixels.resize(static_cast<std::size_t>(image.width)*image.height*4);
+					const GLsizei blocks_x = (image.width+3)/4;
+					const GLsizei blocks_y = (image.height+3)/4;
+					const bool has_alpha = (image.block_bytes == 16);
+					Block block;
+					const GLubyte* in = image.data.data();
+					for(GLsizei by = 0; by < blocks_y; by++)
+					{
+						for(GLsizei bx = 0; bx < blocks_x; bx++)
+						{
+							decodeColor(in + (has_alpha ? 8 : 0), block, 16, has_alpha);
+							if(has_alpha)
+								decodeAlpha(in, block, 16);
+							in += image.block_bytes;
+							//copy the part inside the image
+							for(GLsizei y = 0; y < 4 && by*4+y < image.height; y++)
+							{
+								const GLsizei width = std::min<GLsizei>(4, image.width-bx*4);
+								std::memcpy(&result.pixels[(static_cast<std::size_t>(by*4+y)*image.width + bx*4)*4], block+y*16, width*4);
+							}
+						}
+					}
+					return result;
+				}
+		};
+	}
+}
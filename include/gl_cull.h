@@ -0,0 +1,383 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cmath>
+#include <vector>
+#include <algorithm>
+#include <glm/glm.hpp>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+#ifdef __AVX__
+#include <immintrin.h>
+#endif
+#include "gl_thread.h"
+
+namespace jikoLib{
+	namespace GLLib{
+
+		struct BoundingBox
+		{
+			glm::vec3 min;
+			glm::vec3 max;
+
+			BoundingBox() :min(0.0f), max(0.0f) {}
+			BoundingBox(const glm::vec3 &min, const glm::vec3 &max) :min(min), max(max) {}
+
+			inline glm::vec3 getCenter() const
+			{
+				return (min+max)*0.5f;
+			}
+
+			//half of the size
+			inline glm::vec3 getExtent() const
+			{
+				return (max-min)*0.5f;
+			}
+
+			//the box around the transformed box (the extent is |matrix|*extent)
+			BoundingBox transformed(const glm::mat4 &matrix) const
+			{
+				const glm::vec3 center = glm::vec3(matrix*glm::vec4(getCenter(), 1.0f));
+				const glm::vec3 extent = getExtent();
+				glm::vec3 new_extent;
+				for(int r = 0; r < 3; r++)
+					new_extent[r] = std::fabs(matrix[0][r])*extent.x + std::fabs(matrix[1][r])*extent.y + std::fabs(matrix[2][r])*extent.z;
+				return BoundingBox(center-new_extent, center+new_extent);
+			}
+		};
+
+		struct BoundingSphere
+		{
+			glm::vec3 center;
+			float radius;
+
+			BoundingSphere() :center(0.0f), radius(0.0f) {}
+			BoundingSphere(const glm::vec3 &center, float radius) :center(center), radius(radius) {}
+
+			//the radius is scaled by the longest axis
+			BoundingSphere transformed(const glm::mat4 &matrix) const
+			{
+				const float scale = std::max(glm::length(glm::vec3(matrix[0])), std::max(glm::length(glm::vec3(matrix[1])), glm::length(glm::vec3(matrix[2]))));
+				return BoundingSphere(glm::vec3(matrix*glm::vec4(center, 1.0f)), radius*scale);
+			}
+		};
+
+		//box and sphere (around the center of the box) of count positions, stride floats apart
+		template<typename T>
+			void computeBounds(const T *positions, std::size_t count, std::size_t stride, BoundingBox &box, BoundingSphere &sphere)
+			{
+				if(count == 0)
+				{
+					box = BoundingBox();
+					sphere = BoundingSphere();
+					return;
+				}
+				glm::vec3 min(positions[0], positions[1], positions[2]);
+				glm::vec3 max = min;
+				for(std::size_t i = 1; i < count; i++)
+				{
+					const T* p = positions+i*stride;
+					const glm::vec3 pos(p[0], p[1], p[2]);
+					min = glm::min(min, pos);
+					max = glm::max(max, pos);
+				}
+				box = BoundingBox(min, max);
+				const glm::vec3 center = box.getCenter();
+				float radius2 = 0.0f;
+				for(std::size_t i = 0; i < count; i++)
+				{
+					const T* p = positions+i*stride;
+					const glm::vec3 d = glm::vec3(p[0], p[1], p[2])-center;
+					radius2 = std::max(radius2, glm::dot(d, d));
+				}
+				sphere = BoundingSphere(center, std::sqrt(radius2));
+			}
+
+		/**
+		 * Frustum
+		 * 6 planes (left, right, bottom, top, near, far) from a projection*view matrix.
+		 * the normals point inside and are normalized, so plane.xyz*p+plane.w is the distance.
+		 * "Frustum frustum(camera.getProjectionMatrix()*camera.getViewMatrix());" (or camera.getFrustum())
+		 *
+		 */
+
+		class Frustum
+		{
+			public:
+				enum Plane
+				{
+					LEFT,
+					RIGHT,
+					BOTTOM,
+					TOP,
+					ZNEAR,
+					ZFAR,
+					NUM_PLANES
+				};
+
+			private:
+				glm::vec4 planes[NUM_PLANES];
+
+			public:
+				Frustum() {}
+
+				explicit Frustum(const glm::mat4 &view_proj)
+				{
+					set(view_proj);
+				}
+
+				void set(const glm::mat4 &view_proj)
+				{
+					//rows of the matrix (glm is column major)
+					glm::vec4 rows[4];
+					for(int r = 0; r < 4; r++)
+						rows[r] = glm::vec4(view_proj[0][r], view_proj[1][r], view_proj[2][r], view_proj[3][r]);
+					planes[LEFT]   = rows[3]+rows[0];
+					planes[RIGHT]  = rows[3]-rows[0];
+					planes[BOTTOM] = rows[3]+rows[1];
+					planes[TOP]    = rows[3]-rows[1];
+					planes[ZNEAR]  = rows[3]+rows[2];
+					planes[ZFAR]   = rows[3]-rows[2];
+					for(auto&& plane : planes)
+						plane = plane*(1.0f/glm::length(glm::vec3(plane)));
+				}
+
+				inline const glm::vec4& getPlane(std::size_t i) const
+				{
+					return planes[i];
+				}
+
+				//false only if the sphere is completely outside of a plane
+				inline bool isVisible(const BoundingSphere &sphere) const
+				{
+					for(auto&& plane : planes)
+					{
+						if(plane.x*sphere.center.x + plane.y*sphere.center.y + plane.z*sphere.center.z + plane.w + sphere.radius < 0.0f)
+							return false;
+					}
+					return true;
+				}
+
+				inline bool isVisible(const BoundingBox &box) const
+				{
+					const glm::vec3 center = box.getCenter();
+					const glm::vec3 extent = box.getExtent();
+					for(auto&& plane : planes)
+					{
+						const float distance = plane.x*center.x + plane.y*center.y + plane.z*center.z + plane.w;
+						const float radius = std::fabs(plane.x)*extent.x + std::fabs(plane.y)*extent.y + std::fabs(plane.z)*extent.z;
+						if(distance + radius < 0.0f)
+							return false;
+					}
+					return true;
+				}
+		};
+
+		/**
+		 * CullBatch
+		 * bounds of many objects (world space, SoA) tested against a Frustum 4 (SSE) or 8 (AVX) at once.
+		 * cull() writes the indices of the visible ones in ascending order. a box is stored as center and extent
+		 * with the radius of the sphere around it, and a sphere as a box of the same radius, so both tests work for both.
+		 *
+		 */
+
+		class CullBatch
+		{
+			public:
+				enum Test
+				{
+					SPHERE,
+					BOX
+				};
+
+			private:
+				//objects per block (the arrays are padded to it)
+				constexpr static std::size_t BLOCK = 8;
+				//blocks per task of the pool
+				constexpr static std::size_t TASK_BLOCKS = 2048;
+
+				std::size_t count = 0;
+				std::vector<float> cx, cy, cz;
+				std::vector<float> ex, ey, ez;
+				std::vector<float> radius;
+
+				//objects [begin, end) (multiples of the block)
+				template<Test test>
+					void cullRange(const Frustum &frustum, std::size_t begin, std::size_t end, std::vector<std::uint32_t> &visible) const
+					{
+#if defined(__AVX__)
+						__m256 nx[Frustum::NUM_PLANES], ny[Frustum::NUM_PLANES], nz[Frustum::NUM_PLANES], nw[Frustum::NUM_PLANES];
+						__m256 ax[Frustum::NUM_PLANES], ay[Frustum::NUM_PLANES], az[Frustum::NUM_PLANES];
+						for(std::size_t p = 0; p < Frustum::NUM_PLANES; p++)
+						{
+							const glm::vec4 &plane = frustum.getPlane(p);
+							nx[p] = _mm256_set1_ps(plane.x);
+							ny[p] = _mm256_set1_ps(plane.y);
+							nz[p] = _mm256_set1_ps(plane.z);
+							nw[p] = _mm256_set1_ps(plane.w);
+							ax[p] = _mm256_set1_ps(std::fabs(plane.x));
+							ay[p] = _mm256_set1_ps(std::fabs(plane.y));
+							az[p] = _mm256_set1_ps(std::fabs(plane.z));
+						}
+						const __m256 zero = _mm256_setzero_ps();
+						for(std::size_t i = begin; i < end; i += 8)
+						{
+							const __m256 x = _mm256_loadu_ps(&cx[i]), y = _mm256_loadu_ps(&cy[i]), z = _mm256_loadu_ps(&cz[i]);
+							__m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+							for(std::size_t p = 0; p < Frustum::NUM_PLANES; p++)
+							{
+								const __m256 distance = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(nx[p], x), _mm256_mul_ps(ny[p], y)), _mm256_mul_ps(nz[p], z)), nw[p]);
+								const __m256 r = (test == SPHERE) ? _mm256_loadu_ps(&radius[i]) :
+									_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(ax[p], _mm256_loadu_ps(&ex[i])), _mm256_mul_ps(ay[p], _mm256_loadu_ps(&ey[i]))), _mm256_mul_ps(az[p], _mm256_loadu_ps(&ez[i])));
+								inside = _mm256_and_ps(inside, _mm256_cmp_ps(_mm256_add_ps(distance, r), zero, _CMP_GE_OQ));
+							}
+							for(unsigned int mask = _mm256_movemask_ps(inside); mask != 0; mask &= mask-1)
+								visible.push_back(i + __builtin_ctz(mask));
+						}
+#elif defined(__SSE2__)
+						__m128 nx[Frustum::NUM_PLANES], ny[Frustum::NUM_PLANES], nz[Frustum::NUM_PLANES], nw[Frustum::NUM_PLANES];
+						__m128 ax[Frustum::NUM_PLANES], ay[Frustum::NUM_PLANES], az[Frustum::NUM_PLANES];
+						for(std::size_t p = 0; p < Frustum::NUM_PLANES; p++)
+						{
+							const glm::vec4 &plane = frustum.getPlane(p);
+							nx[p] = _mm_set1_ps(plane.x);
+							ny[p] = _mm_set1_ps(plane.y);
+							nz[p] = _mm_set1_ps(plane.z);
+							nw[p] = _mm_set1_ps(plane.w);
+							ax[p] = _mm_set1_ps(std::fabs(plane.x));
+							ay[p] = _mm_set1_ps(std::fabs(plane.y));
+							az[p] = _mm_set1_ps(std::fabs(plane.z));
+						}
+						const __m128 zero = _mm_setzero_ps();
+						for(std::size_t i = begin; i < end; i += 4)
+						{
+							const __m128 x = _mm_loadu_ps(&cx[i]), y = _mm_loadu_ps(&cy[i]), z = _mm_loadu_ps(&cz[i]);
+							__m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+							for(std::size_t p = 0; p < Frustum::NUM_PLANES; p++)
+							{
+								const __m128 distance = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(nx[p], x), _mm_mul_ps(ny[p], y)), _mm_mul_ps(nz[p], z)), nw[p]);
+								const __m128 r = (test == SPHERE) ? _mm_loadu_ps(&radius[i]) :
+									_mm_add_ps(_mm_add_ps(_mm_mul_ps(ax[p], _mm_loadu_ps(&ex[i])), _mm_mul_ps(ay[p], _mm_loadu_ps(&ey[i]))), _mm_mul_ps(az[p], _mm_loadu_ps(&ez[i])));
+								inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(distance, r), zero));
+							}
+							for(unsigned int mask = _mm_movemask_ps(inside); mask != 0; mask &= mask-1)
+								visible.push_back(i + __builtin_ctz(mask));
+						}
+#else
+						for(std::size_t i = begin; i < end; i++)
+						{
+							const bool inside = (test == SPHERE) ?
+								frustum.isVisible(BoundingSphere(glm::vec3(cx[i], cy[i], cz[i]), radius[i])) :
+								frustum.isVisible(BoundingBox(glm::vec3(cx[i]-ex[i], cy[i]-ey[i], cz[i]-ez[i]), glm::vec3(cx[i]+ex[i], cy[i]+ey[i], cz[i]+ez[i])));
+							if(inside)
+								visible.push_back(i);
+						}
+#endif
+						//the padding of the last block
+						while(!visible.empty() && visible.back() >= count)
+							visible.pop_back();
+					}
+
+				template<Test test>
+					void cullAll(const Frustum &frustum, std::vector<std::uint32_t> &visible, ThreadPool &pool) const
+					{
+						const std::size_t blocks = (count+BLOCK-1)/BLOCK;
+						const std::size_t tasks = (blocks+TASK_BLOCKS-1)/TASK_BLOCKS;
+						visible.clear();
+						if(tasks <= 1)
+						{
+							cullRange<test>(frustum, 0, blocks*BLOCK, visible);
+							return;
+						}
+						std::vector<std::vector<std::uint32_t>> parts(tasks);
+						pool.parallelFor(tasks, [&](std::size_t t)
+								{
+								cullRange<test>(frustum, t*TASK_BLOCKS*BLOCK, std::min(blocks, (t+1)*TASK_BLOCKS)*BLOCK, parts[t]);
+								});
+						std::size_t total = 0;
+						for(auto&& part : parts)
+							total += part.size();
+						visible.reserve(total);
+						for(auto&& part : parts)
+							visible.insert(visible.end(), part.begin(), part.end());
+					}
+
+			public:
+				CullBatch() {}
+
+				explicit CullBatch(std::size_t num)
+				{
+					resize(num);
+				}
+
+				//new bounds are empty points at the origin
+				void resize(std::size_t num)
+				{
+					count = num;
+					const std::size_t padded = (num+BLOCK-1)/BLOCK*BLOCK;
+					for(auto&& v : {&cx, &cy, &cz, &ex, &ey, &ez, &radius})
+						v->resize(padded, 0.0f);
+				}
+
+				inline std::size_t size() const
+				{
+					return count;
+				}
+
+				//returns the index
+				template<typename Bounds>
+					std::size_t add(const Bounds &bounds)
+					{
+						resize(count+1);
+						set(count-1, bounds);
+						return count-1;
+					}
+
+				inline void set(std::size_t i, const BoundingBox &box)
+				{
+					const glm::vec3 center = box.getCenter();
+					const glm::vec3 extent = box.getExtent();
+					cx[i] = center.x;
+					cy[i] = center.y;
+					cz[i] = center.z;
+					ex[i] = extent.x;
+					ey[i] = extent.y;
+					ez[i] = extent.z;
+					radius[i] = glm::length(extent);
+				}
+
+				inline void set(std::size_t i, const BoundingSphere &sphere)
+				{
+					cx[i] = sphere.center.x;
+					cy[i] = sphere.center.y;
+					cz[i] = sphere.center.z;
+					ex[i] = ey[i] = ez[i] = sphere.radius;
+					radius[i] = sphere.radius;
+				}
+
+				inline BoundingBox getBox(std::size_t i) const
+				{
+					const glm::vec3 center(cx[i], cy[i], cz[i]);
+					const glm::vec3 extent(ex[i], ey[i], ez[i]);
+					return BoundingBox(center-extent, center+extent);
+				}
+
+				inline BoundingSphere getSphere(std::size_t i) const
+				{
+					return BoundingSphere(glm::vec3(cx[i], cy[i], cz[i]), radius[i]);
+				}
+
+				//indices of the objects not outside of the frustum (ascending). returns the number of them
+				std::size_t cull(const Frustum &frustum, std::vector<std::uint32_t> &visible, Test test = BOX, ThreadPool &pool = ThreadPool::getDefault()) const
+				{
+					if(test == SPHERE)
+						cullAll<SPHERE>(frustum, visible, pool);
+					else
+						cullAll<BOX>(frustum, visible, pool);
+					return visible.size();
+				}
+		};
+	}
+}
@@ -0,0 +1,157 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <iostream>
+#include <algorithm>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace jikoLib{
+	namespace GLLib{
+
+		/**
+		 * MappedFile
+		 * read only memory mapping of a whole file.
+		 *
+		 */
+
+		class MappedFile
+		{
+			private:
+				void* map = nullptr;
+				std::size_t map_size = 0;
+
+			public:
+				MappedFile() {}
+
+				explicit MappedFile(const std::string &path)
+				{
+					open(path);
+				}
+
+				~MappedFile()
+				{
+					close();
+				}
+
+				MappedFile(const MappedFile&) = delete;
+				MappedFile& operator=(const MappedFile&) = delete;
+
+				//returns false if the file cannot be mapped (an empty file too)
+				bool open(const std::string &path)
+				{
+					close();
+					int fd = ::open(path.c_str(), O_RDONLY);
+					if(fd == -1)
+						return false;
+					struct stat st;
+					if(fstat(fd, &st) != 0 || st.st_size <= 0)
+					{
+						::close(fd);
+						return false;
+					}
+					map_size = st.st_size;
+					map = mmap(nullptr, map_size, PROT_READ, MAP_PRIVATE, fd, 0);
+					//the mapping stays valid after close
+					::close(fd);
+					if(map == MAP_FAILED)
+					{
+						map = nullptr;
+						map_size = 0;
+						return false;
+					}
+					//read front to back
+					madvise(map, map_size, MADV_SEQUENTIAL);
+					return true;
+				}
+
+				void close()
+				{
+					if(map != nullptr)
+						munmap(map, map_size);
+					map = nullptr;
+					map_size = 0;
+				}
+
+				inline bool isOpen() const
+				{
+					return map != nullptr;
+				}
+
+				inline const char* data() const
+				{
+					return static_cast<const char*>(map);
+				}
+
+				inline std::size_t size() const
+				{
+					return map_size;
+				}
+
+				//count elements of elem_size at offset are inside the mapping (checked without overflow)
+				inline bool contains(std::uint64_t offset, std::uint64_t count, std::size_t elem_size = 1) const
+				{
+					return offset <= map_size && count <= (map_size-offset)/elem_size;
+				}
+		};
+
+		//write path through path + ".tmp" renamed over it, so a reader never maps a half written file.
+		//write_func(std::ostream&) writes the contents. returns false (and removes the temporary file) on failure
+		template<typename WriteFunc>
+			bool writeFileAtomic(const std::string &path, WriteFunc write_func)
+			{
+				const std::string temp_path = path + ".tmp";
+				std::ofstream out(temp_path, std::ios::binary | std::ios::trunc);
+				if(!out)
+				{
+					std::cerr << "cannot write " << temp_path << std::endl;
+					return false;
+				}
+				write_func(out);
+				out.close();
+				if(!out)
+				{
+					std::cerr << "cannot write " << temp_path << std::endl;
+					std::remove(temp_path.c_str());
+					return false;
+				}
+				if(std::rename(temp_path.c_str(), path.c_str()) != 0)
+				{
+					std::cerr << "cannot rename " << temp_path << " to " << path << std::endl;
+					std::remove(temp_path.c_str());
+					return false;
+				}
+				return true;
+			}
+
+		//newest mtime and total size of the source files (stored by the caches to detect a stale cache).
+		//returns false if a file cannot be found
+		inline bool sourceStat(const std::vector<std::string> &sources, std::int64_t &mtime, std::uint64_t &size)
+		{
+			mtime = 0;
+			size = 0;
+			for(auto&& source : sources)
+			{
+				struct stat st;
+				if(stat(source.c_str(), &st) != 0)
+					return false;
+				mtime = std::max<std::int64_t>(mtime, st.st_mtime);
+				size += st.st_size;
+			}
+			return true;
+		}
+
+		inline bool sourceStat(const std::string &source, std::int64_t &mtime, std::uint64_t &size)
+		{
+			return sourceStat(std::vector<std::string>(1, source), mtime, size);
+		}
+	}
+}
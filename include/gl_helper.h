@@ -2,6 +2,9 @@
 
 #include <GL/glew.h>
 #include "gl_debug.h"
+#include "gl_state.h"
+#include "gl_image.h"
+#include "gl_thread.h"
 #include <functional>
 #include <vector>
 #include <array>
@@ -10,6 +13,10 @@
 #include <IL/il.h>
 #include <IL/ilu.h>
 #include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
 
 
 namespace jikoLib
@@ -253,8 +260,16 @@ namespace jikoLib
 		template<>
 			struct GLAllocTraits<Alloc_ShaderProg>
 			{
+				static void my_glDeleteProgram(GLuint id)
+				{
+					BindState::current().onDeleteProgram(id);
+					glDeleteProgram(id);
+				}
+
+				using deallocfunc_t = void(*)(GLuint);
+
 				constexpr static auto& allocfunc = glCreateProgram; 
-				constexpr static auto& deallocfunc = glDeleteProgram; 
+				constexpr static deallocfunc_t deallocfunc = &my_glDeleteProgram; 
 			};
 
 		template<>
@@ -269,6 +284,7 @@ namespace jikoLib
 
 				static void my_glDeleteBuffers(GLuint id)
 				{
+					BindState::current().onDeleteBuffer(id);
 					glDeleteBuffers(1, &id);
 				}
 
@@ -292,6 +308,7 @@ namespace jikoLib
 
 				static void my_glDeleteVertexArrays(GLuint id)
 				{
+					BindState::current().onDeleteVertexArray(id);
 					glDeleteVertexArrays(1, &id);
 				}
 
@@ -315,6 +332,7 @@ namespace jikoLib
 
 				static void my_glDeleteTextures(GLuint id)
 				{
+					BindState::current().onDeleteTexture(id);
 					glDeleteTextures(1, &id);
 				}
 
@@ -337,6 +355,7 @@ namespace jikoLib
 
 				static void my_glDeleteFramebuffers(GLuint id)
 				{
+					BindState::current().onDeleteFramebuffer(id);
 					glDeleteFramebuffers(1, &id);
 				}
 
@@ -359,6 +378,7 @@ namespace jikoLib
 
 				static void my_glDeleteRenderbuffers(GLuint id)
 				{
+					BindState::current().onDeleteRenderbuffer(id);
 					glDeleteRenderbuffers(1, &id);
 				}
 
@@ -448,6 +468,131 @@ namespace jikoLib
 
 		struct link_these{};
 
+		/**
+		 * fixed attribute locations of Mesh3D
+		 */
+
+		struct AttribLocation
+		{
+			constexpr static GLuint VERTEX = 0;
+			constexpr static GLuint NORMAL = 1;
+			constexpr static GLuint TEXCRD = 2;
+			//first location of the per-instance attributes (mat4 takes 4 locations)
+			constexpr static GLuint INSTANCE = 3;
+		};
+
+		/**
+		 * interleaved vertex
+		 * VertexTraits<VertexType>::attrib describes the members of VertexType
+		 * (location, dimension and offset). specialize it for user defined vertex.
+		 */
+
+		template<GLuint location, std::size_t dim, std::size_t offset>
+			struct VertexMember
+			{
+				constexpr static GLuint LOCATION = location;
+				constexpr static std::size_t DIM = dim;
+				constexpr static std::size_t OFFSET = offset;
+			};
+
+		//set attribute pointers of the bound array buffer
+		template<typename VertexType, typename... Members>
+			struct VertexAttribTraits{};
+
+		template<typename VertexType, typename First, typename... Rests>
+			struct VertexAttribTraits<VertexType, First, Rests...>
+			{
+				inline static void func()
+				{
+					glVertexAttribPointer(First::LOCATION, First::DIM, GL_FLOAT, GL_FALSE, sizeof(VertexType), reinterpret_cast<const GLvoid*>(First::OFFSET));
+					CHECK_GL_ERROR;
+					glEnableVertexAttribArray(First::LOCATION);
+					CHECK_GL_ERROR;
+					VertexAttribTraits<VertexType, Rests...>::func();
+				}
+			};
+
+		template<typename VertexType>
+			struct VertexAttribTraits<VertexType>
+			{
+				inline static void func(){}
+			};
+
+		template<typename VertexType>
+			struct VertexTraits{};
+
+		//vertex, normal, texcrd
+		struct VertexPNT
+		{
+			GLfloat vertex[3];
+			GLfloat normal[3];
+			GLfloat texcrd[2];
+		};
+
+		template<>
+			struct VertexTraits<VertexPNT>
+			{
+				using attrib = VertexAttribTraits<VertexPNT,
+						VertexMember<AttribLocation::VERTEX, 3, offsetof(VertexPNT, vertex)>,
+						VertexMember<AttribLocation::NORMAL, 3, offsetof(VertexPNT, normal)>,
+						VertexMember<AttribLocation::TEXCRD, 2, offsetof(VertexPNT, texcrd)>>;
+			};
+
+		//vertex, normal
+		struct VertexPN
+		{
+			GLfloat vertex[3];
+			GLfloat normal[3];
+		};
+
+		template<>
+			struct VertexTraits<VertexPN>
+			{
+				using attrib = VertexAttribTraits<VertexPN,
+						VertexMember<AttribLocation::VERTEX, 3, offsetof(VertexPN, vertex)>,
+						VertexMember<AttribLocation::NORMAL, 3, offsetof(VertexPN, normal)>>;
+			};
+
+		/**
+		 * vertex layout for ShaderProg
+		 * binds the attribute names of the shader to the fixed locations (before link).
+		 * "program << vshader << fshader << VertexLayout("vertex", "normal", "texcrd") << link_these();"
+		 */
+
+		class VertexLayout
+		{
+			private:
+				std::vector<std::pair<GLuint, std::string>> attribs;
+
+			public:
+				VertexLayout() {}
+
+				VertexLayout(const std::string &vertex, const std::string &normal, const std::string &texcrd = "")
+				{
+					attrib(AttribLocation::VERTEX, vertex);
+					attrib(AttribLocation::NORMAL, normal);
+					if(texcrd != "")
+						attrib(AttribLocation::TEXCRD, texcrd);
+				}
+
+				inline VertexLayout& attrib(GLuint location, const std::string &name)
+				{
+					attribs.push_back(std::make_pair(location, name));
+					return *this;
+				}
+
+				//per-instance attribute at AttribLocation::INSTANCE + offset
+				inline VertexLayout& instance(const std::string &name, GLuint offset = 0)
+				{
+					return attrib(AttribLocation::INSTANCE + offset, name);
+				}
+
+				inline const std::vector<std::pair<GLuint, std::string>>& getAttribs() const
+				{
+					return attribs;
+				}
+		};
+
 		/**
 		 * Target_Type for VertexBuffer
 		 */
@@ -462,13 +607,53 @@ namespace jikoLib
 			constexpr static GLenum BUFFER_TARGET = GL_ELEMENT_ARRAY_BUFFER;
 		};
 
+		struct UniformBufferTarget //for UBO
+		{
+			constexpr static GLenum BUFFER_TARGET = GL_UNIFORM_BUFFER;
+		};
+
+		struct DrawIndirectBuffer //for glMultiDrawElementsIndirect
+		{
+			constexpr static GLenum BUFFER_TARGET = GL_DRAW_INDIRECT_BUFFER;
+		};
+
+		struct PixelUnpackBuffer //for PBO (texture upload)
+		{
+			constexpr static GLenum BUFFER_TARGET = GL_PIXEL_UNPACK_BUFFER;
+		};
+
+		//layout of the command read by glDrawElementsIndirect
+		struct DrawElementsIndirectCommand
+		{
+			GLuint count;
+			GLuint instanceCount;
+			GLuint firstIndex;
+			GLint baseVertex;
+			GLuint baseInstance;
+		};
+
 		/**
 		 * Usage_Type for VertexBuffer
 		 */
 
+		//BUFFER_REUSE: copyData of the same size overwrites the storage instead of reallocating
+
 		struct StaticDraw
 		{
 			constexpr static GLenum BUFFER_USAGE = GL_STATIC_DRAW;
+			constexpr static bool BUFFER_REUSE = false;
+		};
+
+		struct DynamicDraw //modified repeatedly
+		{
+			constexpr static GLenum BUFFER_USAGE = GL_DYNAMIC_DRAW;
+			constexpr static bool BUFFER_REUSE = true;
+		};
+
+		struct StreamDraw //respecified every frame (glBufferData orphans the old storage)
+		{
+			constexpr static GLenum BUFFER_USAGE = GL_STREAM_DRAW;
+			constexpr static bool BUFFER_REUSE = false;
 		};
 
 		/**
@@ -582,6 +767,237 @@ namespace jikoLib
 				constexpr static auto& func = glUniformMatrix4fv;
 			};
 
+		template<std::size_t size, typename Type>
+			struct glProgramUniformXt{};
+		template<>
+			struct glProgramUniformXt<1,GLint>
+			{
+				constexpr static auto& func = glProgramUniform1i;
+			};
+		template<>
+			struct glProgramUniformXt<2,GLint>
+			{
+				constexpr static auto& func = glProgramUniform2i;
+			};
+		template<>
+			struct glProgramUniformXt<3,GLint>
+			{
+				constexpr static auto& func = glProgramUniform3i;
+			};
+		template<>
+			struct glProgramUniformXt<4,GLint>
+			{
+				constexpr static auto& func = glProgramUniform4i;
+			};
+		template<>
+			struct glProgramUniformXt<1,GLfloat>
+			{
+				constexpr static auto& func = glProgramUniform1f;
+			};
+		template<>
+			struct glProgramUniformXt<2,GLfloat>
+			{
+				constexpr static auto& func = glProgramUniform2f;
+			};
+		template<>
+			struct glProgramUniformXt<3,GLfloat>
+			{
+				constexpr static auto& func = glProgramUniform3f;
+			};
+		template<>
+			struct glProgramUniformXt<4,GLfloat>
+			{
+				constexpr static auto& func = glProgramUniform4f;
+			};
+
+
+		template<std::size_t size, typename Type>
+			struct glProgramUniformXtv{};
+		template<>
+			struct glProgramUniformXtv<1,GLint>
+			{
+				constexpr static auto& func = glProgramUniform1iv;
+			};
+		template<>
+			struct glProgramUniformXtv<2,GLint>
+			{
+				constexpr static auto& func = glProgramUniform2iv;
+			};
+		template<>
+			struct glProgramUniformXtv<3,GLint>
+			{
+				constexpr static auto& func = glProgramUniform3iv;
+			};
+		template<>
+			struct glProgramUniformXtv<4,GLint>
+			{
+				constexpr static auto& func = glProgramUniform4iv;
+			};
+		template<>
+			struct glProgramUniformXtv<1,GLfloat>
+			{
+				constexpr static auto& func = glProgramUniform1fv;
+			};
+		template<>
+			struct glProgramUniformXtv<2,GLfloat>
+			{
+				constexpr static auto& func = glProgramUniform2fv;
+			};
+		template<>
+			struct glProgramUniformXtv<3,GLfloat>
+			{
+				constexpr static auto& func = glProgramUniform3fv;
+			};
+		template<>
+			struct glProgramUniformXtv<4,GLfloat>
+			{
+				constexpr static auto& func = glProgramUniform4fv;
+			};
+
+
+		template<std::size_t size, typename Type>
+			struct glProgramUniformMatrixXtv{};
+		template<>
+			struct glProgramUniformMatrixXtv<2,GLfloat>
+			{
+				constexpr static auto& func = glProgramUniformMatrix2fv;
+			};
+		template<>
+			struct glProgramUniformMatrixXtv<3,GLfloat>
+			{
+				constexpr static auto& func = glProgramUniformMatrix3fv;
+			};
+		template<>
+			struct glProgramUniformMatrixXtv<4,GLfloat>
+			{
+				constexpr static auto& func = glProgramUniformMatrix4fv;
+			};
+
+		/**
+		 * uniform name hash (FNV-1a)
+		 *
+		 */
+
+		constexpr std::uint32_t uniformHash(const char* str, std::uint32_t hash = 2166136261u)
+		{
+			return (*str == '\0') ? hash : uniformHash(str+1, (hash ^ static_cast<unsigned char>(*str)) * 16777619u);
+		}
+
+		// key for ShaderProg::setUniform*.
+		// "constexpr UniformName u_model("model");" hashes the name at compile time.
+		struct UniformName
+		{
+			std::uint32_t hash;
+			const char* name;
+
+			constexpr UniformName(const char* name) :hash(uniformHash(name)), name(name){}
+			UniformName(const std::string &name) :hash(uniformHash(name.c_str())), name(name.c_str()){}
+		};
+
+		/**
+		 * std140 layout traits for uniform block
+		 * ALIGN is the base alignment and SIZE is the size of the member in bytes.
+		 * write() stores the value in std140 layout.
+		 * (glm types are in gl_3D.h)
+		 */
+
+		template<typename T>
+			struct Std140{};
+
+		template<typename T>
+			struct Std140Scalar
+			{
+				constexpr static std::size_t ALIGN = 4;
+				constexpr static std::size_t SIZE = 4;
+				inline static void write(GLubyte* dst, const T &value)
+				{
+					std::memcpy(dst, &value, SIZE);
+				}
+			};
+
+		template<>
+			struct Std140<GLfloat> : public Std140Scalar<GLfloat>{};
+		template<>
+			struct Std140<GLint> : public Std140Scalar<GLint>{};
+		template<>
+			struct Std140<GLuint> : public Std140Scalar<GLuint>{};
+
+		//bool is 4 bytes in std140
+		template<>
+			struct Std140<bool>
+			{
+				constexpr static std::size_t ALIGN = 4;
+				constexpr static std::size_t SIZE = 4;
+				inline static void write(GLubyte* dst, const bool &value)
+				{
+					Std140<GLuint>::write(dst, value ? 1u : 0u);
+				}
+			};
+
+		/**
+		 * std140 offset calculator
+		 * push the members in the order of the declaration in the uniform block.
+		 * each push returns the offset of the member.
+		 *
+		 */
+
+		class Std140Layout
+		{
+			private:
+				std::size_t offset = 0;
+
+			public:
+				constexpr static std::size_t VEC4_ALIGN = 16;
+
+				inline static std::size_t alignUp(std::size_t value, std::size_t align)
+				{
+					return (value + align - 1) / align * align;
+				}
+
+				template<typename T>
+					inline static std::size_t arrayStride()
+					{
+						//array element is aligned to vec4
+						return alignUp(Std140<T>::SIZE, VEC4_ALIGN);
+					}
+
+				template<typename T>
+					std::size_t push()
+					{
+						offset = alignUp(offset, Std140<T>::ALIGN);
+						std::size_t result = offset;
+						offset += Std140<T>::SIZE;
+						return result;
+					}
+
+				template<typename T>
+					std::size_t pushArray(std::size_t num)
+					{
+						offset = alignUp(offset, VEC4_ALIGN);
+						std::size_t result = offset;
+						offset += arrayStride<T>()*num;
+						return result;
+					}
+
+				//struct member: begin and end are aligned to vec4
+				inline std::size_t beginStruct()
+				{
+					offset = alignUp(offset, VEC4_ALIGN);
+					return offset;
+				}
+
+				inline void endStruct()
+				{
+					offset = alignUp(offset, VEC4_ALIGN);
+				}
+
+				//size of the block (GL_UNIFORM_BLOCK_DATA_SIZE)
+				inline std::size_t size() const
+				{
+					return alignUp(offset, VEC4_ALIGN);
+				}
+		};
+
 		/**
 		 * render mode
 		 *
@@ -618,6 +1034,11 @@ namespace jikoLib
 			constexpr static GLenum TEXTURE_TARGET = GL_TEXTURE_3D;
 		};
 
+		struct Texture2DArray
+		{
+			constexpr static GLenum TEXTURE_TARGET = GL_TEXTURE_2D_ARRAY;
+		};
+
 		struct TextureCubeMap
 		{
 			constexpr static GLenum TEXTURE_TARGET = GL_TEXTURE_CUBE_MAP;
@@ -671,6 +1092,8 @@ namespace jikoLib
 		{
 			constexpr static GLenum TEXTURE_COLOR = GL_RGB;
 			constexpr static std::size_t ALIGN = 1;
+			constexpr static std::size_t CHANNELS = 3;
+			constexpr static std::size_t BLOCK_BYTES = 0;
 			constexpr static ILenum IL_COLOR = IL_RGB;
 		};
 
@@ -678,9 +1101,32 @@ namespace jikoLib
 		{
 			constexpr static GLenum TEXTURE_COLOR = GL_RGBA;
 			constexpr static std::size_t ALIGN = 4;
+			constexpr static std::size_t CHANNELS = 4;
+			constexpr static std::size_t BLOCK_BYTES = 0;
 			constexpr static ILenum IL_COLOR = IL_RGBA;
 		};
 
+		/**
+		 * block compressed (S3TC) internal formats. 4x4 pixels per block
+		 * BC1: RGB, 8 bytes per block (6:1 to RGB)
+		 * BC3: RGBA, 16 bytes per block (4:1 to RGBA)
+		 *
+		 */
+
+		struct BC1
+		{
+			constexpr static GLenum TEXTURE_COLOR = GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+			constexpr static std::size_t CHANNELS = 3;
+			constexpr static std::size_t BLOCK_BYTES = 8;
+		};
+
+		struct BC3
+		{
+			constexpr static GLenum TEXTURE_COLOR = GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+			constexpr static std::size_t CHANNELS = 4;
+			constexpr static std::size_t BLOCK_BYTES = 16;
+		};
+
 		struct DepthComponent
 		{
 			constexpr static GLenum TEXTURE_COLOR = GL_DEPTH_COMPONENT;
@@ -726,6 +1172,7 @@ namespace jikoLib
 			{
 				static void texImage2D(const std::string &path)
 				{
+					std::lock_guard<std::mutex> lock(devILMutex());
 					ILuint imgID;
 					ilGenImages(1, &imgID);
 					ilBindImage(imgID);
@@ -749,6 +1196,14 @@ namespace jikoLib
 					ilDeleteImages(1, &imgID);
 				}
 
+				//blocks made by BlockCompressor (int_format: BC1, BC3)
+				static void compressedTexImage2D(GLsizei width, GLsizei height, GLsizei size, const GLvoid* data)
+				{
+					static_assert(int_format::BLOCK_BYTES != 0, "int_format must be compressed");
+					glCompressedTexImage2D(TargetType::TEXTURE_TARGET, level, int_format::TEXTURE_COLOR, width, height, 0, size, data);
+					CHECK_GL_ERROR;
+				}
+
 				static void texImage2D(GLuint width, GLuint height)
 				{
 					//null texture
@@ -763,6 +1218,7 @@ namespace jikoLib
 		template<GLint level, typename int_format,typename format>
 			struct TextureTraits<TextureCubeMap, level, int_format, format>
 			{
+				//the faces are decoded on the pool at the same time, then uploaded together
 				static void texImage2D(
 						const std::string &neg_x,
 						const std::string &pos_x,
@@ -771,127 +1227,33 @@ namespace jikoLib
 						const std::string &neg_z,
 						const std::string &pos_z)
 				{
-					ILuint imgID;
-					ilGenImages(1, &imgID);
-					ilBindImage(imgID);
-					ILboolean success;
-
-					//NEG_X
-					success = ilLoadImage(neg_x.c_str());
-					if(success == IL_TRUE)
-					{
-						success = ilConvertImage(format::IL_COLOR, IL_UNSIGNED_BYTE);
-						if(success == IL_TRUE)
-						{
-							//texture load
-							glPixelStorei(GL_UNPACK_ALIGNMENT, format::ALIGN);
-							CHECK_GL_ERROR;
-							TexImage_D<2>::func(TextureCubeMap::TEXTURE_NEGX, level, int_format::TEXTURE_COLOR, (GLuint)ilGetInteger(IL_IMAGE_WIDTH),(GLuint)ilGetInteger(IL_IMAGE_HEIGHT), 0, format::TEXTURE_COLOR, GL_UNSIGNED_BYTE, static_cast<GLubyte*>(ilGetData()));
-							CHECK_GL_ERROR;
-						}
-					}
-					else
+					const std::string* paths[6] = {&neg_x, &pos_x, &neg_y, &pos_y, &neg_z, &pos_z};
+					const GLenum targets[6] =
 					{
-						std::cerr << "cannot load image! --did nothing" << std::endl;
-					}
-
-					//POS_X
-					success = ilLoadImage(pos_x.c_str());
-					if(success == IL_TRUE)
-					{
-						success = ilConvertImage(format::IL_COLOR, IL_UNSIGNED_BYTE);
-						if(success == IL_TRUE)
-						{
-							//texture load
-							glPixelStorei(GL_UNPACK_ALIGNMENT, format::ALIGN);
-							CHECK_GL_ERROR;
-							TexImage_D<2>::func(TextureCubeMap::TEXTURE_POSX, level, int_format::TEXTURE_COLOR, (GLuint)ilGetInteger(IL_IMAGE_WIDTH),(GLuint)ilGetInteger(IL_IMAGE_HEIGHT), 0, format::TEXTURE_COLOR, GL_UNSIGNED_BYTE, static_cast<GLubyte*>(ilGetData()));
-							CHECK_GL_ERROR;
-						}
-					}
-					else
-					{
-						std::cerr << "cannot load image! --did nothing" << std::endl;
-					}
-
-					//NEG_Y
-					success = ilLoadImage(neg_y.c_str());
-					if(success == IL_TRUE)
-					{
-						success = ilConvertImage(format::IL_COLOR, IL_UNSIGNED_BYTE);
-						if(success == IL_TRUE)
-						{
-							//texture load
-							glPixelStorei(GL_UNPACK_ALIGNMENT, format::ALIGN);
-							CHECK_GL_ERROR;
-							TexImage_D<2>::func(TextureCubeMap::TEXTURE_NEGY, level, int_format::TEXTURE_COLOR, (GLuint)ilGetInteger(IL_IMAGE_WIDTH),(GLuint)ilGetInteger(IL_IMAGE_HEIGHT), 0, format::TEXTURE_COLOR, GL_UNSIGNED_BYTE, static_cast<GLubyte*>(ilGetData()));
-							CHECK_GL_ERROR;
-						}
-					}
-					else
-					{
-						std::cerr << "cannot load image! --did nothing" << std::endl;
-					}
-
-					//POS_Y
-					success = ilLoadImage(pos_y.c_str());
-					if(success == IL_TRUE)
-					{
-						success = ilConvertImage(format::IL_COLOR, IL_UNSIGNED_BYTE);
-						if(success == IL_TRUE)
-						{
-							//texture load
-							glPixelStorei(GL_UNPACK_ALIGNMENT, format::ALIGN);
-							CHECK_GL_ERROR;
-							TexImage_D<2>::func(TextureCubeMap::TEXTURE_POSY, level, int_format::TEXTURE_COLOR, (GLuint)ilGetInteger(IL_IMAGE_WIDTH),(GLuint)ilGetInteger(IL_IMAGE_HEIGHT), 0, format::TEXTURE_COLOR, GL_UNSIGNED_BYTE, static_cast<GLubyte*>(ilGetData()));
-							CHECK_GL_ERROR;
-						}
-					}
-					else
-					{
-						std::cerr << "cannot load image! --did nothing" << std::endl;
-					}
-
-					//NEG_Z
-					success = ilLoadImage(neg_z.c_str());
-					if(success == IL_TRUE)
-					{
-						success = ilConvertImage(format::IL_COLOR, IL_UNSIGNED_BYTE);
-						if(success == IL_TRUE)
-						{
-							//texture load
-							glPixelStorei(GL_UNPACK_ALIGNMENT, format::ALIGN);
-							CHECK_GL_ERROR;
-							TexImage_D<2>::func(TextureCubeMap::TEXTURE_NEGZ, level, int_format::TEXTURE_COLOR, (GLuint)ilGetInteger(IL_IMAGE_WIDTH),(GLuint)ilGetInteger(IL_IMAGE_HEIGHT), 0, format::TEXTURE_COLOR, GL_UNSIGNED_BYTE, static_cast<GLubyte*>(ilGetData()));
-							CHECK_GL_ERROR;
-						}
-					}
-					else
-					{
-						std::cerr << "cannot load image! --did nothing" << std::endl;
-					}
+						TextureCubeMap::TEXTURE_NEGX, TextureCubeMap::TEXTURE_POSX,
+						TextureCubeMap::TEXTURE_NEGY, TextureCubeMap::TEXTURE_POSY,
+						TextureCubeMap::TEXTURE_NEGZ, TextureCubeMap::TEXTURE_POSZ
+					};
+					ImageData faces[6];
+					bool success[6];
+					ThreadPool::getDefault().parallelFor(6, [&](std::size_t i)
+							{
+							success[i] = ImageDecoder::decode(*paths[i], format::CHANNELS, faces[i]);
+							});
 
-					//POS_Z
-					success = ilLoadImage(pos_z.c_str());
-					if(success == IL_TRUE)
+					//texture load
+					glPixelStorei(GL_UNPACK_ALIGNMENT, format::ALIGN);
+					CHECK_GL_ERROR;
+					for(std::size_t i = 0; i < 6; i++)
 					{
-						success = ilConvertImage(format::IL_COLOR, IL_UNSIGNED_BYTE);
-						if(success == IL_TRUE)
+						if(!success[i])
 						{
-							//texture load
-							glPixelStorei(GL_UNPACK_ALIGNMENT, format::ALIGN);
-							CHECK_GL_ERROR;
-							TexImage_D<2>::func(TextureCubeMap::TEXTURE_POSZ, level, int_format::TEXTURE_COLOR, (GLuint)ilGetInteger(IL_IMAGE_WIDTH),(GLuint)ilGetInteger(IL_IMAGE_HEIGHT), 0, format::TEXTURE_COLOR, GL_UNSIGNED_BYTE, static_cast<GLubyte*>(ilGetData()));
-							CHECK_GL_ERROR;
+							std::cerr << "cannot load image! --did nothing" << std::endl;
+							continue;
 						}
+						TexImage_D<2>::func(targets[i], level, int_format::TEXTURE_COLOR, faces[i].width, faces[i].height, 0, format::TEXTURE_COLOR, GL_UNSIGNED_BYTE, faces[i].pixels.data());
+						CHECK_GL_ERROR;
 					}
-					else
-					{
-						std::cerr << "cannot load image! --did nothing" << std::endl;
-					}
-
-
-					ilDeleteImages(1, &imgID);
 				}
 
 			};
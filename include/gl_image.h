@@ -0,0 +1,131 @@
+#pragma once
+
+#include <GL/glew.h>
+#include <IL/il.h>
+#include <cstddef>
+#include <cstdio>
+#include <csetjmp>
+#include <string>
+#include <vector>
+#include <mutex>
+#include <jpeglib.h>
+#include "gl_file.h"
+
+namespace jikoLib{
+	namespace GLLib{
+
+		//devIL keeps the bound image in the global state. lock this around the il calls made off the GL thread
+		inline std::mutex& devILMutex()
+		{
+			static std::mutex mtx;
+			return mtx;
+		}
+
+		/**
+		 * ImageData
+		 * decoded 8 bit pixels (rows from the top of the file like devIL)
+		 *
+		 */
+
+		struct ImageData
+		{
+			GLsizei width = 0;
+			GLsizei height = 0;
+			std::size_t channels = 0;
+			std::vector<GLubyte> pixels;
+		};
+
+		namespace ImageDecoder
+		{
+			struct JpegError
+			{
+				jpeg_error_mgr mgr;
+				std::jmp_buf jump;
+			};
+
+			inline void jpegErrorExit(j_common_ptr info)
+			{
+				std::longjmp(reinterpret_cast<JpegError*>(info->err)->jump, 1);
+			}
+
+			//libjpeg has no global state, so this runs on any thread
+			inline bool decodeJPEG(const MappedFile &file, std::size_t channels, ImageData &image)
+			{
+				jpeg_decompress_struct info;
+				JpegError error;
+				std::vector<JSAMPLE> row;
+				info.err = jpeg_std_error(&error.mgr);
+				error.mgr.error_exit = jpegErrorExit;
+				if(setjmp(error.jump))
+				{
+					jpeg_destroy_decompress(&info);
+					return false;
+				}
+				jpeg_create_decompress(&info);
+				jpeg_mem_src(&info, reinterpret_cast<unsigned char*>(const_cast<char*>(file.data())), file.size());
+				jpeg_read_header(&info, TRUE);
+				info.out_color_space = JCS_RGB;
+				jpeg_start_decompress(&info);
+
+				image.width = info.output_width;
+				image.height = info.output_height;
+				image.channels = channels;
+				image.pixels.resize(static_cast<std::size_t>(image.width)*image.height*channels);
+				row.resize(static_cast<std::size_t>(image.width)*3);
+				while(info.output_scanline < info.output_height)
+				{
+					GLubyte* dst = &image.pixels[static_cast<std::size_t>(info.output_scanline)*image.width*channels];
+					JSAMPROW src = (channels == 3) ? dst : row.data();
+					jpeg_read_scanlines(&info, &src, 1);
+					if(channels == 4)
+					{
+						for(GLsizei x = image.width-1; x >= 0; x--)
+						{
+							dst[x*4+0] = row[x*3+0];
+							dst[x*4+1] = row[x*3+1];
+							dst[x*4+2] = row[x*3+2];
+							dst[x*4+3] = 255;
+						}
+					}
+				}
+				jpeg_finish_decompress(&info);
+				jpeg_destroy_decompress(&info);
+				return true;
+			}
+
+			//the other formats go through devIL (one at a time)
+			inline bool decodeDevIL(const std::string &path, std::size_t channels, ImageData &image)
+			{
+				std::lock_guard<std::mutex> lock(devILMutex());
+				ILuint imgID;
+				ilGenImages(1, &imgID);
+				ilBindImage(imgID);
+				bool success = (ilLoadImage(path.c_str()) == IL_TRUE) && (ilConvertImage((channels == 3) ? IL_RGB : IL_RGBA, IL_UNSIGNED_BYTE) == IL_TRUE);
+				if(success)
+				{
+					image.width = ilGetInteger(IL_IMAGE_WIDTH);
+					image.height = ilGetInteger(IL_IMAGE_HEIGHT);
+					image.channels = channels;
+					const GLubyte* data = static_cast<const GLubyte*>(ilGetData());
+					image.pixels.assign(data, data+static_cast<std::size_t>(image.width)*image.height*channels);
+				}
+				ilDeleteImages(1, &imgID);
+				return success;
+			}
+
+			//channels: 3 (RGB) or 4 (RGBA). thread safe (call from the workers)
+			inline bool decode(const std::string &path, std::size_t channels, ImageData &image)
+			{
+				{
+					MappedFile file;
+					if(!file.open(path))
+						return false;
+					const bool is_jpeg = (file.size() > 2 && static_cast<unsigned char>(file.data()[0]) == 0xFF && static_cast<unsigned char>(file.data()[1]) == 0xD8);
+					if(is_jpeg && decodeJPEG(file, channels, image))
+						return true;
+				}
+				return decodeDevIL(path, channels, image);
+			}
+		}
+	}
+}
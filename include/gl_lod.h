@@ -0,0 +1,586 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cmath>
+#include <limits>
+#include <vector>
+#include <queue>
+#include <utility>
+#include <algorithm>
+#include <GL/glew.h>
+#include "gl_debug.h"
+#include "gl_cull.h"
+
+namespace jikoLib{
+	namespace GLLib{
+
+		/**
+		 * MeshSimplifier
+		 * edge collapse simplification of an indexed triangle mesh by the quadric error metric (Garland and Heckbert).
+		 * a vertex is collapsed onto a neighbor vertex, so the result is an index buffer for the same vertex buffer.
+		 * the vertices at the same position (texcrd/normal seams) are simplified as one, and each copy moves to the copy
+		 * of the neighbor on its side of the seam. a collapse across a seam is rejected while keep_seams is set
+		 * (see setKeepSeams. meshes with hard normals everywhere cannot be simplified much with it).
+		 * the mesh is simplified progressively: simplify() may be called with smaller targets for the next levels.
+		 *
+		 */
+
+		class MeshSimplifier
+		{
+			public:
+				constexpr static std::uint32_t NONE = 0xFFFFFFFFu;
+
+			private:
+				//the borders are kept by the planes through the border edges (perpendicular to the face)
+				constexpr static double BORDER_WEIGHT = 10.0;
+				//a collapse must not turn a face more than about 75 degrees
+				constexpr static double MIN_NORMAL_DOT = 0.25;
+
+				//sum of the squared distances to the planes: p^T*A*p + 2*b.p + c (A is symmetric)
+				struct Quadric
+				{
+					double a00 = 0.0, a01 = 0.0, a02 = 0.0, a11 = 0.0, a12 = 0.0, a22 = 0.0;
+					double b0 = 0.0, b1 = 0.0, b2 = 0.0;
+					double c = 0.0;
+					//area of the faces (the error is the mean over the area)
+					double weight = 0.0;
+
+					//plane n.p+d = 0 (|n| = 1)
+					void addPlane(double nx, double ny, double nz, double d, double scale, double area)
+					{
+						a00 += scale*nx*nx; a01 += scale*nx*ny; a02 += scale*nx*nz;
+						a11 += scale*ny*ny; a12 += scale*ny*nz; a22 += scale*nz*nz;
+						b0 += scale*nx*d; b1 += scale*ny*d; b2 += scale*nz*d;
+						c += scale*d*d;
+						weight += area;
+					}
+
+					inline void operator+=(const Quadric &q)
+					{
+						a00 += q.a00; a01 += q.a01; a02 += q.a02;
+						a11 += q.a11; a12 += q.a12; a22 += q.a22;
+						b0 += q.b0; b1 += q.b1; b2 += q.b2;
+						c += q.c;
+						weight += q.weight;
+					}
+
+					inline double eval(const double *p) const
+					{
+						const double x = p[0], y = p[1], z = p[2];
+						return a00*x*x + a11*y*y + a22*z*z + 2.0*(a01*x*y + a02*x*z + a12*y*z + b0*x + b1*y + b2*z) + c;
+					}
+				};
+
+				//collapse of the vertex "from" onto "to". stale if a vertex changed after the push
+				struct Collapse
+				{
+					double cost;
+					std::uint32_t from;
+					std::uint32_t to;
+					std::uint32_t from_version;
+					std::uint32_t to_version;
+
+					//the cheapest on the top of the priority_queue
+					inline bool operator<(const Collapse &other) const
+					{
+						return cost > other.cost;
+					}
+				};
+
+				std::vector<double> positions; //3 per vertex
+				std::vector<std::uint32_t> remap; //the first vertex at the same position. the collapses work on these
+				std::vector<std::uint32_t> next_copy; //the next vertex at the same position (NONE at the last)
+				std::vector<GLfloat> attributes; //the floats of a vertex after the position (stride-3 per vertex)
+				std::size_t num_attribute = 0;
+				bool keep_seams = true;
+				std::vector<GLuint> triangles; //3 per triangle (the original vertices)
+				std::vector<std::uint8_t> alive; //per triangle
+				std::vector<std::vector<std::uint32_t>> adjacency; //triangles around a remapped vertex (may contain dead ones)
+				std::vector<Quadric> quadrics;
+				std::vector<std::uint32_t> versions;
+				std::vector<std::uint8_t> removed;
+				std::priority_queue<Collapse> heap;
+				std::size_t num_triangle = 0;
+				double max_cost = 0.0;
+
+				//scratch of collapse()
+				std::vector<std::pair<GLuint, GLuint>> moves;
+				std::vector<std::uint32_t> shared;
+				std::vector<std::uint32_t> ring_from;
+				std::vector<std::uint32_t> ring_to;
+
+				inline const double* getPos(std::uint32_t v) const
+				{
+					return &positions[3*v];
+				}
+
+				//slot (0..2) of the remapped vertex v in the triangle. 3 if it is not there
+				inline int findSlot(std::uint32_t t, std::uint32_t v) const
+				{
+					for(int k = 0; k < 3; k++)
+					{
+						if(remap[triangles[3*t+k]] == v)
+							return k;
+					}
+					return 3;
+				}
+
+				static void cross(const double *p0, const double *p1, const double *p2, double *n)
+				{
+					const double e1[3] = {p1[0]-p0[0], p1[1]-p0[1], p1[2]-p0[2]};
+					const double e2[3] = {p2[0]-p0[0], p2[1]-p0[1], p2[2]-p0[2]};
+					n[0] = e1[1]*e2[2]-e1[2]*e2[1];
+					n[1] = e1[2]*e2[0]-e1[0]*e2[2];
+					n[2] = e1[0]*e2[1]-e1[1]*e2[0];
+				}
+
+				void pushCollapse(std::uint32_t from, std::uint32_t to)
+				{
+					Quadric q = quadrics[from];
+					q += quadrics[to];
+					double cost = q.eval(getPos(to));
+					if(q.weight > 0.0)
+						cost /= q.weight;
+					heap.push(Collapse{std::max(cost, 0.0), from, to, versions[from], versions[to]});
+				}
+
+				void addQuadrics()
+				{
+					//faces
+					for(std::size_t t = 0; t < alive.size(); t++)
+					{
+						const std::uint32_t v[3] = {remap[triangles[3*t]], remap[triangles[3*t+1]], remap[triangles[3*t+2]]};
+						double n[3];
+						cross(getPos(v[0]), getPos(v[1]), getPos(v[2]), n);
+						const double length = std::sqrt(n[0]*n[0]+n[1]*n[1]+n[2]*n[2]);
+						if(length == 0.0)
+							continue;
+						n[0] /= length; n[1] /= length; n[2] /= length;
+						const double *p = getPos(v[0]);
+						const double d = -(n[0]*p[0]+n[1]*p[1]+n[2]*p[2]);
+						for(int k = 0; k < 3; k++)
+							quadrics[v[k]].addPlane(n[0], n[1], n[2], d, length*0.5, length*0.5);
+					}
+
+					//border edges: used by one triangle
+					std::vector<std::uint64_t> edges;
+					edges.reserve(alive.size()*3);
+					for(std::size_t t = 0; t < alive.size(); t++)
+					{
+						for(int k = 0; k < 3; k++)
+						{
+							std::uint64_t a = remap[triangles[3*t+k]], b = remap[triangles[3*t+(k+1)%3]];
+							edges.push_back((std::min(a, b) << 32) | std::max(a, b));
+						}
+					}
+					std::sort(edges.begin(), edges.end());
+					for(std::size_t t = 0; t < alive.size(); t++)
+					{
+						for(int k = 0; k < 3; k++)
+						{
+							const std::uint32_t a = remap[triangles[3*t+k]], b = remap[triangles[3*t+(k+1)%3]], o = remap[triangles[3*t+(k+2)%3]];
+							const std::uint64_t key = (std::uint64_t(std::min(a, b)) << 32) | std::max(a, b);
+							const auto range = std::equal_range(edges.begin(), edges.end(), key);
+							if(range.second-range.first != 1)
+								continue;
+							double n[3];
+							cross(getPos(a), getPos(b), getPos(o), n);
+							const double *pa = getPos(a), *pb = getPos(b);
+							const double e[3] = {pb[0]-pa[0], pb[1]-pa[1], pb[2]-pa[2]};
+							const double e_length2 = e[0]*e[0]+e[1]*e[1]+e[2]*e[2];
+							//the plane through the edge, perpendicular to the face
+							double m[3] = {e[1]*n[2]-e[2]*n[1], e[2]*n[0]-e[0]*n[2], e[0]*n[1]-e[1]*n[0]};
+							const double length = std::sqrt(m[0]*m[0]+m[1]*m[1]+m[2]*m[2]);
+							if(length == 0.0)
+								continue;
+							m[0] /= length; m[1] /= length; m[2] /= length;
+							const double d = -(m[0]*pa[0]+m[1]*pa[1]+m[2]*pa[2]);
+							quadrics[a].addPlane(m[0], m[1], m[2], d, BORDER_WEIGHT*e_length2, BORDER_WEIGHT*e_length2);
+							quadrics[b].addPlane(m[0], m[1], m[2], d, BORDER_WEIGHT*e_length2, BORDER_WEIGHT*e_length2);
+						}
+					}
+				}
+
+				//the copy of w with the nearest attributes to the vertex a
+				GLuint nearestCopy(GLuint a, std::uint32_t w) const
+				{
+					GLuint best = w;
+					GLfloat best_distance = std::numeric_limits<GLfloat>::infinity();
+					for(std::uint32_t b = w; b != NONE; b = next_copy[b])
+					{
+						GLfloat distance = 0.0f;
+						for(std::size_t k = 0; k < num_attribute; k++)
+						{
+							const GLfloat d = attributes[a*num_attribute+k]-attributes[b*num_attribute+k];
+							distance += d*d;
+						}
+						if(distance < best_distance)
+						{
+							best = b;
+							best_distance = distance;
+						}
+					}
+					return best;
+				}
+
+				//all edges of the mesh (the rejected collapses are tried again)
+				void pushAll()
+				{
+					heap = std::priority_queue<Collapse>();
+					for(std::size_t t = 0; t < alive.size(); t++)
+					{
+						if(!alive[t])
+							continue;
+						for(int k = 0; k < 3; k++)
+							pushCollapse(remap[triangles[3*t+k]], remap[triangles[3*t+(k+1)%3]]);
+					}
+				}
+
+				//the remapped vertices around v (sorted)
+				void getRing(std::uint32_t v, std::vector<std::uint32_t> &ring) const
+				{
+					ring.clear();
+					for(auto&& t : adjacency[v])
+					{
+						if(!alive[t])
+							continue;
+						for(int k = 0; k < 3; k++)
+						{
+							const std::uint32_t r = remap[triangles[3*t+k]];
+							if(r != v)
+								ring.push_back(r);
+						}
+					}
+					std::sort(ring.begin(), ring.end());
+					ring.erase(std::unique(ring.begin(), ring.end()), ring.end());
+				}
+
+				bool collapse(const Collapse &c)
+				{
+					const std::uint32_t u = c.from, w = c.to;
+
+					//the copies of u move to the copies of w in the same triangles (the edge u-w)
+					moves.clear();
+					shared.clear();
+					for(auto&& t : adjacency[u])
+					{
+						if(!alive[t])
+							continue;
+						const int slot_w = findSlot(t, w);
+						if(slot_w == 3)
+							continue;
+						shared.push_back(t);
+						const GLuint a = triangles[3*t+findSlot(t, u)];
+						const GLuint b = triangles[3*t+slot_w];
+						if(std::find_if(moves.begin(), moves.end(), [a](const std::pair<GLuint, GLuint> &m){ return m.first == a; }) == moves.end())
+							moves.emplace_back(a, b);
+					}
+					if(shared.empty())
+						return false;
+
+					//link condition: the common neighbors are the opposite vertices of the edge only (no pinch)
+					getRing(u, ring_from);
+					getRing(w, ring_to);
+					std::size_t common = 0;
+					for(std::size_t i = 0, j = 0; i < ring_from.size() && j < ring_to.size();)
+					{
+						if(ring_from[i] < ring_to[j])
+							i++;
+						else if(ring_to[j] < ring_from[i])
+							j++;
+						else
+						{
+							common++;
+							i++;
+							j++;
+						}
+					}
+					if(common != shared.size())
+						return false;
+
+					for(auto&& t : adjacency[u])
+					{
+						if(!alive[t] || std::find(shared.begin(), shared.end(), t) != shared.end())
+							continue;
+						//a copy of u on the other side of a seam
+						const int slot_u = findSlot(t, u);
+						const GLuint a = triangles[3*t+slot_u];
+						if(std::find_if(moves.begin(), moves.end(), [a](const std::pair<GLuint, GLuint> &m){ return m.first == a; }) == moves.end())
+						{
+							if(keep_seams)
+								return false;
+							moves.emplace_back(a, nearestCopy(a, w));
+						}
+						//flip
+						const double *p[3] = {getPos(remap[triangles[3*t]]), getPos(remap[triangles[3*t+1]]), getPos(remap[triangles[3*t+2]])};
+						double n_old[3], n_new[3];
+						cross(p[0], p[1], p[2], n_old);
+						p[slot_u] = getPos(w);
+						cross(p[0], p[1], p[2], n_new);
+						const double dot = n_old[0]*n_new[0]+n_old[1]*n_new[1]+n_old[2]*n_new[2];
+						const double length2 = (n_old[0]*n_old[0]+n_old[1]*n_old[1]+n_old[2]*n_old[2])*(n_new[0]*n_new[0]+n_new[1]*n_new[1]+n_new[2]*n_new[2]);
+						if(dot <= 0.0 || dot*dot < MIN_NORMAL_DOT*MIN_NORMAL_DOT*length2)
+							return false;
+					}
+
+					//apply
+					for(auto&& t : adjacency[u])
+					{
+						if(!alive[t])
+							continue;
+						if(std::find(shared.begin(), shared.end(), t) != shared.end())
+						{
+							alive[t] = 0;
+							num_triangle--;
+							continue;
+						}
+						const int slot_u = findSlot(t, u);
+						const GLuint a = triangles[3*t+slot_u];
+						for(auto&& m : moves)
+						{
+							if(m.first == a)
+							{
+								triangles[3*t+slot_u] = m.second;
+								break;
+							}
+						}
+						adjacency[w].push_back(t);
+					}
+					std::vector<std::uint32_t>().swap(adjacency[u]);
+					removed[u] = 1;
+					quadrics[w] += quadrics[u];
+					versions[w]++;
+					max_cost = std::max(max_cost, c.cost);
+
+					//the edges around w with the new quadric
+					auto &around = adjacency[w];
+					around.erase(std::remove_if(around.begin(), around.end(), [this](std::uint32_t t){ return !alive[t]; }), around.end());
+					for(auto&& t : around)
+					{
+						const int k = findSlot(t, w);
+						pushCollapse(w, remap[triangles[3*t+(k+1)%3]]);
+						pushCollapse(remap[triangles[3*t+(k+2)%3]], w);
+					}
+					return true;
+				}
+
+			public:
+
+				//positions: x, y, z of a vertex at every stride floats (e.g. sizeof(VertexPNT)/sizeof(GLfloat))
+				MeshSimplifier(const GLfloat *vertices, std::size_t num_vertex, std::size_t stride, const GLuint *indices, std::size_t num_index)
+				{
+					positions.resize(num_vertex*3);
+					num_attribute = (stride > 3) ? stride-3 : 0;
+					attributes.resize(num_vertex*num_attribute);
+					for(std::size_t i = 0; i < num_vertex; i++)
+					{
+						for(std::size_t k = 0; k < 3; k++)
+							positions[3*i+k] = vertices[i*stride+k];
+						for(std::size_t k = 0; k < num_attribute; k++)
+							attributes[i*num_attribute+k] = vertices[i*stride+3+k];
+					}
+
+					//weld by the position
+					std::vector<std::uint32_t> order(num_vertex);
+					for(std::size_t i = 0; i < num_vertex; i++)
+						order[i] = i;
+					auto less = [this](std::uint32_t a, std::uint32_t b)
+					{
+						return std::lexicographical_compare(getPos(a), getPos(a)+3, getPos(b), getPos(b)+3);
+					};
+					std::sort(order.begin(), order.end(), less);
+					remap.resize(num_vertex);
+					next_copy.resize(num_vertex);
+					for(std::size_t begin = 0; begin < num_vertex;)
+					{
+						std::size_t end = begin+1;
+						while(end < num_vertex && !less(order[begin], order[end]))
+							end++;
+						for(std::size_t i = begin; i < end; i++)
+						{
+							remap[order[i]] = order[begin];
+							next_copy[order[i]] = (i+1 < end) ? order[i+1] : NONE;
+						}
+						begin = end;
+					}
+
+					//degenerate triangles (after the weld) and out of range indices are dropped
+					triangles.reserve(num_index);
+					for(std::size_t i = 0; i+2 < num_index; i += 3)
+					{
+						if(indices[i] >= num_vertex || indices[i+1] >= num_vertex || indices[i+2] >= num_vertex)
+						{
+							std::cerr << "index out of range (triangle " << i/3 << ") --skipped" << std::endl;
+							continue;
+						}
+						const std::uint32_t a = remap[indices[i]], b = remap[indices[i+1]], c = remap[indices[i+2]];
+						if(a == b || b == c || c == a)
+							continue;
+						triangles.insert(triangles.end(), {indices[i], indices[i+1], indices[i+2]});
+					}
+					num_triangle = triangles.size()/3;
+					alive.assign(num_triangle, 1);
+
+					adjacency.resize(num_vertex);
+					for(std::size_t t = 0; t < num_triangle; t++)
+					{
+						for(int k = 0; k < 3; k++)
+							adjacency[remap[triangles[3*t+k]]].push_back(t);
+					}
+					quadrics.resize(num_vertex);
+					versions.assign(num_vertex, 0);
+					removed.assign(num_vertex, 0);
+					addQuadrics();
+					//one collapse per half edge (both directions of an inner edge)
+					pushAll();
+				}
+
+				//false: a copy of a vertex on the other side of a seam moves to the copy of the neighbor
+				//with the nearest attributes (the floats after the position), so the seams are simplified too. default true
+				void setKeepSeams(bool flag)
+				{
+					if(keep_seams && !flag)
+						pushAll();
+					keep_seams = flag;
+				}
+
+				inline bool getKeepSeams() const
+				{
+					return keep_seams;
+				}
+
+				//collapse the cheapest edges until the index count is at most target_index
+				//or the next collapse has an error over max_error. returns the index count
+				std::size_t simplify(std::size_t target_index, float max_error = std::numeric_limits<float>::infinity())
+				{
+					const double max_cost_limit = static_cast<double>(max_error)*max_error;
+					while(num_triangle*3 > target_index && !heap.empty())
+					{
+						const Collapse c = heap.top();
+						if(removed[c.from] || removed[c.to] || versions[c.from] != c.from_version || versions[c.to] != c.to_version)
+						{
+							heap.pop();
+							continue;
+						}
+						//left in the queue for the next call
+						if(c.cost > max_cost_limit)
+							break;
+						heap.pop();
+						collapse(c);
+					}
+					return num_triangle*3;
+				}
+
+				inline std::size_t getNumIndex() const
+				{
+					return num_triangle*3;
+				}
+
+				//the largest error of the collapses so far (root mean square distance to the original planes)
+				inline float getError() const
+				{
+					return static_cast<float>(std::sqrt(max_cost));
+				}
+
+				//the current triangles are appended to indices
+				void getIndices(std::vector<GLuint> &indices) const
+				{
+					indices.reserve(indices.size()+num_triangle*3);
+					for(std::size_t t = 0; t < alive.size(); t++)
+					{
+						if(alive[t])
+							indices.insert(indices.end(), {triangles[3*t], triangles[3*t+1], triangles[3*t+2]});
+					}
+				}
+		};
+
+		//a range of LodChain::indices
+		struct LodLevel
+		{
+			GLuint first;
+			GLuint count;
+			//geometric error relative to the radius of the bounding sphere of the vertices
+			GLfloat error;
+		};
+
+		/**
+		 * LodChain
+		 * index buffers of the LOD levels of a mesh in one array (level 0 is the original).
+		 * all levels index the same vertex buffer.
+		 *
+		 */
+
+		struct LodChain
+		{
+			constexpr static std::size_t MAX_LEVELS = 5;
+
+			std::vector<GLuint> indices;
+			std::vector<LodLevel> levels;
+
+			inline std::size_t getNumTriangle(std::size_t level) const
+			{
+				return (level < levels.size()) ? levels[level].count/3 : 0;
+			}
+		};
+
+		//each level has about ratio times the triangles of the previous one.
+		//the seams are kept until they cost much more than simplifying them too (e.g. hard normals everywhere).
+		//the chain ends at max_levels or when a level saves less than 10%
+		inline LodChain buildLodChain(const GLfloat *vertices, std::size_t num_vertex, std::size_t stride, const GLuint *indices, std::size_t num_index,
+				std::size_t max_levels = LodChain::MAX_LEVELS, float ratio = 0.5f)
+		{
+			LodChain chain;
+			chain.indices.assign(indices, indices+num_index);
+			chain.levels.push_back(LodLevel{0, static_cast<GLuint>(num_index), 0.0f});
+			if(num_vertex == 0 || num_index == 0)
+				return chain;
+
+			BoundingBox box;
+			BoundingSphere sphere;
+			computeBounds(vertices, num_vertex, stride, box, sphere);
+			MeshSimplifier simplifier(vertices, num_vertex, stride, indices, num_index);
+			std::size_t prev = simplifier.getNumIndex();
+			while(chain.levels.size() < max_levels)
+			{
+				const std::size_t target = static_cast<std::size_t>(prev*ratio);
+				if(simplifier.getKeepSeams())
+				{
+					//the seams are kept while the level costs at most twice the error (and 10% more triangles) of the level without them
+					MeshSimplifier relaxed = simplifier;
+					relaxed.setKeepSeams(false);
+					relaxed.simplify(target);
+					simplifier.simplify(target);
+					if(simplifier.getNumIndex()*10 > relaxed.getNumIndex()*11 || simplifier.getError() > 2.0f*relaxed.getError())
+						simplifier = std::move(relaxed);
+				}
+				else
+				{
+					simplifier.simplify(target);
+				}
+				const std::size_t count = simplifier.getNumIndex();
+				if(count*10 > prev*9)
+					break;
+				const GLfloat error = (sphere.radius > 0.0f) ? simplifier.getError()/sphere.radius : 0.0f;
+				chain.levels.push_back(LodLevel{static_cast<GLuint>(chain.indices.size()), static_cast<GLuint>(count), error});
+				simplifier.getIndices(chain.indices);
+				prev = count;
+			}
+			return chain;
+		}
+
+		//the coarsest level whose error is at most pixel_error pixels,
+		//when the bounding sphere has the radius of radius_pixels on the screen
+		inline std::size_t selectLodLevel(const std::vector<LodLevel> &levels, GLfloat radius_pixels, GLfloat pixel_error = 1.0f)
+		{
+			std::size_t level = 0;
+			for(std::size_t i = 1; i < levels.size(); i++)
+			{
+				if(levels[i].error > 0.0f && levels[i].error*radius_pixels > pixel_error)
+					break;
+				level = i;
+			}
+			return level;
+		}
+	}
+}
@@ -14,11 +14,24 @@ namespace jikoLib{
 			private:
 				//member variable
 				bool _is_initialized;
+				BindState _bind_state;
 
 			public:
 				GLObject() :_is_initialized(false)
 			{
 			}
+
+				~GLObject()
+				{
+					if(&BindState::current() == &_bind_state)
+						BindState::makeCurrent(nullptr);
+				}
+
+				inline BindState& getBindState()
+				{
+					return _bind_state;
+				}
+
 				bool initialize()
 				{
 					bool success = true;
@@ -39,6 +52,7 @@ namespace jikoLib{
 						DEBUG_OUT("OpenGL Version: " << glGetString(GL_VERSION));
 						DEBUG_OUT(" ");
 						_is_initialized = true;
+						BindState::makeCurrent(&_bind_state);
 					}
 					ilInit();
 					iluInit();
@@ -137,9 +151,15 @@ namespace jikoLib{
 						CHECK_GL_ERROR;
 					}
 
+				//Mesh3D has the attributes in its vertex array already. this is needed only if the program has no VertexLayout
 				template<typename Allocator_sh>
 					inline void connectAttrib(const ShaderProg<Allocator_sh> &prog, const Mesh3D &mesh, const std::string &vertex_attr, const std::string &normal_attr, const std::string &texcrd_attr = "")
 					{
+						if(mesh.getIsInterleaved())
+						{
+							std::cerr << "interleaved mesh cannot be connected by name. use VertexLayout --did nothing" << std::endl;
+							return;
+						}
 						this->connectAttrib(prog, mesh.getVertex(), mesh.getVArray(), vertex_attr);
 						this->connectAttrib(prog, mesh.getNormal(), mesh.getVArray(), normal_attr);
 						if(texcrd_attr != "")
@@ -153,11 +173,10 @@ namespace jikoLib{
 				}
 
 				template<typename fbTargetType, typename fbAllocator>
-					inline void viewport(GLint x, GLint y, GLsizei width, GLsizei height,const FrameBuffer<fbTargetType, fbAllocator> &fbo)
+					inline void viewport(GLint x, GLint y, GLsizei width, GLsizei height, const FrameBuffer<fbTargetType, fbAllocator> &)
 					{
-						fbo.bind();
+						//not a framebuffer state. no need to bind fbo
 						glViewport(x,y,width,height);
-						fbo.unbind();
 					}
 
 				inline void clearColor(GLclampf red, GLclampf green, GLclampf blue, GLclampf alpha)
@@ -166,11 +185,10 @@ namespace jikoLib{
 				}
 
 				template<typename fbTargetType, typename fbAllocator>
-					inline void clearColor(GLclampf red, GLclampf green, GLclampf blue, GLclampf alpha, const FrameBuffer<fbTargetType, fbAllocator> &fbo)
+					inline void clearColor(GLclampf red, GLclampf green, GLclampf blue, GLclampf alpha, const FrameBuffer<fbTargetType, fbAllocator> &)
 					{
-						fbo.bind();
+						//not a framebuffer state. no need to bind fbo
 						glClearColor(red, green, blue, alpha);
-						fbo.unbind();
 					}
 
 				inline void clearDepth(GLclampd depth)
@@ -179,11 +197,10 @@ namespace jikoLib{
 				}
 
 				template<typename fbTargetType, typename fbAllocator>
-					inline void clearDepth(GLclampd depth, const FrameBuffer<fbTargetType, fbAllocator> &fbo)
+					inline void clearDepth(GLclampd depth, const FrameBuffer<fbTargetType, fbAllocator> &)
 					{
-						fbo.bind();
+						//not a framebuffer state. no need to bind fbo
 						glClearDepth(depth);
-						fbo.unbind();
 					}
 
 				inline void clear(GLbitfield mask)
@@ -220,7 +237,7 @@ namespace jikoLib{
 						glDrawElements(RenderMode::RENDER_MODE, ibo.getSizeElem(), ibo.getArrayEnum(), NULL);
 						CHECK_GL_ERROR;
 						program.unbind();
-						ibo.unbind();
+						//ibo is left in the vertex array
 						varray.unbind();
 					}
 
@@ -241,7 +258,93 @@ namespace jikoLib{
 						varray.unbind();
 					}
 
+				//draw a range of the indices (e.g. a LOD level of Mesh3D)
+				template<typename RenderMode = rm_Triangles, typename varrAlloc, typename Sp_Alloc, typename vbUsage, typename vbAlloc>
+					void draw(const VertexArray<varrAlloc> &varray, const ShaderProg<Sp_Alloc> &program, const VertexBuffer<ElementArrayBuffer, vbUsage, vbAlloc> &ibo, GLint first, GLsizei count)
+					{
+						varray.bind();
+						ibo.bind();
+						program.bind();
 
+						if(!ibo.getisSetArray())
+						{
+							std::cerr << "IBO array isn't set. cannot draw" << std::endl;
+						}
+						//else
+						glDrawElements(RenderMode::RENDER_MODE, count, ibo.getArrayEnum(), reinterpret_cast<const GLvoid*>(first*getSizeof(ibo.getArrayEnum())));
+						CHECK_GL_ERROR;
+						program.unbind();
+						//ibo is left in the vertex array
+						varray.unbind();
+					}
+
+				//draw a range of the vertices (e.g. written to RingBuffer)
+				template<typename RenderMode = rm_Triangles, typename varrAlloc, typename Sp_Alloc>
+					void draw(const VertexArray<varrAlloc> &varray, const ShaderProg<Sp_Alloc> &program, GLint first, GLsizei count)
+					{
+						varray.bind();
+						program.bind();
+						glDrawArrays(RenderMode::RENDER_MODE, first, count);
+						CHECK_GL_ERROR;
+						program.unbind();
+						varray.unbind();
+					}
+
+
+
+				//instanced draw. per-instance attributes are set by VertexArray::setInstanceAttrib
+
+				template<typename RenderMode = rm_Triangles, typename varrAlloc, typename Sp_Alloc, typename vbUsage, typename vbAlloc>
+					void drawInstanced(const VertexArray<varrAlloc> &varray, const ShaderProg<Sp_Alloc> &program, const VertexBuffer<ElementArrayBuffer, vbUsage, vbAlloc> &ibo, GLsizei instances)
+					{
+						varray.bind();
+						ibo.bind();
+						program.bind();
+
+						if(!ibo.getisSetArray())
+						{
+							std::cerr << "IBO array isn't set. cannot draw" << std::endl;
+						}
+						//else
+						glDrawElementsInstanced(RenderMode::RENDER_MODE, ibo.getSizeElem(), ibo.getArrayEnum(), NULL, instances);
+						CHECK_GL_ERROR;
+						program.unbind();
+						varray.unbind();
+					}
+
+				template<typename RenderMode = rm_Triangles, typename varrAlloc, typename Sp_Alloc, typename vbUsage, typename vbAlloc>
+					void drawInstanced(const VertexArray<varrAlloc> &varray, const ShaderProg<Sp_Alloc> &program, const VertexBuffer<ElementArrayBuffer, vbUsage, vbAlloc> &ibo, GLint first, GLsizei count, GLsizei instances)
+					{
+						varray.bind();
+						ibo.bind();
+						program.bind();
+
+						if(!ibo.getisSetArray())
+						{
+							std::cerr << "IBO array isn't set. cannot draw" << std::endl;
+						}
+						//else
+						glDrawElementsInstanced(RenderMode::RENDER_MODE, count, ibo.getArrayEnum(), reinterpret_cast<const GLvoid*>(first*getSizeof(ibo.getArrayEnum())), instances);
+						CHECK_GL_ERROR;
+						program.unbind();
+						varray.unbind();
+					}
+
+				template<typename RenderMode = rm_Triangles, typename varrAlloc, typename Sp_Alloc, typename vbUsage, typename vbAlloc>
+					void drawInstanced(const VertexArray<varrAlloc> &varray, const ShaderProg<Sp_Alloc> &program, const VertexBuffer<ArrayBuffer, vbUsage, vbAlloc> &vbo, GLsizei instances)
+					{
+						varray.bind();
+						program.bind();
+						if(!vbo.getisSetArray())
+						{
+							std::cerr << "VBO array isn't set. cannot draw" << std::endl;
+						}
+						//else
+						glDrawArraysInstanced(RenderMode::RENDER_MODE, 0, vbo.getSizeElem(), instances);
+						CHECK_GL_ERROR;
+						program.unbind();
+						varray.unbind();
+					}
 
 				template<typename RenderMode = rm_Triangles, typename varrAlloc, typename Sp_Alloc, typename TexTarget, typename TexAlloc, typename vbUsage, typename vbAlloc>
 					void draw(
@@ -282,23 +385,96 @@ namespace jikoLib{
 					}
 
 
+				//the current LOD level of the mesh (the whole index buffer without LOD)
 				template<typename RenderMode = rm_Triangles, typename Sp_Alloc>
 					inline void draw(const Mesh3D &obj, const ShaderProg<Sp_Alloc> &program)
 					{
 						if(obj.getIsIndexSet())
-							draw<RenderMode>(obj.getVArray(), program, obj.getIndex());
+							draw<RenderMode>(obj.getVArray(), program, obj.getIndex(), obj.getIndexFirst(), obj.getIndexCount());
 						else
-							draw<RenderMode>(obj.getVArray(), program, obj.getVertex());
+							draw<RenderMode>(obj.getVArray(), program, obj.getIsInterleaved() ? obj.getInterleaved() : obj.getVertex());
+					}
+
+				//skips the draw if the world bounds of the mesh are outside of frustum (Camera::getFrustum). returns false if culled
+				template<typename RenderMode = rm_Triangles, typename Sp_Alloc>
+					inline bool draw(const Mesh3D &obj, const ShaderProg<Sp_Alloc> &program, const Frustum &frustum)
+					{
+						if(!obj.isVisible(frustum))
+							return false;
+						draw<RenderMode>(obj, program);
+						return true;
 					}
 
 
-				template<typename RenderMode = rm_Triangles, typename Sp_Alloc, typename TexTarget, typename TexAlloc>
-					inline void draw(const Mesh3D &obj, const ShaderProg<Sp_Alloc> &program, const std::vector<std::tuple<Texture<TexTarget, TexAlloc>, std::size_t>> &tex_array)
+				//the submitted draw list of the pool in one call
+				template<typename RenderMode = rm_Triangles, typename Sp_Alloc>
+					void draw(const MeshPool &pool, const ShaderProg<Sp_Alloc> &program)
+					{
+						const std::size_t count = pool.getNumSubmitted();
+						if(count == 0)
+							return;
+						if(!GLEW_ARB_multi_draw_indirect && !(GLEW_ARB_base_instance || GLEW_VERSION_4_2))
+						{
+							std::cerr << "glDrawElementsInstancedBaseVertexBaseInstance isn't supported (GL 4.2 or ARB_base_instance). cannot draw" << std::endl;
+							return;
+						}
+						pool.getVArray().bind();
+						program.bind();
+						if(GLEW_ARB_multi_draw_indirect)
+						{
+							const auto &command_buffer = pool.getCommandBuffer();
+							command_buffer.bind();
+							glMultiDrawElementsIndirect(RenderMode::RENDER_MODE, GL_UNSIGNED_INT, NULL, count, 0);
+							CHECK_GL_ERROR;
+							command_buffer.unbind();
+						}
+						else
+						{
+							//the same commands, one call each
+							for(auto&& command : pool.getSubmittedCommands())
+							{
+								glDrawElementsInstancedBaseVertexBaseInstance(RenderMode::RENDER_MODE, command.count, GL_UNSIGNED_INT,
+										reinterpret_cast<const GLvoid*>(command.firstIndex*sizeof(GLuint)), command.instanceCount, command.baseVertex, command.baseInstance);
+								CHECK_GL_ERROR;
+							}
+						}
+						program.unbind();
+						pool.getVArray().unbind();
+					}
+
+				template<typename RenderMode = rm_Triangles, typename Sp_Alloc>
+					inline void drawInstanced(const Mesh3D &obj, const ShaderProg<Sp_Alloc> &program, GLsizei instances)
 					{
 						if(obj.getIsIndexSet())
-							draw<RenderMode>(obj.getVArray(), program, obj.getIndex(), tex_array);
+							drawInstanced<RenderMode>(obj.getVArray(), program, obj.getIndex(), obj.getIndexFirst(), obj.getIndexCount(), instances);
 						else
-							draw<RenderMode>(obj.getVArray(), program, obj.getVertex(), tex_array);
+							drawInstanced<RenderMode>(obj.getVArray(), program, obj.getIsInterleaved() ? obj.getInterleaved() : obj.getVertex(), instances);
+					}
+
+				//one instance per element of the buffers set by Mesh3D::setInstanceBuffer
+				template<typename RenderMode = rm_Triangles, typename Sp_Alloc>
+					inline void drawInstanced(const Mesh3D &obj, const ShaderProg<Sp_Alloc> &program)
+					{
+						if(obj.getNumInstance() == 0)
+						{
+							std::cerr << "instance buffer isn't set. cannot draw" << std::endl;
+							return;
+						}
+						drawInstanced<RenderMode>(obj, program, obj.getNumInstance());
+					}
+
+				template<typename RenderMode = rm_Triangles, typename Sp_Alloc, typename TexTarget, typename TexAlloc>
+					inline void draw(const Mesh3D &obj, const ShaderProg<Sp_Alloc> &program, const std::vector<std::tuple<Texture<TexTarget, TexAlloc>, std::size_t>> &tex_array)
+					{
+						for (auto&& var : tex_array) {
+							std::get<0>(var).bind(std::get<1>(var));
+						}
+
+						draw<RenderMode>(obj, program);
+
+						for(auto&& var : tex_array) {
+							std::get<0>(var).unbind();
+						}
 					}
 		};
 	} 
@@ -0,0 +1,337 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "gl_debug.h"
+#include "gl_file.h"
+#include "gl_thread.h"
+#include "gl_3D.h"
+
+namespace jikoLib{
+	namespace GLLib{
+
+		/**
+		 * MeshCache
+		 * cooked binary mesh file. the vertex/index blobs are stored as uploaded
+		 * (VertexPNT and GLuint), so the loader maps the file and passes the pointers to glBufferData.
+		 *
+		 * file layout (native endian):
+		 *   Header
+		 *   Attrib  x attrib_num   (the vertex layout. checked against VertexPNT)
+		 *   SubMesh x mesh_num     (ranges and bounds)
+		 *   vertex blob            (at vertex_offset, 16 byte aligned)
+		 *   index blob             (at index_offset, 16 byte aligned. indices are relative to base_vertex)
+		 *
+		 */
+
+		class MeshCache
+		{
+			public:
+				constexpr static std::uint32_t MAGIC = 0x48534D4Au; //"JMSH"
+				constexpr static std::uint32_t VERSION = 1;
+				constexpr static std::uint32_t ENDIAN = 0x01020304u;
+				constexpr static std::size_t BLOB_ALIGN = 16;
+
+				struct Header
+				{
+					std::uint32_t magic;
+					std::uint32_t version;
+					std::uint32_t endian;
+					std::uint32_t vertex_stride;
+					std::uint32_t attrib_num;
+					std::uint32_t mesh_num;
+					std::uint64_t vertex_num;
+					std::uint64_t index_num;
+					std::uint64_t vertex_offset;
+					std::uint64_t index_offset;
+					std::uint64_t file_size;
+					//stat of the source file when cooked
+					std::int64_t source_mtime;
+					std::uint64_t source_size;
+				};
+
+				struct Attrib
+				{
+					std::uint32_t location;
+					std::uint32_t dim;
+					std::uint32_t offset;
+					std::uint32_t type;
+				};
+
+				struct SubMesh
+				{
+					std::uint32_t base_vertex;
+					std::uint32_t vertex_num;
+					std::uint32_t first_index;
+					std::uint32_t index_num;
+					std::uint32_t material;
+					float bound_min[3];
+					float bound_max[3];
+					std::uint32_t reserved;
+				};
+
+				static_assert(sizeof(Header) == 80, "unexpected padding in MeshCache::Header");
+				static_assert(sizeof(SubMesh) == 48, "unexpected padding in MeshCache::SubMesh");
+
+			private:
+				MappedFile file;
+
+				const Header* header = nullptr;
+				const Attrib* attribs = nullptr;
+				const SubMesh* meshes = nullptr;
+
+				inline static std::size_t alignUp(std::size_t offset)
+				{
+					return (offset+BLOB_ALIGN-1)/BLOB_ALIGN*BLOB_ALIGN;
+				}
+
+				//the layout of VertexPNT
+				static std::vector<Attrib> vertexAttribs()
+				{
+					return {
+						{AttribLocation::VERTEX, 3, static_cast<std::uint32_t>(offsetof(VertexPNT, vertex)), GL_FLOAT},
+						{AttribLocation::NORMAL, 3, static_cast<std::uint32_t>(offsetof(VertexPNT, normal)), GL_FLOAT},
+						{AttribLocation::TEXCRD, 2, static_cast<std::uint32_t>(offsetof(VertexPNT, texcrd)), GL_FLOAT}
+					};
+				}
+
+				bool validate() const
+				{
+					const std::size_t map_size = file.size();
+					if(header->magic != MAGIC || header->version != VERSION || header->endian != ENDIAN)
+						return false;
+					if(header->file_size != map_size || header->vertex_stride != sizeof(VertexPNT))
+						return false;
+					//the counts are checked against the mapping before they are multiplied (a corrupt file cannot overflow the sums)
+					if(!file.contains(sizeof(Header), header->attrib_num, sizeof(Attrib)))
+						return false;
+					const std::uint64_t attrib_end = sizeof(Header) + static_cast<std::uint64_t>(header->attrib_num)*sizeof(Attrib);
+					if(!file.contains(attrib_end, header->mesh_num, sizeof(SubMesh)))
+						return false;
+					const std::uint64_t tables = attrib_end + static_cast<std::uint64_t>(header->mesh_num)*sizeof(SubMesh);
+					if(header->vertex_offset < tables || !file.contains(header->vertex_offset, header->vertex_num, sizeof(VertexPNT)))
+						return false;
+					const std::uint64_t vertex_end = header->vertex_offset + header->vertex_num*sizeof(VertexPNT);
+					if(header->index_offset < vertex_end || !file.contains(header->index_offset, header->index_num, sizeof(GLuint)))
+						return false;
+
+					std::vector<Attrib> expected = vertexAttribs();
+					if(header->attrib_num != expected.size())
+						return false;
+					for(std::size_t i = 0; i < expected.size(); i++)
+					{
+						if(std::memcmp(&attribs[i], &expected[i], sizeof(Attrib)) != 0)
+							return false;
+					}
+					for(std::size_t i = 0; i < header->mesh_num; i++)
+					{
+						if(header->vertex_num < static_cast<std::uint64_t>(meshes[i].base_vertex) + meshes[i].vertex_num ||
+								header->index_num < static_cast<std::uint64_t>(meshes[i].first_index) + meshes[i].index_num)
+							return false;
+					}
+					return true;
+				}
+
+			public:
+				MeshCache() {}
+
+				~MeshCache()
+				{
+					close();
+				}
+
+				MeshCache(const MeshCache&) = delete;
+				MeshCache& operator=(const MeshCache&) = delete;
+
+				//map the file. returns false if it is not a valid cache
+				bool open(const std::string &path)
+				{
+					close();
+					if(!file.open(path) || file.size() < sizeof(Header))
+					{
+						file.close();
+						return false;
+					}
+
+					header = reinterpret_cast<const Header*>(file.data());
+					attribs = reinterpret_cast<const Attrib*>(file.data() + sizeof(Header));
+					meshes = reinterpret_cast<const SubMesh*>(file.data() + sizeof(Header) + header->attrib_num*sizeof(Attrib));
+					if(!validate())
+					{
+						std::cerr << path << " is not a valid mesh cache" << std::endl;
+						close();
+						return false;
+					}
+					DEBUG_OUT("mesh cache " << path << " mapped. " << header->mesh_num << " meshes, " << file.size() << " B");
+					return true;
+				}
+
+				void close()
+				{
+					file.close();
+					header = nullptr;
+					attribs = nullptr;
+					meshes = nullptr;
+				}
+
+				inline bool isOpen() const
+				{
+					return file.isOpen();
+				}
+
+				inline const Header& getHeader() const
+				{
+					return *header;
+				}
+
+				inline std::size_t getNumMesh() const
+				{
+					return header->mesh_num;
+				}
+
+				inline const SubMesh& getMesh(std::size_t i) const
+				{
+					return meshes[i];
+				}
+
+				inline const VertexPNT* getVertices() const
+				{
+					return reinterpret_cast<const VertexPNT*>(file.data() + header->vertex_offset);
+				}
+
+				inline const GLuint* getIndices() const
+				{
+					return reinterpret_cast<const GLuint*>(file.data() + header->index_offset);
+				}
+
+				//one Mesh3D per submesh (straight from the mapping)
+				std::vector<Mesh3D> upload() const
+				{
+					std::vector<Mesh3D> result(getNumMesh());
+					for(std::size_t i = 0; i < getNumMesh(); i++)
+					{
+						const SubMesh &mesh = meshes[i];
+						if(mesh.vertex_num == 0 || mesh.index_num == 0)
+							continue;
+						result[i].copyData(getVertices()+mesh.base_vertex, mesh.vertex_num);
+						result[i].copyIndex(getIndices()+mesh.first_index, mesh.index_num);
+					}
+					return result;
+				}
+
+				//all submeshes in one pool (two glBufferData calls)
+				void upload(MeshPool &pool) const
+				{
+					std::vector<MeshPool::MeshRange> ranges(getNumMesh());
+					for(std::size_t i = 0; i < getNumMesh(); i++)
+					{
+						ranges[i].baseVertex = meshes[i].base_vertex;
+						ranges[i].firstIndex = meshes[i].first_index;
+						ranges[i].count = meshes[i].index_num;
+					}
+					pool.assign(getVertices(), header->vertex_num, getIndices(), header->index_num, ranges);
+				}
+
+				//cook the converted meshes into path (written to a temporary file and renamed)
+				static bool write(const std::string &path, const std::vector<MeshData> &data, std::int64_t source_mtime = 0, std::uint64_t source_size = 0)
+				{
+					std::vector<Attrib> attrib_table = vertexAttribs();
+					std::vector<SubMesh> mesh_table(data.size());
+					std::uint64_t vertex_num = 0;
+					std::uint64_t index_num = 0;
+					for(std::size_t i = 0; i < data.size(); i++)
+					{
+						SubMesh &mesh = mesh_table[i];
+						std::memset(&mesh, 0, sizeof(SubMesh));
+						mesh.base_vertex = vertex_num;
+						mesh.vertex_num = data[i].vertices.size();
+						mesh.first_index = index_num;
+						mesh.index_num = data[i].indices.size();
+						mesh.material = data[i].material;
+						for(int k = 0; k < 3; k++)
+						{
+							mesh.bound_min[k] = data[i].bound_min[k];
+							mesh.bound_max[k] = data[i].bound_max[k];
+						}
+						vertex_num += mesh.vertex_num;
+						index_num += mesh.index_num;
+					}
+
+					Header h;
+					std::memset(&h, 0, sizeof(Header));
+					h.magic = MAGIC;
+					h.version = VERSION;
+					h.endian = ENDIAN;
+					h.vertex_stride = sizeof(VertexPNT);
+					h.attrib_num = attrib_table.size();
+					h.mesh_num = mesh_table.size();
+					h.vertex_num = vertex_num;
+					h.index_num = index_num;
+					h.vertex_offset = alignUp(sizeof(Header) + attrib_table.size()*sizeof(Attrib) + mesh_table.size()*sizeof(SubMesh));
+					h.index_offset = alignUp(h.vertex_offset + vertex_num*sizeof(VertexPNT));
+					h.file_size = h.index_offset + index_num*sizeof(GLuint);
+					h.source_mtime = source_mtime;
+					h.source_size = source_size;
+
+					const bool written = writeFileAtomic(path, [&](std::ostream &out)
+							{
+							const char zero[BLOB_ALIGN] = {};
+							auto pad = [&](std::uint64_t offset)
+							{
+								out.write(zero, offset - static_cast<std::uint64_t>(out.tellp()));
+							};
+							out.write(reinterpret_cast<const char*>(&h), sizeof(Header));
+							out.write(reinterpret_cast<const char*>(attrib_table.data()), attrib_table.size()*sizeof(Attrib));
+							out.write(reinterpret_cast<const char*>(mesh_table.data()), mesh_table.size()*sizeof(SubMesh));
+							pad(h.vertex_offset);
+							for(auto&& mesh : data)
+								out.write(reinterpret_cast<const char*>(mesh.vertices.data()), mesh.vertices.size()*sizeof(VertexPNT));
+							pad(h.index_offset);
+							for(auto&& mesh : data)
+								out.write(reinterpret_cast<const char*>(mesh.indices.data()), mesh.indices.size()*sizeof(GLuint));
+							});
+					if(!written)
+						return false;
+					DEBUG_OUT("mesh cache " << path << " written. " << data.size() << " meshes, " << h.file_size << " B");
+					return true;
+				}
+
+				//true if the cache was cooked from the current source file
+				bool isUpToDate(const std::string &source) const
+				{
+					std::int64_t mtime;
+					std::uint64_t size;
+					if(!isOpen() || !sourceStat(source, mtime, size))
+						return false;
+					return header->source_mtime == mtime && header->source_size == size;
+				}
+
+				//open cache_path if it is up to date. otherwise load the source with Assimp and (re)write the cache.
+				//cache_path = "": source + ".jmesh"
+				bool load(const std::string &source, std::string cache_path = "", ThreadPool &pool = ThreadPool::getDefault())
+				{
+					if(cache_path == "")
+						cache_path = source + ".jmesh";
+					if(open(cache_path) && isUpToDate(source))
+						return true;
+					close();
+
+					std::int64_t mtime;
+					std::uint64_t size;
+					if(!sourceStat(source, mtime, size))
+					{
+						std::cerr << source << " cannot be found" << std::endl;
+						return false;
+					}
+					AssimpLoader loader(source, AssimpLoader::CONVERT_FLAGS);
+					if(loader.getScene() == nullptr)
+						return false;
+					if(!write(cache_path, loader.convert(pool), mtime, size))
+						return false;
+					return open(cache_path);
+				}
+		};
+	}
+}
@@ -0,0 +1,633 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+#include <climits>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <atomic>
+#include "gl_debug.h"
+#include "gl_file.h"
+#include "gl_thread.h"
+#include "gl_3D.h"
+
+namespace jikoLib{
+	namespace GLLib{
+
+		/**
+		 * ObjLoader
+		 * Wavefront OBJ reader without Assimp. the mapped file is split into line aligned chunks parsed on the pool,
+		 * then the v/vt/vn triples are deduplicated (hash sharded over the pool) into one indexed MeshData per group.
+		 * supports v, vt, vn, f (fan triangulated, negative indices), g, o and usemtl. the other lines are skipped.
+		 *
+		 */
+
+		class ObjLoader
+		{
+			private:
+				constexpr static GLint NONE = INT_MIN;
+				//meshes smaller than this are deduplicated on one thread
+				constexpr static std::size_t SHARD_MIN = 1 << 16;
+
+				struct Corner
+				{
+					GLint v;
+					GLint vt;
+					GLint vn;
+				};
+
+				//corner with relative indices (mask: 1 = v, 2 = vt, 4 = vn)
+				struct Relative
+				{
+					std::size_t corner;
+					unsigned int mask;
+				};
+
+				//g/o/usemtl line
+				struct Group
+				{
+					std::size_t first_corner;
+					std::string name;
+					bool is_material;
+				};
+
+				struct Chunk
+				{
+					const char* begin;
+					const char* end;
+					std::vector<GLfloat> v;
+					std::vector<GLfloat> vt;
+					std::vector<GLfloat> vn;
+					std::vector<Corner> corners;
+					std::vector<Relative> relatives;
+					std::vector<Group> groups;
+				};
+
+				struct MeshRange
+				{
+					std::size_t first;
+					std::size_t last;
+				};
+
+				//corners of a mesh whose hash falls into the shard
+				struct DedupTask
+				{
+					std::size_t mesh;
+					std::size_t shard;
+					std::size_t shard_num;
+					std::vector<GLuint> corners;
+					std::vector<GLuint> unique;
+					std::size_t offset;
+					bool no_normal;
+				};
+
+				std::vector<MeshData> meshes;
+				std::vector<std::string> materials;
+				bool flip_uv = true;
+
+				inline static bool isDigit(char c)
+				{
+					return static_cast<unsigned char>(c-'0') < 10;
+				}
+
+				inline static const char* skipSpace(const char* p, const char* end)
+				{
+					while(p < end && (*p == ' ' || *p == '\t'))
+						++p;
+					return p;
+				}
+
+				inline static double pow10(int e)
+				{
+					//exact in double
+					static const double table[] =
+					{
+						1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+						1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+					};
+					return (e <= 22) ? table[e] : std::pow(10.0, e);
+				}
+
+				//[+-]digits[.digits][(e|E)[+-]digits]. the digits go into one integer which is scaled once
+				//(correctly rounded for up to 15 significant digits and |exponent| <= 22. no strtod, no locale)
+				static const char* parseFloat(const char* p, const char* end, GLfloat &out)
+				{
+					p = skipSpace(p, end);
+					bool neg = false;
+					if(p < end && (*p == '-' || *p == '+'))
+					{
+						neg = (*p == '-');
+						++p;
+					}
+					std::uint64_t mantissa = 0;
+					int digits = 0;
+					int exp10 = 0;
+					for(; p < end && isDigit(*p); ++p)
+					{
+						if(digits < 19)
+						{
+							mantissa = mantissa*10 + (*p-'0');
+							digits += (mantissa != 0);
+						}
+						else
+							exp10++;
+					}
+					if(p < end && *p == '.')
+					{
+						for(++p; p < end && isDigit(*p); ++p)
+						{
+							if(digits < 19)
+							{
+								mantissa = mantissa*10 + (*p-'0');
+								digits += (mantissa != 0);
+								exp10--;
+							}
+						}
+					}
+					if(p < end && (*p == 'e' || *p == 'E'))
+					{
+						++p;
+						bool exp_neg = false;
+						if(p < end && (*p == '-' || *p == '+'))
+						{
+							exp_neg = (*p == '-');
+							++p;
+						}
+						int e = 0;
+						for(; p < end && isDigit(*p); ++p)
+						{
+							if(e < 10000)
+								e = e*10 + (*p-'0');
+						}
+						exp10 += exp_neg ? -e : e;
+					}
+					double value = static_cast<double>(mantissa);
+					if(mantissa == 0 || exp10 < -340)
+						value = 0.0;
+					else if(exp10 > 308)
+						value = HUGE_VAL;
+					else if(exp10 >= 0)
+						value *= pow10(exp10);
+					else if(exp10 >= -308)
+						value /= pow10(-exp10);
+					else
+						value = value/pow10(308)/pow10(-exp10-308);
+					out = static_cast<GLfloat>(neg ? -value : value);
+					return p;
+				}
+
+				static const char* parseInt(const char* p, const char* end, GLint &out)
+				{
+					bool neg = false;
+					if(p < end && (*p == '-' || *p == '+'))
+					{
+						neg = (*p == '-');
+						++p;
+					}
+					GLint value = 0;
+					for(; p < end && isDigit(*p); ++p)
+					{
+						value = value*10 + (*p-'0');
+					}
+					out = neg ? -value : value;
+					return p;
+				}
+
+				//raw OBJ index -> 0 based. a relative index is local to the chunk (made global in load())
+				inline static GLint toIndex(GLint raw, std::size_t count)
+				{
+					if(raw > 0)
+						return raw-1;
+					if(raw < 0)
+						return static_cast<GLint>(count) + raw;
+					return NONE;
+				}
+
+				inline static bool isKeyword(const char* p, const char* end, const char* keyword, std::size_t length)
+				{
+					return static_cast<std::size_t>(end-p) > length && std::memcmp(p, keyword, length) == 0 && (p[length] == ' ' || p[length] == '\t');
+				}
+
+				static void parseChunk(Chunk &chunk)
+				{
+					const char* p = chunk.begin;
+					const char* end = chunk.end;
+					std::vector<Corner> polygon;
+					std::vector<unsigned int> polygon_mask;
+					while(p < end)
+					{
+						const char* line_end = static_cast<const char*>(std::memchr(p, '\n', end-p));
+						if(line_end == nullptr)
+							line_end = end;
+						p = skipSpace(p, line_end);
+
+						if(isKeyword(p, line_end, "v", 1))
+						{
+							GLfloat x, y, z;
+							p = parseFloat(p+2, line_end, x);
+							p = parseFloat(p, line_end, y);
+							p = parseFloat(p, line_end, z);
+							chunk.v.insert(chunk.v.end(), {x, y, z});
+						}
+						else if(isKeyword(p, line_end, "vn", 2))
+						{
+							GLfloat x, y, z;
+							p = parseFloat(p+3, line_end, x);
+							p = parseFloat(p, line_end, y);
+							p = parseFloat(p, line_end, z);
+							chunk.vn.insert(chunk.vn.end(), {x, y, z});
+						}
+						else if(isKeyword(p, line_end, "vt", 2))
+						{
+							GLfloat s, t;
+							p = parseFloat(p+3, line_end, s);
+							p = parseFloat(p, line_end, t);
+							chunk.vt.insert(chunk.vt.end(), {s, t});
+						}
+						else if(isKeyword(p, line_end, "f", 1))
+						{
+							polygon.clear();
+							polygon_mask.clear();
+							bool relative = false;
+							p = skipSpace(p+2, line_end);
+							while(p < line_end && (isDigit(*p) || *p == '-'))
+							{
+								GLint raw_v = 0, raw_vt = 0, raw_vn = 0;
+								p = parseInt(p, line_end, raw_v);
+								if(p < line_end && *p == '/')
+								{
+									++p;
+									if(p < line_end && *p != '/')
+										p = parseInt(p, line_end, raw_vt);
+									if(p < line_end && *p == '/')
+										p = parseInt(p+1, line_end, raw_vn);
+								}
+								Corner corner;
+								corner.v = toIndex(raw_v, chunk.v.size()/3);
+								corner.vt = toIndex(raw_vt, chunk.vt.size()/2);
+								corner.vn = toIndex(raw_vn, chunk.vn.size()/3);
+								polygon.push_back(corner);
+								polygon_mask.push_back((raw_v < 0 ? 1 : 0) | (raw_vt < 0 ? 2 : 0) | (raw_vn < 0 ? 4 : 0));
+								relative = relative || polygon_mask.back() != 0;
+								p = skipSpace(p, line_end);
+							}
+							//fan
+							for(std::size_t i = 2; i < polygon.size(); i++)
+							{
+								if(relative)
+								{
+									const std::size_t base = chunk.corners.size();
+									const std::size_t fan[3] = {0, i-1, i};
+									for(std::size_t k = 0; k < 3; k++)
+									{
+										if(polygon_mask[fan[k]] != 0)
+											chunk.relatives.push_back({base+k, polygon_mask[fan[k]]});
+									}
+								}
+								chunk.corners.insert(chunk.corners.end(), {polygon[0], polygon[i-1], polygon[i]});
+							}
+						}
+						else if(isKeyword(p, line_end, "g", 1) || isKeyword(p, line_end, "o", 1) || isKeyword(p, line_end, "usemtl", 6))
+						{
+							const bool is_material = (*p == 'u');
+							const char* name_begin = skipSpace(p + (is_material ? 7 : 2), line_end);
+							const char* name_end = line_end;
+							while(name_end > name_begin && (name_end[-1] == '\r' || name_end[-1] == ' ' || name_end[-1] == '\t'))
+								--name_end;
+							chunk.groups.push_back({chunk.corners.size(), std::string(name_begin, name_end), is_material});
+						}
+						p = line_end+1;
+					}
+				}
+
+				inline static std::uint32_t hashCorner(const Corner &c)
+				{
+					std::uint32_t h = static_cast<std::uint32_t>(c.v)*0x9E3779B1u;
+					h ^= static_cast<std::uint32_t>(c.vt)*0x85EBCA77u + (h << 6) + (h >> 2);
+					h ^= static_cast<std::uint32_t>(c.vn)*0xC2B2AE3Du + (h << 6) + (h >> 2);
+					return h ^ (h >> 15);
+				}
+
+				inline static bool sameCorner(const Corner &a, const Corner &b)
+				{
+					return a.v == b.v && a.vt == b.vt && a.vn == b.vn;
+				}
+
+				//open addressing over the corners of the shard. corner_id[c] = index in task.unique
+				static void dedup(DedupTask &task, const MeshRange &range, const std::vector<Corner> &corners, std::vector<GLuint> &corner_id)
+				{
+					//the corners of the shard first: the table is sized from their count (load <= 0.5, so probing always ends)
+					for(std::size_t c = range.first; c < range.last; c++)
+					{
+						if(hashCorner(corners[c]) % task.shard_num == task.shard)
+							task.corners.push_back(c);
+					}
+					std::size_t capacity = 64;
+					while(capacity < 2*task.corners.size())
+						capacity <<= 1;
+					std::vector<GLuint> table(capacity, 0);
+					for(auto&& c : task.corners)
+					{
+						const std::uint32_t hash = hashCorner(corners[c]);
+						std::size_t slot = (hash / task.shard_num) & (capacity-1);
+						while(table[slot] != 0 && !sameCorner(corners[task.unique[table[slot]-1]], corners[c]))
+							slot = (slot+1) & (capacity-1);
+						if(table[slot] == 0)
+						{
+							task.unique.push_back(c);
+							table[slot] = task.unique.size();
+						}
+						corner_id[c] = table[slot]-1;
+					}
+				}
+
+			public:
+
+				ObjLoader() {}
+
+				explicit ObjLoader(const std::string &path, ThreadPool &pool = ThreadPool::getDefault())
+				{
+					load(path, pool);
+				}
+
+				//flip the v of the texture coordinate (like aiProcess_FlipUVs). default true
+				inline void setFlipUV(bool flag)
+				{
+					flip_uv = flag;
+				}
+
+				//one per g/o/usemtl group with faces. MeshData::material indexes getMaterials()
+				inline const std::vector<MeshData>& getMeshes() const
+				{
+					return meshes;
+				}
+
+				inline std::vector<MeshData>& getMeshes()
+				{
+					return meshes;
+				}
+
+				//usemtl names in the order of appearance
+				inline const std::vector<std::string>& getMaterials() const
+				{
+					return materials;
+				}
+
+				//GL upload (call on the context thread)
+				inline std::vector<Mesh3D> upload() const
+				{
+					return uploadMeshData(meshes);
+				}
+
+				bool load(const std::string &path, ThreadPool &pool = ThreadPool::getDefault())
+				{
+					meshes.clear();
+					materials.clear();
+					MappedFile file;
+					if(!file.open(path))
+					{
+						std::cerr << path << " cannot be opened --did nothing" << std::endl;
+						return false;
+					}
+
+					//line aligned chunks (more than the threads for the balance, 64KB at least)
+					const std::size_t chunk_num = std::max<std::size_t>(1, std::min<std::size_t>(pool.size()*4, file.size()/(64*1024)));
+					std::vector<Chunk> chunks(chunk_num);
+					const char* begin = file.data();
+					const char* file_end = file.data()+file.size();
+					for(std::size_t i = 0; i < chunk_num; i++)
+					{
+						const char* end = file_end;
+						if(i+1 < chunk_num)
+						{
+							end = std::max(begin, file.data()+file.size()/chunk_num*(i+1));
+							const char* newline = static_cast<const char*>(std::memchr(end, '\n', file_end-end));
+							end = (newline == nullptr) ? file_end : newline+1;
+						}
+						chunks[i].begin = begin;
+						chunks[i].end = end;
+						begin = end;
+					}
+
+					pool.parallelFor(chunk_num, [&chunks](std::size_t i)
+							{
+							parseChunk(chunks[i]);
+							});
+
+					//offsets of the chunks
+					std::vector<std::size_t> v_offset(chunk_num+1, 0), vt_offset(chunk_num+1, 0), vn_offset(chunk_num+1, 0), corner_offset(chunk_num+1, 0);
+					for(std::size_t i = 0; i < chunk_num; i++)
+					{
+						v_offset[i+1] = v_offset[i] + chunks[i].v.size()/3;
+						vt_offset[i+1] = vt_offset[i] + chunks[i].vt.size()/2;
+						vn_offset[i+1] = vn_offset[i] + chunks[i].vn.size()/3;
+						corner_offset[i+1] = corner_offset[i] + chunks[i].corners.size();
+					}
+					const std::size_t corner_num = corner_offset[chunk_num];
+					if(corner_num == 0 || v_offset[chunk_num] == 0)
+					{
+						std::cerr << path << " has no face --did nothing" << std::endl;
+						return false;
+					}
+
+					//meshes (g/o/usemtl lines in the file order. the empty ones are dropped)
+					std::vector<MeshRange> ranges;
+					{
+						std::string name;
+						unsigned int material = 0;
+						std::size_t first = 0;
+						auto close = [&](std::size_t last)
+						{
+							if(last > first)
+							{
+								ranges.push_back({first, last});
+								meshes.emplace_back();
+								meshes.back().name = name;
+								meshes.back().material = material;
+							}
+							first = last;
+						};
+						for(std::size_t i = 0; i < chunk_num; i++)
+						{
+							for(auto&& group : chunks[i].groups)
+							{
+								close(corner_offset[i] + group.first_corner);
+								if(group.is_material)
+								{
+									auto found = std::find(materials.begin(), materials.end(), group.name);
+									material = found - materials.begin();
+									if(found == materials.end())
+										materials.push_back(group.name);
+								}
+								else
+									name = group.name;
+							}
+						}
+						close(corner_num);
+					}
+
+					//merge the attributes and make the indices global
+					std::vector<GLfloat> v(v_offset[chunk_num]*3), vt(vt_offset[chunk_num]*2), vn(vn_offset[chunk_num]*3);
+					std::vector<Corner> corners(corner_num);
+					std::atomic<std::size_t> invalid(0);
+					pool.parallelFor(chunk_num, [&](std::size_t i)
+							{
+							Chunk &chunk = chunks[i];
+							std::copy(chunk.v.begin(), chunk.v.end(), v.begin()+v_offset[i]*3);
+							std::copy(chunk.vt.begin(), chunk.vt.end(), vt.begin()+vt_offset[i]*2);
+							std::copy(chunk.vn.begin(), chunk.vn.end(), vn.begin()+vn_offset[i]*3);
+							Corner* out = corners.data()+corner_offset[i];
+							std::copy(chunk.corners.begin(), chunk.corners.end(), out);
+							for(auto&& rel : chunk.relatives)
+							{
+								Corner &corner = out[rel.corner];
+								if(rel.mask & 1)
+									corner.v += v_offset[i];
+								if(rel.mask & 2)
+									corner.vt += vt_offset[i];
+								if(rel.mask & 4)
+									corner.vn += vn_offset[i];
+							}
+							//out of range: the first position, no texcoord/normal
+							std::size_t bad = 0;
+							for(std::size_t c = 0; c < chunk.corners.size(); c++)
+							{
+								Corner &corner = out[c];
+								if(corner.v < 0 || static_cast<std::size_t>(corner.v) >= v_offset[chunk_num])
+								{
+									corner.v = 0;
+									bad++;
+								}
+								if(corner.vt != NONE && (corner.vt < 0 || static_cast<std::size_t>(corner.vt) >= vt_offset[chunk_num]))
+								{
+									corner.vt = NONE;
+									bad++;
+								}
+								if(corner.vn != NONE && (corner.vn < 0 || static_cast<std::size_t>(corner.vn) >= vn_offset[chunk_num]))
+								{
+									corner.vn = NONE;
+									bad++;
+								}
+							}
+							invalid += bad;
+							std::vector<GLfloat>().swap(chunk.v);
+							std::vector<GLfloat>().swap(chunk.vt);
+							std::vector<GLfloat>().swap(chunk.vn);
+							std::vector<Corner>().swap(chunk.corners);
+							});
+					if(invalid != 0)
+						std::cerr << path << ": " << invalid << " face indices are out of range" << std::endl;
+
+					//deduplication. the large meshes are split into shards, the heavy tasks go first
+					std::vector<DedupTask> tasks;
+					{
+						std::vector<std::size_t> order(ranges.size());
+						for(std::size_t m = 0; m < order.size(); m++)
+							order[m] = m;
+						std::sort(order.begin(), order.end(), [&ranges](std::size_t a, std::size_t b)
+								{
+								return ranges[a].last-ranges[a].first > ranges[b].last-ranges[b].first;
+								});
+						for(auto&& m : order)
+						{
+							const std::size_t shard_num = (ranges[m].last-ranges[m].first >= SHARD_MIN) ? pool.size() : 1;
+							for(std::size_t s = 0; s < shard_num; s++)
+							{
+								DedupTask task;
+								task.mesh = m;
+								task.shard = s;
+								task.shard_num = shard_num;
+								task.offset = 0;
+								task.no_normal = false;
+								tasks.push_back(std::move(task));
+							}
+						}
+					}
+					std::vector<GLuint> corner_id(corner_num);
+					pool.parallelFor(tasks.size(), [&](std::size_t t)
+							{
+							dedup(tasks[t], ranges[tasks[t].mesh], corners, corner_id);
+							});
+
+					//the shards of a mesh are laid out in order
+					{
+						std::vector<std::size_t> vertex_num(meshes.size(), 0);
+						for(std::size_t s = 0; s < pool.size(); s++)
+						{
+							for(auto&& task : tasks)
+							{
+								if(task.shard != s)
+									continue;
+								task.offset = vertex_num[task.mesh];
+								vertex_num[task.mesh] += task.unique.size();
+							}
+						}
+						for(std::size_t m = 0; m < meshes.size(); m++)
+						{
+							meshes[m].vertices.resize(vertex_num[m]);
+							meshes[m].indices.resize(ranges[m].last-ranges[m].first);
+						}
+					}
+
+					pool.parallelFor(tasks.size(), [&](std::size_t t)
+							{
+							DedupTask &task = tasks[t];
+							MeshData &mesh = meshes[task.mesh];
+							for(std::size_t k = 0; k < task.unique.size(); k++)
+							{
+								const Corner &corner = corners[task.unique[k]];
+								VertexPNT &vertex = mesh.vertices[task.offset+k];
+								std::copy(&v[corner.v*3], &v[corner.v*3]+3, vertex.vertex);
+								if(corner.vn != NONE)
+									std::copy(&vn[corner.vn*3], &vn[corner.vn*3]+3, vertex.normal);
+								else
+								{
+									std::fill(vertex.normal, vertex.normal+3, 0.0f);
+									task.no_normal = true;
+								}
+								if(corner.vt != NONE)
+								{
+									vertex.texcrd[0] = vt[corner.vt*2];
+									vertex.texcrd[1] = flip_uv ? 1.0f-vt[corner.vt*2+1] : vt[corner.vt*2+1];
+								}
+								else
+									std::fill(vertex.texcrd, vertex.texcrd+2, 0.0f);
+							}
+							const std::size_t first = ranges[task.mesh].first;
+							for(auto&& c : task.corners)
+							{
+								mesh.indices[c-first] = task.offset + corner_id[c];
+							}
+							});
+
+					//normals (when the file has none) and bounds
+					std::vector<bool> no_normal(meshes.size(), false);
+					for(auto&& task : tasks)
+					{
+						if(task.no_normal)
+							no_normal[task.mesh] = true;
+					}
+					pool.parallelFor(meshes.size(), [&](std::size_t m)
+							{
+							MeshData &mesh = meshes[m];
+							if(no_normal[m])
+								computeSmoothNormals(mesh.vertices, mesh.indices);
+							mesh.bound_min = glm::vec3(mesh.vertices[0].vertex[0], mesh.vertices[0].vertex[1], mesh.vertices[0].vertex[2]);
+							mesh.bound_max = mesh.bound_min;
+							for(auto&& vertex : mesh.vertices)
+							{
+								glm::vec3 position(vertex.vertex[0], vertex.vertex[1], vertex.vertex[2]);
+								mesh.bound_min = glm::min(mesh.bound_min, position);
+								mesh.bound_max = glm::max(mesh.bound_max, position);
+							}
+							});
+
+					DEBUG_OUT(path << " parsed. " << meshes.size() << " meshes, " << corner_num/3 << " triangles in " << chunk_num << " chunks");
+					return true;
+				}
+		};
+	}
+}
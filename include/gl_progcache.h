@@ -0,0 +1,256 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <utility>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include "gl_debug.h"
+#include "gl_helper.h"
+#include "gl_base.h"
+#include "gl_file.h"
+
+namespace jikoLib{
+	namespace GLLib{
+
+		/**
+		 * ProgramCache
+		 * linked programs on disk (glGetProgramBinary/glProgramBinary). the key is the hash of the sources, the vertex layout
+		 * and the driver (vendor, renderer, version). a missing, stale or rejected binary falls back to the compile and is written again.
+		 * construct it after the context is made current.
+		 *
+		 */
+
+		class ProgramCache
+		{
+			public:
+				constexpr static std::uint32_t MAGIC = 0x4752504Au; //"JPRG"
+				constexpr static std::uint32_t VERSION = 1;
+
+				//shader type (GL_VERTEX_SHADER etc.) and source
+				using Source = std::pair<GLenum, std::string>;
+
+				struct Header
+				{
+					std::uint32_t magic;
+					std::uint32_t version;
+					std::uint32_t format;
+					std::uint32_t length;
+					std::uint64_t key;
+					std::uint64_t driver;
+				};
+				static_assert(sizeof(Header) == 32, "unexpected padding in ProgramCache::Header");
+
+			private:
+				std::string directory;
+				bool supported = false;
+				std::uint64_t driver = 0;
+				std::size_t hits = 0;
+				std::size_t misses = 0;
+
+				//FNV-1a 64
+				inline static std::uint64_t hash(const void* data, std::size_t size, std::uint64_t h = 14695981039346656037ull)
+				{
+					const unsigned char* p = static_cast<const unsigned char*>(data);
+					for(std::size_t i = 0; i < size; i++)
+						h = (h ^ p[i]) * 1099511628211ull;
+					return h;
+				}
+
+				inline static std::uint64_t hash(const std::string &str, std::uint64_t h)
+				{
+					//the length separates the strings
+					const std::uint64_t length = str.size();
+					return hash(str.data(), str.size(), hash(&length, sizeof(length), h));
+				}
+
+				inline static std::string glString(GLenum name)
+				{
+					const GLubyte* str = glGetString(name);
+					return (str == nullptr) ? std::string() : std::string(reinterpret_cast<const char*>(str));
+				}
+
+				template<typename Shader_type, typename Allocator>
+					static bool compile(ShaderProg<Allocator> &program, const std::string &source)
+					{
+						Shader<Shader_type> shader;
+						shader << source;
+						if(!shader.getIsCompiled())
+							return false;
+						program << shader;
+						return true;
+					}
+
+				template<typename Allocator>
+					static bool compile(ShaderProg<Allocator> &program, const Source &source)
+					{
+						switch(source.first)
+						{
+							case GL_VERTEX_SHADER: return compile<VertexShader>(program, source.second);
+							case GL_FRAGMENT_SHADER: return compile<FragmentShader>(program, source.second);
+							case GL_GEOMETRY_SHADER: return compile<GeometryShader>(program, source.second);
+							default:
+								std::cerr << "unknown shader type " << source.first << " --did nothing" << std::endl;
+								return false;
+						}
+					}
+
+			public:
+				explicit ProgramCache(const std::string &directory = "shader_cache")
+					:directory(directory)
+				{
+					GLint formats = 0;
+					if(GLEW_VERSION_4_1 || GLEW_ARB_get_program_binary)
+					{
+						glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+						CHECK_GL_ERROR;
+					}
+					supported = (formats > 0);
+					driver = hash(glString(GL_VENDOR), 14695981039346656037ull);
+					driver = hash(glString(GL_RENDERER), driver);
+					driver = hash(glString(GL_VERSION), driver);
+					driver = hash(glString(GL_SHADING_LANGUAGE_VERSION), driver);
+					if(supported)
+						mkdir(directory.c_str(), 0755);
+					else
+						DEBUG_OUT("program binary is not supported. ProgramCache compiles every time");
+				}
+
+				ProgramCache(const ProgramCache&) = delete;
+				ProgramCache& operator=(const ProgramCache&) = delete;
+
+				inline bool isSupported() const
+				{
+					return supported;
+				}
+
+				inline std::size_t getHits() const
+				{
+					return hits;
+				}
+
+				inline std::size_t getMisses() const
+				{
+					return misses;
+				}
+
+				std::uint64_t key(const std::vector<Source> &sources, const VertexLayout &layout = VertexLayout()) const
+				{
+					std::uint64_t h = hash(&driver, sizeof(driver));
+					for(auto&& source : sources)
+					{
+						const std::uint64_t type = source.first;
+						h = hash(source.second, hash(&type, sizeof(type), h));
+					}
+					for(auto&& attr : layout.getAttribs())
+					{
+						const std::uint64_t location = attr.first;
+						h = hash(attr.second, hash(&location, sizeof(location), h));
+					}
+					return h;
+				}
+
+				std::string path(std::uint64_t key) const
+				{
+					char name[32];
+					std::snprintf(name, sizeof(name), "%016llx.jprg", static_cast<unsigned long long>(key));
+					return directory + "/" + name;
+				}
+
+				//link program from the binary of key. a stale or rejected file is removed
+				template<typename Allocator>
+					bool load(ShaderProg<Allocator> &program, std::uint64_t key) const
+					{
+						if(!supported)
+							return false;
+						const std::string file_path = path(key);
+						MappedFile file;
+						if(!file.open(file_path))
+							return false;
+						bool loaded = false;
+						if(file.size() >= sizeof(Header))
+						{
+							const Header* header = reinterpret_cast<const Header*>(file.data());
+							if(header->magic == MAGIC && header->version == VERSION && header->key == key && header->driver == driver &&
+									header->length == file.size()-sizeof(Header))
+								loaded = program.programBinary(header->format, file.data()+sizeof(Header), header->length);
+						}
+						file.close();
+						if(!loaded)
+						{
+							DEBUG_OUT("program cache " << file_path << " is stale. removed");
+							std::remove(file_path.c_str());
+						}
+						return loaded;
+					}
+
+				//write the binary of the linked program (to a temporary file and renamed)
+				template<typename Allocator>
+					bool store(const ShaderProg<Allocator> &program, std::uint64_t key) const
+					{
+						if(!supported)
+							return false;
+						GLenum format;
+						std::vector<GLubyte> binary;
+						if(!program.getProgramBinary(format, binary))
+						{
+							std::cerr << "program binary cannot be retrieved --did nothing" << std::endl;
+							return false;
+						}
+						Header h;
+						h.magic = MAGIC;
+						h.version = VERSION;
+						h.format = format;
+						h.length = binary.size();
+						h.key = key;
+						h.driver = driver;
+
+						const std::string file_path = path(key);
+						const bool written = writeFileAtomic(file_path, [&](std::ostream &out)
+								{
+								out.write(reinterpret_cast<const char*>(&h), sizeof(Header));
+								out.write(reinterpret_cast<const char*>(binary.data()), binary.size());
+								});
+						if(!written)
+							return false;
+						DEBUG_OUT("program cache " << file_path << " written. " << binary.size() << " B");
+						return true;
+					}
+
+				//link program from the cache, or compile and link the sources (with layout) and store the binary.
+				//returns false if the compile or the link failed
+				template<typename Allocator>
+					bool build(ShaderProg<Allocator> &program, const std::vector<Source> &sources, const VertexLayout &layout = VertexLayout())
+					{
+						const std::uint64_t k = key(sources, layout);
+						if(load(program, k))
+						{
+							hits++;
+							return true;
+						}
+						misses++;
+						for(auto&& source : sources)
+						{
+							if(!compile(program, source))
+								return false;
+						}
+						if(supported)
+							program.setBinaryRetrievable();
+						program << layout << link_these();
+						if(!program.getIsLinked())
+							return false;
+						store(program, k);
+						return true;
+					}
+
+				template<typename Allocator>
+					inline bool build(ShaderProg<Allocator> &program, const std::string &vsource, const std::string &fsource, const VertexLayout &layout = VertexLayout())
+					{
+						return build(program, {Source(GL_VERTEX_SHADER, vsource), Source(GL_FRAGMENT_SHADER, fsource)}, layout);
+					}
+		};
+	}
+}
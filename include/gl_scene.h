@@ -0,0 +1,273 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <utility>
+#include <glm/glm.hpp>
+#include <assimp/scene.h>
+#include "gl_debug.h"
+#include "gl_transform.h"
+
+namespace jikoLib{
+	namespace GLLib{
+
+		/**
+		 * SceneGraph
+		 * node hierarchy stored in depth first order: a parent is always before its children and
+		 * the subtree of node i is [i, getSubtreeEnd(i)). the local and world matrices are contiguous arrays.
+		 * update() recomputes the world matrices of the changed subtrees in one pass from the front,
+		 * jumping over the subtrees without a change. inserting a node in the middle moves the indices after it.
+		 *
+		 */
+
+		class SceneGraph
+		{
+			public:
+				constexpr static std::size_t NONE = static_cast<std::size_t>(-1);
+
+			private:
+				struct NodeInfo
+				{
+					std::string name;
+					//indices of the meshes (e.g. aiScene::mMeshes or the result of AssimpLoader::convert)
+					std::vector<unsigned int> meshes;
+				};
+
+				//hot data, in the depth first order
+				std::vector<glm::mat4> local;
+				std::vector<glm::mat4> world;
+				std::vector<std::int32_t> parents;
+				std::vector<std::uint32_t> ends;
+				//local changed / something in the subtree changed / world recomputed in the last update
+				std::vector<std::uint8_t> dirty;
+				std::vector<std::uint8_t> subtree_dirty;
+				std::vector<std::uint8_t> changed;
+				//cold data
+				std::vector<NodeInfo> info;
+
+				std::size_t updated = 0;
+
+				//flag the way down to node (stops at the first ancestor already flagged)
+				inline void markSubtreeDirty(std::size_t node)
+				{
+					for(std::int32_t i = node; i >= 0 && !subtree_dirty[i]; i = parents[i])
+						subtree_dirty[i] = 1;
+				}
+
+				//flag node and its ancestors
+				inline void markDirty(std::size_t node)
+				{
+					dirty[node] = 1;
+					markSubtreeDirty(node);
+				}
+
+				//splice a depth first block of nodes under parent (block parents: -1 = parent, otherwise index in the block)
+				std::size_t insert(std::size_t parent, std::vector<glm::mat4> &&block_local, const std::vector<std::int32_t> &block_parents,
+						const std::vector<std::uint32_t> &block_ends, std::vector<NodeInfo> &&block_info)
+				{
+					const std::size_t n = size();
+					const std::size_t k = block_parents.size();
+					const std::size_t pos = (parent == NONE) ? n : ends[parent];
+					for(std::size_t j = pos; j < n; j++)
+					{
+						ends[j] += k;
+						if(parents[j] >= static_cast<std::int32_t>(pos))
+							parents[j] += k;
+					}
+					for(std::int32_t a = (parent == NONE) ? -1 : static_cast<std::int32_t>(parent); a >= 0; a = parents[a])
+						ends[a] += k;
+
+					std::vector<std::int32_t> new_parents(k);
+					std::vector<std::uint32_t> new_ends(k);
+					for(std::size_t b = 0; b < k; b++)
+					{
+						new_parents[b] = (block_parents[b] < 0) ? ((parent == NONE) ? -1 : static_cast<std::int32_t>(parent)) : pos + block_parents[b];
+						new_ends[b] = pos + block_ends[b];
+					}
+					local.insert(local.begin()+pos, block_local.begin(), block_local.end());
+					world.insert(world.begin()+pos, k, glm::mat4(1.0f));
+					parents.insert(parents.begin()+pos, new_parents.begin(), new_parents.end());
+					ends.insert(ends.begin()+pos, new_ends.begin(), new_ends.end());
+					dirty.insert(dirty.begin()+pos, k, 1);
+					subtree_dirty.insert(subtree_dirty.begin()+pos, k, 1);
+					changed.insert(changed.begin()+pos, k, 0);
+					info.insert(info.begin()+pos, std::make_move_iterator(block_info.begin()), std::make_move_iterator(block_info.end()));
+					//the new nodes are dirty already, the parent and its other children are not
+					if(parent != NONE)
+						markSubtreeDirty(parent);
+					return pos;
+				}
+
+				inline static glm::mat4 toMat4(const aiMatrix4x4 &m)
+				{
+					//aiMatrix4x4 is row major
+					return glm::mat4(
+							glm::vec4(m.a1, m.b1, m.c1, m.d1),
+							glm::vec4(m.a2, m.b2, m.c2, m.d2),
+							glm::vec4(m.a3, m.b3, m.c3, m.d3),
+							glm::vec4(m.a4, m.b4, m.c4, m.d4));
+				}
+
+			public:
+				SceneGraph() {}
+
+				inline std::size_t size() const
+				{
+					return parents.size();
+				}
+
+				//add a node as the last child of parent (NONE: a new root). returns the index of the node
+				std::size_t addNode(const std::string &name, std::size_t parent = NONE, const glm::mat4 &matrix = glm::mat4(1.0f))
+				{
+					std::vector<NodeInfo> block_info(1);
+					block_info[0].name = name;
+					return insert(parent, std::vector<glm::mat4>(1, matrix), std::vector<std::int32_t>(1, -1), std::vector<std::uint32_t>(1, 1), std::move(block_info));
+				}
+
+				//the node hierarchy of scene under parent. mesh_offset is added to the mesh indices
+				//(to share one mesh list between scenes). returns the index of the imported root
+				std::size_t import(const aiScene* scene, std::size_t parent = NONE, unsigned int mesh_offset = 0)
+				{
+					if(scene == nullptr || scene->mRootNode == nullptr)
+					{
+						std::cerr << "scene is not loaded --did nothing" << std::endl;
+						return NONE;
+					}
+					std::vector<glm::mat4> block_local;
+					std::vector<std::int32_t> block_parents;
+					std::vector<std::uint32_t> block_ends;
+					std::vector<NodeInfo> block_info;
+					//depth first with an explicit stack (node, parent in the block). the children are pushed in reverse to keep their order
+					std::vector<std::pair<const aiNode*, std::int32_t>> stack(1, std::make_pair(scene->mRootNode, -1));
+					while(!stack.empty())
+					{
+						const aiNode* node = stack.back().first;
+						const std::int32_t node_parent = stack.back().second;
+						stack.pop_back();
+						const std::int32_t index = block_parents.size();
+						block_local.push_back(toMat4(node->mTransformation));
+						block_parents.push_back(node_parent);
+						block_ends.push_back(0);
+						block_info.emplace_back();
+						block_info.back().name = node->mName.C_Str();
+						for(unsigned int m = 0; m < node->mNumMeshes; m++)
+							block_info.back().meshes.push_back(node->mMeshes[m] + mesh_offset);
+						for(unsigned int c = node->mNumChildren; c > 0; c--)
+							stack.push_back(std::make_pair(node->mChildren[c-1], index));
+					}
+					//subtree ends from the back: a node ends where its last descendant ends
+					for(std::size_t b = block_parents.size(); b > 0; b--)
+					{
+						const std::size_t i = b-1;
+						if(block_ends[i] < i+1)
+							block_ends[i] = i+1;
+						if(block_parents[i] >= 0 && block_ends[block_parents[i]] < block_ends[i])
+							block_ends[block_parents[i]] = block_ends[i];
+					}
+					DEBUG_OUT(block_parents.size() << " nodes imported");
+					return insert(parent, std::move(block_local), block_parents, block_ends, std::move(block_info));
+				}
+
+				inline void addMesh(std::size_t node, unsigned int mesh)
+				{
+					info[node].meshes.push_back(mesh);
+				}
+
+				inline void setLocal(std::size_t node, const glm::mat4 &matrix)
+				{
+					local[node] = matrix;
+					markDirty(node);
+				}
+
+				inline void setLocal(std::size_t node, const Transform &transform)
+				{
+					setLocal(node, transform.getMatrix());
+				}
+
+				inline const glm::mat4& getLocal(std::size_t node) const
+				{
+					return local[node];
+				}
+
+				//valid after update
+				inline const glm::mat4& getWorld(std::size_t node) const
+				{
+					return world[node];
+				}
+
+				inline const glm::mat4* getWorldMatrices() const
+				{
+					return world.data();
+				}
+
+				//NONE for a root
+				inline std::size_t getParent(std::size_t node) const
+				{
+					return (parents[node] < 0) ? NONE : static_cast<std::size_t>(parents[node]);
+				}
+
+				inline std::size_t getSubtreeEnd(std::size_t node) const
+				{
+					return ends[node];
+				}
+
+				inline const std::string& getName(std::size_t node) const
+				{
+					return info[node].name;
+				}
+
+				inline const std::vector<unsigned int>& getMeshes(std::size_t node) const
+				{
+					return info[node].meshes;
+				}
+
+				//first node named name, or NONE
+				std::size_t find(const std::string &name) const
+				{
+					for(std::size_t i = 0; i < info.size(); i++)
+					{
+						if(info[i].name == name)
+							return i;
+					}
+					return NONE;
+				}
+
+				//world matrices of the changed nodes and their descendants
+				void update()
+				{
+					const std::size_t n = size();
+					updated = 0;
+					std::size_t i = 0;
+					while(i < n)
+					{
+						const std::int32_t p = parents[i];
+						const bool parent_changed = (p >= 0) && changed[p];
+						if(!subtree_dirty[i] && !parent_changed)
+						{
+							i = ends[i];
+							continue;
+						}
+						if(dirty[i] || parent_changed)
+						{
+							world[i] = (p >= 0) ? world[p]*local[i] : local[i];
+							changed[i] = 1;
+							updated++;
+						}
+						else
+							changed[i] = 0;
+						dirty[i] = 0;
+						subtree_dirty[i] = 0;
+						i++;
+					}
+				}
+
+				//world matrices recomputed by the last update
+				inline std::size_t getNumUpdated() const
+				{
+					return updated;
+				}
+		};
+	}
+}
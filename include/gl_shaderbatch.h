@@ -0,0 +1,244 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "gl_debug.h"
+#include "gl_helper.h"
+#include "gl_base.h"
+#include "gl_progcache.h"
+
+namespace jikoLib{
+	namespace GLLib{
+
+		/**
+		 * ShaderBatch
+		 * compiles and links many programs without a sync point per shader. submit() issues all the compiles,
+		 * then all the links, and the results are collected later by poll() (once per frame) or finish().
+		 * with KHR_parallel_shader_compile the driver works on them in its own threads and poll() does not block.
+		 * the errors of the batch are reported together. the programs must stay at the same address until they are done.
+		 *
+		 */
+
+		class ShaderBatch
+		{
+			public:
+				using Source = ProgramCache::Source;
+
+				enum Status
+				{
+					QUEUED,
+					COMPILING,
+					LINKED,
+					FAILED
+				};
+
+			private:
+				struct Entry
+				{
+					ShaderProgram* program;
+					std::vector<Source> sources;
+					VertexLayout layout;
+					std::uint64_t key = 0;
+					Status status = QUEUED;
+					//alive until the link is checked (for the compile log)
+					std::vector<VShader> vshaders;
+					std::vector<FShader> fshaders;
+					std::vector<Shader<GeometryShader>> gshaders;
+				};
+
+				ProgramCache* cache;
+				std::vector<Entry> entries;
+				std::size_t pending = 0;
+				std::size_t failed = 0;
+				std::size_t cached = 0;
+
+				inline static bool hasParallel()
+				{
+					static const bool has = GLEW_KHR_parallel_shader_compile || GLEW_ARB_parallel_shader_compile;
+					return has;
+				}
+
+				template<typename Shader_type>
+					static void submitShader(std::vector<Shader<Shader_type>> &shaders, const std::string &source)
+					{
+						shaders.emplace_back();
+						shaders.back().submit(source);
+					}
+
+				template<typename Shader_type>
+					static bool checkShaders(std::vector<Shader<Shader_type>> &shaders)
+					{
+						bool compiled = true;
+						for(auto&& shader : shaders)
+							compiled = shader.checkCompile() && compiled;
+						return compiled;
+					}
+
+				//the link is complete: collect the result
+				void finalize(Entry &entry)
+				{
+					bool compiled = checkShaders(entry.vshaders);
+					compiled = checkShaders(entry.fshaders) && compiled;
+					compiled = checkShaders(entry.gshaders) && compiled;
+					if(compiled && entry.program->checkLink())
+					{
+						entry.status = LINKED;
+						if(cache != nullptr)
+							cache->store(*entry.program, entry.key);
+					}
+					else
+					{
+						entry.status = FAILED;
+						failed++;
+					}
+					entry.vshaders.clear();
+					entry.fshaders.clear();
+					entry.gshaders.clear();
+					pending--;
+				}
+
+			public:
+				//cache: programs are linked from (and stored to) it when it is given
+				explicit ShaderBatch(ProgramCache* cache = nullptr)
+					:cache(cache)
+				{
+				}
+
+				ShaderBatch(const ShaderBatch&) = delete;
+				ShaderBatch& operator=(const ShaderBatch&) = delete;
+
+				//number of the compiler threads of the driver (0xFFFFFFFF: the driver decides)
+				static void setMaxThreads(GLuint count = 0xFFFFFFFFu)
+				{
+					if(GLEW_KHR_parallel_shader_compile)
+						glMaxShaderCompilerThreadsKHR(count);
+					else if(GLEW_ARB_parallel_shader_compile)
+						glMaxShaderCompilerThreadsARB(count);
+					else
+						return;
+					CHECK_GL_ERROR;
+				}
+
+				//returns the index of the program in the batch
+				std::size_t add(ShaderProgram &program, const std::vector<Source> &sources, const VertexLayout &layout = VertexLayout())
+				{
+					Entry entry;
+					entry.program = &program;
+					entry.sources = sources;
+					entry.layout = layout;
+					entries.push_back(std::move(entry));
+					return entries.size()-1;
+				}
+
+				inline std::size_t add(ShaderProgram &program, const std::string &vsource, const std::string &fsource, const VertexLayout &layout = VertexLayout())
+				{
+					return add(program, {Source(GL_VERTEX_SHADER, vsource), Source(GL_FRAGMENT_SHADER, fsource)}, layout);
+				}
+
+				//issue the compiles of all the queued programs, then their links. nothing is waited for here
+				void submit()
+				{
+					for(auto&& entry : entries)
+					{
+						if(entry.status != QUEUED)
+							continue;
+						if(cache != nullptr)
+						{
+							entry.key = cache->key(entry.sources, entry.layout);
+							if(cache->load(*entry.program, entry.key))
+							{
+								entry.status = LINKED;
+								cached++;
+								continue;
+							}
+						}
+						for(auto&& source : entry.sources)
+						{
+							switch(source.first)
+							{
+								case GL_VERTEX_SHADER: submitShader(entry.vshaders, source.second); break;
+								case GL_FRAGMENT_SHADER: submitShader(entry.fshaders, source.second); break;
+								case GL_GEOMETRY_SHADER: submitShader(entry.gshaders, source.second); break;
+								default:
+									std::cerr << "unknown shader type " << source.first << " --ignored" << std::endl;
+									break;
+							}
+						}
+					}
+					for(auto&& entry : entries)
+					{
+						if(entry.status != QUEUED)
+							continue;
+						ShaderProgram &program = *entry.program;
+						for(auto&& shader : entry.vshaders)
+							program << shader;
+						for(auto&& shader : entry.fshaders)
+							program << shader;
+						for(auto&& shader : entry.gshaders)
+							program << shader;
+						program << entry.layout;
+						if(cache != nullptr && cache->isSupported())
+							program.setBinaryRetrievable();
+						program.submitLink();
+						entry.status = COMPILING;
+						pending++;
+					}
+					DEBUG_OUT(pending << " programs submitted" << (hasParallel() ? " (parallel compile)" : ""));
+				}
+
+				//collect the finished programs without blocking (without KHR_parallel_shader_compile it waits for all).
+				//returns true when nothing is left
+				bool poll()
+				{
+					for(auto&& entry : entries)
+					{
+						if(entry.status == COMPILING && entry.program->isCompletionReady())
+							finalize(entry);
+					}
+					return pending == 0;
+				}
+
+				//submit the queued programs and wait for all. returns false if any of them failed
+				bool finish()
+				{
+					submit();
+					for(auto&& entry : entries)
+					{
+						if(entry.status == COMPILING)
+							finalize(entry);
+					}
+					if(failed > 0)
+						std::cerr << failed << " of " << entries.size() << " programs failed to build" << std::endl;
+					return failed == 0;
+				}
+
+				inline Status getStatus(std::size_t index) const
+				{
+					return entries[index].status;
+				}
+
+				inline std::size_t getNumPrograms() const
+				{
+					return entries.size();
+				}
+
+				inline std::size_t getNumPending() const
+				{
+					return pending;
+				}
+
+				inline std::size_t getNumFailed() const
+				{
+					return failed;
+				}
+
+				//linked from the ProgramCache
+				inline std::size_t getNumCached() const
+				{
+					return cached;
+				}
+		};
+	}
+}
@@ -0,0 +1,384 @@
+#pragma once
+
+#include <GL/glew.h>
+#include "gl_debug.h"
+#include <cstddef>
+#include <unordered_map>
+
+namespace jikoLib{
+	namespace GLLib{
+
+		/**
+		 * BindState
+		 * shadow copy of the objects bound to the current context.
+		 * a bind to the object which is already bound is not issued to the driver.
+		 *
+		 */
+
+		class BindState
+		{
+			public:
+				constexpr static GLuint UNKNOWN = 0xFFFFFFFFu;
+				constexpr static std::size_t TEXTURE_UNIT_NUM = 32;
+				constexpr static std::size_t UNIFORM_BINDING_NUM = 36;
+
+			private:
+				constexpr static std::size_t BUFFER_TARGET_NUM = 9;
+				constexpr static std::size_t TEXTURE_TARGET_NUM = 5;
+
+				GLuint program;
+				GLuint varray;
+				GLuint buffer[BUFFER_TARGET_NUM];
+				GLuint draw_framebuffer;
+				GLuint read_framebuffer;
+				GLuint renderbuffer;
+				GLuint active_unit;
+				GLuint texture[TEXTURE_UNIT_NUM][TEXTURE_TARGET_NUM];
+				GLuint uniform_binding[UNIFORM_BINDING_NUM];
+
+				//element array buffer is a part of the vertex array state
+				std::unordered_map<GLuint, GLuint> varray_element;
+
+				bool unbind_to_zero;
+
+				std::size_t issued_count;
+				std::size_t skipped_count;
+
+				static int bufferIndex(GLenum target)
+				{
+					switch(target)
+					{
+						case GL_ARRAY_BUFFER: return 0;
+						case GL_ELEMENT_ARRAY_BUFFER: return 1;
+						case GL_UNIFORM_BUFFER: return 2;
+						case GL_COPY_READ_BUFFER: return 3;
+						case GL_COPY_WRITE_BUFFER: return 4;
+						case GL_PIXEL_UNPACK_BUFFER: return 5;
+						case GL_PIXEL_PACK_BUFFER: return 6;
+						case GL_DRAW_INDIRECT_BUFFER: return 7;
+						case GL_SHADER_STORAGE_BUFFER: return 8;
+						default: return -1;
+					}
+				}
+
+				static int textureIndex(GLenum target)
+				{
+					switch(target)
+					{
+						case GL_TEXTURE_1D: return 0;
+						case GL_TEXTURE_2D: return 1;
+						case GL_TEXTURE_3D: return 2;
+						case GL_TEXTURE_CUBE_MAP: return 3;
+						case GL_TEXTURE_2D_ARRAY: return 4;
+						default: return -1;
+					}
+				}
+
+				//returns true if the call must be issued
+				inline bool update(GLuint &shadow, GLuint id)
+				{
+					if(shadow == id && id != UNKNOWN)
+					{
+						skipped_count++;
+						return false;
+					}
+					shadow = id;
+					issued_count++;
+					return true;
+				}
+
+				static BindState*& currentPtr()
+				{
+					static thread_local BindState* ptr = nullptr;
+					return ptr;
+				}
+
+			public:
+				BindState() :unbind_to_zero(true), issued_count(0), skipped_count(0)
+			{
+				invalidate();
+			}
+
+				BindState(const BindState&) = delete;
+				BindState& operator=(const BindState&) = delete;
+
+				//state of the context which is current on this thread
+				static BindState& current()
+				{
+					static thread_local BindState default_state;
+					BindState* ptr = currentPtr();
+					return (ptr != nullptr) ? *ptr : default_state;
+				}
+
+				static void makeCurrent(BindState* state)
+				{
+					currentPtr() = state;
+				}
+
+				//forget everything (call after raw glBind* calls outside this library)
+				void invalidate()
+				{
+					program = UNKNOWN;
+					varray = UNKNOWN;
+					for(auto&& b : buffer) b = UNKNOWN;
+					draw_framebuffer = UNKNOWN;
+					read_framebuffer = UNKNOWN;
+					renderbuffer = UNKNOWN;
+					active_unit = UNKNOWN;
+					for(auto&& unit : texture)
+						for(auto&& t : unit) t = UNKNOWN;
+					for(auto&& u : uniform_binding) u = UNKNOWN;
+					varray_element.clear();
+				}
+
+				//if false, unbind() leaves the object bound and the next bind of the same object is skipped.
+				//framebuffer is always unbound since draw and clear depend on it implicitly.
+				inline void setUnbindToZero(bool flag)
+				{
+					unbind_to_zero = flag;
+				}
+
+				inline bool getUnbindToZero() const
+				{
+					return unbind_to_zero;
+				}
+
+				//statistics (reset these once per frame)
+				inline std::size_t getIssuedCount() const
+				{
+					return issued_count;
+				}
+
+				inline std::size_t getSkippedCount() const
+				{
+					return skipped_count;
+				}
+
+				inline void resetCount()
+				{
+					issued_count = 0;
+					skipped_count = 0;
+				}
+
+				//program
+
+				inline void bindProgram(GLuint id)
+				{
+					if(update(program, id))
+					{
+						glUseProgram(id);
+						CHECK_GL_ERROR;
+					}
+				}
+
+				inline void unbindProgram()
+				{
+					if(unbind_to_zero)
+						bindProgram(0);
+				}
+
+				//vertex array
+
+				inline void bindVertexArray(GLuint id)
+				{
+					if(update(varray, id))
+					{
+						glBindVertexArray(id);
+						CHECK_GL_ERROR;
+						auto it = varray_element.find(id);
+						buffer[bufferIndex(GL_ELEMENT_ARRAY_BUFFER)] = (it != varray_element.end()) ? it->second : UNKNOWN;
+					}
+				}
+
+				inline void unbindVertexArray()
+				{
+					if(unbind_to_zero)
+						bindVertexArray(0);
+				}
+
+				//buffer
+
+				inline void bindBuffer(GLenum target, GLuint id)
+				{
+					int index = bufferIndex(target);
+					if(index == -1)
+					{
+						issued_count++;
+						glBindBuffer(target, id);
+						CHECK_GL_ERROR;
+						return;
+					}
+					if(update(buffer[index], id))
+					{
+						glBindBuffer(target, id);
+						CHECK_GL_ERROR;
+						if(target == GL_ELEMENT_ARRAY_BUFFER && varray != UNKNOWN)
+							varray_element[varray] = id;
+					}
+				}
+
+				inline void unbindBuffer(GLenum target)
+				{
+					//a pixel buffer left bound turns the pointers of the later glTex*Image* calls into offsets
+					if(unbind_to_zero || target == GL_PIXEL_UNPACK_BUFFER || target == GL_PIXEL_PACK_BUFFER)
+						bindBuffer(target, 0);
+				}
+
+				//indexed binding point (glBindBufferBase also binds to the generic target)
+				inline void bindBufferBase(GLenum target, GLuint index, GLuint id)
+				{
+					if(target == GL_UNIFORM_BUFFER && index < UNIFORM_BINDING_NUM)
+					{
+						if(uniform_binding[index] == id)
+						{
+							skipped_count++;
+							return;
+						}
+						uniform_binding[index] = id;
+					}
+					issued_count++;
+					glBindBufferBase(target, index, id);
+					CHECK_GL_ERROR;
+					int b = bufferIndex(target);
+					if(b != -1)
+						buffer[b] = id;
+				}
+
+				//framebuffer
+
+				inline void bindFramebuffer(GLenum target, GLuint id)
+				{
+					if(target == GL_FRAMEBUFFER)
+					{
+						//both of draw and read
+						if(draw_framebuffer == id && read_framebuffer == id)
+						{
+							skipped_count++;
+							return;
+						}
+						draw_framebuffer = id;
+						read_framebuffer = id;
+						issued_count++;
+						glBindFramebuffer(target, id);
+						CHECK_GL_ERROR;
+						return;
+					}
+					if(update((target == GL_READ_FRAMEBUFFER) ? read_framebuffer : draw_framebuffer, id))
+					{
+						glBindFramebuffer(target, id);
+						CHECK_GL_ERROR;
+					}
+				}
+
+				inline void unbindFramebuffer(GLenum target)
+				{
+					bindFramebuffer(target, 0);
+				}
+
+				//renderbuffer
+
+				inline void bindRenderbuffer(GLenum target, GLuint id)
+				{
+					if(update(renderbuffer, id))
+					{
+						glBindRenderbuffer(target, id);
+						CHECK_GL_ERROR;
+					}
+				}
+
+				inline void unbindRenderbuffer(GLenum target)
+				{
+					if(unbind_to_zero)
+						bindRenderbuffer(target, 0);
+				}
+
+				//texture
+
+				inline void activeTexture(GLuint unit)
+				{
+					if(active_unit == unit)
+						return;
+					active_unit = unit;
+					glActiveTexture(GL_TEXTURE0 + unit);
+					CHECK_GL_ERROR;
+				}
+
+				//the unit is left active since texImage2D etc. act on the active unit
+				inline void bindTexture(GLenum target, GLuint id, GLuint unit)
+				{
+					activeTexture(unit);
+					int index = textureIndex(target);
+					if(index == -1 || TEXTURE_UNIT_NUM <= unit)
+					{
+						issued_count++;
+						glBindTexture(target, id);
+						CHECK_GL_ERROR;
+						return;
+					}
+					if(update(texture[unit][index], id))
+					{
+						glBindTexture(target, id);
+						CHECK_GL_ERROR;
+					}
+				}
+
+				//unbind from the active texture unit
+				inline void unbindTexture(GLenum target)
+				{
+					if(!unbind_to_zero)
+						return;
+					if(active_unit == UNKNOWN)
+						activeTexture(0);
+					bindTexture(target, 0, active_unit);
+				}
+
+				//deleted objects are unbound by OpenGL and the name may be reused.
+
+				void onDeleteProgram(GLuint id)
+				{
+					//stays in use until another program is bound
+					if(program == id)
+						program = UNKNOWN;
+				}
+
+				void onDeleteVertexArray(GLuint id)
+				{
+					if(varray == id)
+						varray = 0;
+					varray_element.erase(id);
+				}
+
+				void onDeleteBuffer(GLuint id)
+				{
+					for(auto&& b : buffer)
+						if(b == id) b = 0;
+					//vertex arrays which are not bound keep the deleted buffer
+					for(auto&& e : varray_element)
+						if(e.second == id) e.second = UNKNOWN;
+					for(auto&& u : uniform_binding)
+						if(u == id) u = 0;
+				}
+
+				void onDeleteFramebuffer(GLuint id)
+				{
+					if(draw_framebuffer == id)
+						draw_framebuffer = 0;
+					if(read_framebuffer == id)
+						read_framebuffer = 0;
+				}
+
+				void onDeleteRenderbuffer(GLuint id)
+				{
+					if(renderbuffer == id)
+						renderbuffer = 0;
+				}
+
+				void onDeleteTexture(GLuint id)
+				{
+					for(auto&& unit : texture)
+						for(auto&& t : unit)
+							if(t == id) t = 0;
+				}
+		};
+	}
+}
@@ -0,0 +1,540 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <algorithm>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+#include "gl_debug.h"
+#include "gl_helper.h"
+#include "gl_base.h"
+#include "gl_file.h"
+#include "gl_image.h"
+#include "gl_compress.h"
+#include "gl_thread.h"
+
+namespace jikoLib{
+	namespace GLLib{
+
+		/**
+		 * TextureCache
+		 * cooked texture file with the whole mip chain. the levels are stored tightly packed (unpack alignment 1)
+		 * or as BC1/BC3 blocks in the order of the upload, so the loader maps the file and passes the pointers to
+		 * glTexSubImage2D/glCompressedTexSubImage2D.
+		 *
+		 * file layout (native endian):
+		 *   Header
+		 *   Level x (faces*levels)  (face major, level 0 first)
+		 *   pixel blobs             (16 byte aligned)
+		 *
+		 */
+
+		class TextureCache
+		{
+			public:
+				constexpr static std::uint32_t MAGIC = 0x5845544Au; //"JTEX"
+				constexpr static std::uint32_t VERSION = 2;
+				constexpr static std::uint32_t ENDIAN = 0x01020304u;
+				constexpr static std::size_t BLOB_ALIGN = 16;
+
+				struct Header
+				{
+					std::uint32_t magic;
+					std::uint32_t version;
+					std::uint32_t endian;
+					std::uint32_t channels;
+					std::uint32_t width;
+					std::uint32_t height;
+					std::uint32_t levels;
+					std::uint32_t faces;
+					//internal format (GL_RGB8, GL_RGBA8 or the S3TC format) and the bytes per 4x4 block (0: not compressed)
+					std::uint32_t format;
+					std::uint32_t block_bytes;
+					std::uint64_t file_size;
+					//newest mtime and total size of the source files when cooked
+					std::int64_t source_mtime;
+					std::uint64_t source_size;
+				};
+
+				struct Level
+				{
+					std::uint32_t face;
+					std::uint32_t level;
+					std::uint32_t width;
+					std::uint32_t height;
+					std::uint64_t offset;
+					std::uint64_t size;
+				};
+
+				static_assert(sizeof(Header) == 64, "unexpected padding in TextureCache::Header");
+				static_assert(sizeof(Level) == 32, "unexpected padding in TextureCache::Level");
+
+			private:
+				MappedFile file;
+
+				const Header* header = nullptr;
+				const Level* levels = nullptr;
+
+				//destination rows per task of the downsampler
+				constexpr static GLsizei ROW_BLOCK = 32;
+
+				inline static std::size_t alignUp(std::size_t offset)
+				{
+					return (offset+BLOB_ALIGN-1)/BLOB_ALIGN*BLOB_ALIGN;
+				}
+
+				inline static GLenum storageFormat(std::size_t channels)
+				{
+					return (channels == 3) ? GL_RGB8 : GL_RGBA8;
+				}
+
+				inline static GLenum pixelFormat(std::size_t channels)
+				{
+					return (channels == 3) ? GL_RGB : GL_RGBA;
+				}
+
+				//the full mip chain of width x height
+				inline static std::uint32_t mipLevels(std::uint32_t width, std::uint32_t height)
+				{
+					std::uint32_t levels = 1;
+					for(std::uint32_t size = std::max(width, height); size > 1; size >>= 1)
+						levels++;
+					return levels;
+				}
+
+				bool validate() const
+				{
+					const std::size_t map_size = file.size();
+					if(header->magic != MAGIC || header->version != VERSION || header->endian != ENDIAN)
+						return false;
+					if(header->file_size != map_size || (header->channels != 3 && header->channels != 4))
+						return false;
+					//only the pairs written by load(): RGB8/RGBA8, BC1 (8 B per block, RGB) and BC3 (16 B per block, RGBA)
+					if(!((header->block_bytes == 0 && header->format == storageFormat(header->channels)) ||
+								(header->block_bytes == BC1::BLOCK_BYTES && header->format == BC1::TEXTURE_COLOR && header->channels == BC1::CHANNELS) ||
+								(header->block_bytes == BC3::BLOCK_BYTES && header->format == BC3::TEXTURE_COLOR && header->channels == BC3::CHANNELS)))
+						return false;
+					if(header->width == 0 || header->height == 0 || (header->faces != 1 && header->faces != 6))
+						return false;
+					//glTexStorage2D fails on more levels than floor(log2(max(width, height)))+1
+					if(header->levels == 0 || header->levels > mipLevels(header->width, header->height))
+						return false;
+					if(!file.contains(sizeof(Header), header->faces*header->levels, sizeof(Level)))
+						return false;
+					const std::size_t tables = sizeof(Header) + header->faces*header->levels*sizeof(Level);
+					for(std::size_t i = 0; i < header->faces*header->levels; i++)
+					{
+						const Level &level = levels[i];
+						if(level.face != i/header->levels || level.level != i%header->levels)
+							return false;
+						if(level.width != std::max<std::uint32_t>(1, header->width >> level.level) ||
+								level.height != std::max<std::uint32_t>(1, header->height >> level.level))
+							return false;
+						const std::uint64_t size = (header->block_bytes != 0) ?
+							BlockCompressor::compressedSize(level.width, level.height, header->block_bytes) :
+							static_cast<std::uint64_t>(level.width)*level.height*header->channels;
+						if(level.size != size || level.offset < tables || !file.contains(level.offset, level.size))
+							return false;
+					}
+					return true;
+				}
+
+				//dst rows [row_begin, row_end) from src (2x2 box. an axis of size 1 is not halved)
+				static void downsampleRows(const ImageData &src, ImageData &dst, GLsizei row_begin, GLsizei row_end)
+				{
+					const std::size_t c = src.channels;
+					const std::size_t src_pitch = static_cast<std::size_t>(src.width)*c;
+					const std::size_t dst_pitch = static_cast<std::size_t>(dst.width)*c;
+					for(GLsizei y = row_begin; y < row_end; y++)
+					{
+						const GLubyte* row0 = &src.pixels[std::min<GLsizei>(2*y, src.height-1)*src_pitch];
+						const GLubyte* row1 = &src.pixels[std::min<GLsizei>(2*y+1, src.height-1)*src_pitch];
+						GLubyte* out = &dst.pixels[y*dst_pitch];
+						GLsizei x = 0;
+#ifdef __SSE2__
+						//RGBA: 2 destination pixels (4 source columns) per step
+						if(c == 4 && src.width >= 2)
+						{
+							const __m128i zero = _mm_setzero_si128();
+							const __m128i round = _mm_set1_epi16(2);
+							for(; 2*x+3 < src.width && x+1 < dst.width; x += 2)
+							{
+								__m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row0 + 8*x));
+								__m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row1 + 8*x));
+								//columns 0,1 and 2,3 summed over the two rows (16 bit)
+								__m128i lo = _mm_add_epi16(_mm_unpacklo_epi8(a, zero), _mm_unpacklo_epi8(b, zero));
+								__m128i hi = _mm_add_epi16(_mm_unpackhi_epi8(a, zero), _mm_unpackhi_epi8(b, zero));
+								lo = _mm_add_epi16(lo, _mm_srli_si128(lo, 8));
+								hi = _mm_add_epi16(hi, _mm_srli_si128(hi, 8));
+								__m128i sum = _mm_srli_epi16(_mm_add_epi16(_mm_unpacklo_epi64(lo, hi), round), 2);
+								_mm_storel_epi64(reinterpret_cast<__m128i*>(out + 4*x), _mm_packus_epi16(sum, zero));
+							}
+						}
+#endif
+						for(; x < dst.width; x++)
+						{
+							const std::size_t x0 = std::min<GLsizei>(2*x, src.width-1)*c;
+							const std::size_t x1 = std::min<GLsizei>(2*x+1, src.width-1)*c;
+							for(std::size_t k = 0; k < c; k++)
+							{
+								out[x*c+k] = static_cast<GLubyte>((row0[x0+k] + row0[x1+k] + row1[x0+k] + row1[x1+k] + 2) >> 2);
+							}
+						}
+					}
+				}
+
+				struct Blob
+				{
+					std::uint32_t width;
+					std::uint32_t height;
+					const std::vector<GLubyte>* data;
+				};
+
+				template<typename Image>
+					static bool checkFaces(const std::vector<std::vector<Image>> &chains)
+					{
+						if((chains.size() != 1 && chains.size() != 6) || chains[0].empty())
+						{
+							std::cerr << "texture cache needs 1 or 6 faces --did nothing" << std::endl;
+							return false;
+						}
+						for(auto&& chain : chains)
+						{
+							if(chain.size() != chains[0].size() || chain[0].width != chains[0][0].width || chain[0].height != chains[0][0].height)
+							{
+								std::cerr << "the faces of the texture cache differ --did nothing" << std::endl;
+								return false;
+							}
+						}
+						return true;
+					}
+
+				static bool writeFile(const std::string &path, const std::vector<std::vector<Blob>> &blobs, std::size_t channels, GLenum format, std::size_t block_bytes, std::int64_t source_mtime, std::uint64_t source_size)
+				{
+					Header h;
+					std::memset(&h, 0, sizeof(Header));
+					h.magic = MAGIC;
+					h.version = VERSION;
+					h.endian = ENDIAN;
+					h.channels = channels;
+					h.width = blobs[0][0].width;
+					h.height = blobs[0][0].height;
+					h.levels = blobs[0].size();
+					h.faces = blobs.size();
+					h.format = format;
+					h.block_bytes = block_bytes;
+					h.source_mtime = source_mtime;
+					h.source_size = source_size;
+
+					std::vector<Level> level_table;
+					std::uint64_t offset = sizeof(Header) + h.faces*h.levels*sizeof(Level);
+					for(std::size_t f = 0; f < blobs.size(); f++)
+					{
+						for(std::size_t l = 0; l < blobs[f].size(); l++)
+						{
+							Level level;
+							level.face = f;
+							level.level = l;
+							level.width = blobs[f][l].width;
+							level.height = blobs[f][l].height;
+							level.offset = alignUp(offset);
+							level.size = blobs[f][l].data->size();
+							offset = level.offset + level.size;
+							level_table.push_back(level);
+						}
+					}
+					h.file_size = offset;
+
+					const bool written = writeFileAtomic(path, [&](std::ostream &out)
+							{
+							const char zero[BLOB_ALIGN] = {};
+							out.write(reinterpret_cast<const char*>(&h), sizeof(Header));
+							out.write(reinterpret_cast<const char*>(level_table.data()), level_table.size()*sizeof(Level));
+							for(auto&& level : level_table)
+							{
+								out.write(zero, level.offset - static_cast<std::uint64_t>(out.tellp()));
+								out.write(reinterpret_cast<const char*>(blobs[level.face][level.level].data->data()), level.size);
+							}
+							});
+					if(!written)
+						return false;
+					DEBUG_OUT("texture cache " << path << " written. " << h.levels << " levels, " << h.file_size << " B");
+					return true;
+				}
+
+			public:
+				TextureCache() {}
+
+				~TextureCache()
+				{
+					close();
+				}
+
+				TextureCache(const TextureCache&) = delete;
+				TextureCache& operator=(const TextureCache&) = delete;
+
+				//mip chains of the faces ([face][level], level 0 = the input). the rows of all faces are split over the pool
+				static std::vector<std::vector<ImageData>> buildMipChains(std::vector<ImageData> faces, ThreadPool &pool = ThreadPool::getDefault())
+				{
+					std::vector<std::vector<ImageData>> chains(faces.size());
+					GLsizei width = 0, height = 0;
+					for(std::size_t f = 0; f < faces.size(); f++)
+					{
+						width = faces[f].width;
+						height = faces[f].height;
+						chains[f].push_back(std::move(faces[f]));
+					}
+					while(width > 1 || height > 1)
+					{
+						width = std::max<GLsizei>(1, width/2);
+						height = std::max<GLsizei>(1, height/2);
+						const std::size_t blocks = (height+ROW_BLOCK-1)/ROW_BLOCK;
+						for(auto&& chain : chains)
+						{
+							ImageData level;
+							level.width = width;
+							level.height = height;
+							level.channels = chain.back().channels;
+							level.pixels.resize(static_cast<std::size_t>(width)*height*level.channels);
+							chain.push_back(std::move(level));
+						}
+						pool.parallelFor(chains.size()*blocks, [&](std::size_t i)
+								{
+								std::vector<ImageData> &chain = chains[i/blocks];
+								const GLsizei begin = (i%blocks)*ROW_BLOCK;
+								downsampleRows(chain[chain.size()-2], chain.back(), begin, std::min<GLsizei>(begin+ROW_BLOCK, height));
+								});
+					}
+					return chains;
+				}
+
+				//map the file. returns false if it is not a valid cache
+				bool open(const std::string &path)
+				{
+					close();
+					if(!file.open(path) || file.size() < sizeof(Header))
+					{
+						file.close();
+						return false;
+					}
+
+					header = reinterpret_cast<const Header*>(file.data());
+					levels = reinterpret_cast<const Level*>(file.data() + sizeof(Header));
+					if(!validate())
+					{
+						std::cerr << path << " is not a valid texture cache" << std::endl;
+						close();
+						return false;
+					}
+					DEBUG_OUT("texture cache " << path << " mapped. " << header->width << "x" << header->height << ", " << header->levels << " levels, " << file.size() << " B");
+					return true;
+				}
+
+				void close()
+				{
+					file.close();
+					header = nullptr;
+					levels = nullptr;
+				}
+
+				inline bool isOpen() const
+				{
+					return file.isOpen();
+				}
+
+				inline const Header& getHeader() const
+				{
+					return *header;
+				}
+
+				inline const Level& getLevel(std::size_t face, std::size_t level) const
+				{
+					return levels[face*header->levels + level];
+				}
+
+				inline const GLubyte* getPixels(std::size_t face, std::size_t level) const
+				{
+					return reinterpret_cast<const GLubyte*>(file.data() + getLevel(face, level).offset);
+				}
+
+				//immutable storage of all levels, then one glTexSubImage2D per level straight from the mapping
+				template<typename TargetType, typename Allocator>
+					bool upload(Texture<TargetType, Allocator> &texture) const
+					{
+						static_assert(is_exist<TargetType, Texture2D, TextureCubeMap>::value, "invalid type");
+						const bool is_cube = std::is_same<TargetType, TextureCubeMap>::value;
+						if(!isOpen() || header->faces != (is_cube ? 6u : 1u))
+						{
+							std::cerr << "texture cache does not match the texture --did nothing" << std::endl;
+							return false;
+						}
+						//the face order of TextureTraits<TextureCubeMap>::texImage2D
+						const GLenum cube_targets[6] =
+						{
+							TextureCubeMap::TEXTURE_NEGX, TextureCubeMap::TEXTURE_POSX,
+							TextureCubeMap::TEXTURE_NEGY, TextureCubeMap::TEXTURE_POSY,
+							TextureCubeMap::TEXTURE_NEGZ, TextureCubeMap::TEXTURE_POSZ
+						};
+						const bool compressed = (header->block_bytes != 0);
+						//without S3TC the blocks are decoded here
+						const bool decode = compressed && !GLEW_EXT_texture_compression_s3tc;
+						const GLenum int_format = decode ? GL_RGBA8 : header->format;
+						const GLenum format = decode ? GL_RGBA : pixelFormat(header->channels);
+						texture.bind();
+						if(GLEW_ARB_texture_storage)
+						{
+							glTexStorage2D(TargetType::TEXTURE_TARGET, header->levels, int_format, header->width, header->height);
+							CHECK_GL_ERROR;
+						}
+						//the levels are tightly packed. the previous alignment is restored after the upload
+						GLint align;
+						glGetIntegerv(GL_UNPACK_ALIGNMENT, &align);
+						glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+						for(std::size_t f = 0; f < header->faces; f++)
+						{
+							const GLenum target = is_cube ? cube_targets[f] : GL_TEXTURE_2D;
+							for(std::size_t l = 0; l < header->levels; l++)
+							{
+								const Level &level = getLevel(f, l);
+								const GLubyte* pixels = getPixels(f, l);
+								ImageData decoded;
+								if(decode)
+								{
+									CompressedImage blocks;
+									blocks.width = level.width;
+									blocks.height = level.height;
+									blocks.format = header->format;
+									blocks.block_bytes = header->block_bytes;
+									blocks.data.assign(pixels, pixels+level.size);
+									decoded = BlockCompressor::decode(blocks);
+									pixels = decoded.pixels.data();
+								}
+								if(compressed && !decode)
+								{
+									if(GLEW_ARB_texture_storage)
+										glCompressedTexSubImage2D(target, l, 0, 0, level.width, level.height, int_format, level.size, pixels);
+									else
+										glCompressedTexImage2D(target, l, int_format, level.width, level.height, 0, level.size, pixels);
+								}
+								else
+								{
+									if(GLEW_ARB_texture_storage)
+										glTexSubImage2D(target, l, 0, 0, level.width, level.height, format, GL_UNSIGNED_BYTE, pixels);
+									else
+										glTexImage2D(target, l, int_format, level.width, level.height, 0, format, GL_UNSIGNED_BYTE, pixels);
+								}
+								CHECK_GL_ERROR;
+							}
+						}
+						glPixelStorei(GL_UNPACK_ALIGNMENT, align);
+						glTexParameteri(TargetType::TEXTURE_TARGET, GL_TEXTURE_MAX_LEVEL, header->levels-1);
+						CHECK_GL_ERROR;
+						texture.unbind();
+						return true;
+					}
+
+				//cook the faces (1, or 6 in the order of the cubemap) with their mip chains into path (written to a temporary file and renamed)
+				static bool write(const std::string &path, const std::vector<std::vector<ImageData>> &chains, std::int64_t source_mtime = 0, std::uint64_t source_size = 0)
+				{
+					if(!checkFaces(chains))
+						return false;
+					std::vector<std::vector<Blob>> blobs(chains.size());
+					for(std::size_t f = 0; f < chains.size(); f++)
+					{
+						for(auto&& level : chains[f])
+							blobs[f].push_back({static_cast<std::uint32_t>(level.width), static_cast<std::uint32_t>(level.height), &level.pixels});
+					}
+					const ImageData &base = chains[0][0];
+					return writeFile(path, blobs, base.channels, storageFormat(base.channels), 0, source_mtime, source_size);
+				}
+
+				//the same with the levels compressed by BlockCompressor (channels: of the source)
+				static bool write(const std::string &path, const std::vector<std::vector<CompressedImage>> &chains, std::size_t channels, std::int64_t source_mtime = 0, std::uint64_t source_size = 0)
+				{
+					if(!checkFaces(chains))
+						return false;
+					std::vector<std::vector<Blob>> blobs(chains.size());
+					for(std::size_t f = 0; f < chains.size(); f++)
+					{
+						for(auto&& level : chains[f])
+							blobs[f].push_back({static_cast<std::uint32_t>(level.width), static_cast<std::uint32_t>(level.height), &level.data});
+					}
+					const CompressedImage &base = chains[0][0];
+					return writeFile(path, blobs, channels, base.format, base.block_bytes, source_mtime, source_size);
+				}
+
+				//newest mtime and total size of the sources. false if one is missing
+				//true if the cache was cooked from the current source files
+				bool isUpToDate(const std::vector<std::string> &sources) const
+				{
+					std::int64_t mtime;
+					std::uint64_t size;
+					if(!isOpen() || !sourceStat(sources, mtime, size))
+						return false;
+					return header->source_mtime == mtime && header->source_size == size;
+				}
+
+				//open cache_path if it is up to date. otherwise decode the sources (1 image or the 6 cubemap faces)
+				//on the pool, build the mip chains (and compress them) and (re)write the cache.
+				//format: RGB, RGBA, BC1 or BC3. cache_path = "": the first source + ".jtex"
+				template<typename format = RGBA>
+					bool load(const std::vector<std::string> &sources, std::string cache_path = "", ThreadPool &pool = ThreadPool::getDefault())
+					{
+						static_assert(is_exist<format, RGB, RGBA, BC1, BC3>::value, "invalid format");
+						const GLenum int_format = (format::BLOCK_BYTES != 0) ? format::TEXTURE_COLOR : storageFormat(format::CHANNELS);
+						if(sources.size() != 1 && sources.size() != 6)
+						{
+							std::cerr << "texture cache needs 1 or 6 sources --did nothing" << std::endl;
+							return false;
+						}
+						if(cache_path == "")
+							cache_path = sources[0] + ".jtex";
+						if(open(cache_path) && isUpToDate(sources) && header->format == int_format)
+							return true;
+						close();
+
+						std::int64_t mtime;
+						std::uint64_t size;
+						if(!sourceStat(sources, mtime, size))
+						{
+							std::cerr << "texture source cannot be found" << std::endl;
+							return false;
+						}
+						std::vector<ImageData> faces(sources.size());
+						std::vector<unsigned char> success(sources.size(), 0);
+						pool.parallelFor(sources.size(), [&](std::size_t i)
+								{
+								success[i] = ImageDecoder::decode(sources[i], format::CHANNELS, faces[i]);
+								});
+						for(std::size_t i = 0; i < sources.size(); i++)
+						{
+							if(!success[i])
+							{
+								std::cerr << "cannot load image " << sources[i] << " --did nothing" << std::endl;
+								return false;
+							}
+						}
+						std::vector<std::vector<ImageData>> chains = buildMipChains(std::move(faces), pool);
+						bool written;
+						if(format::BLOCK_BYTES != 0)
+						{
+							std::vector<std::vector<CompressedImage>> blocks(chains.size());
+							for(std::size_t f = 0; f < chains.size(); f++)
+							{
+								for(auto&& level : chains[f])
+									blocks[f].push_back(BlockCompressor::encode<typename std::conditional<format::BLOCK_BYTES == 8, BC1, BC3>::type>(level, pool));
+							}
+							written = write(cache_path, blocks, format::CHANNELS, mtime, size);
+						}
+						else
+							written = write(cache_path, chains, mtime, size);
+						if(!written)
+							return false;
+						return open(cache_path);
+					}
+		};
+	}
+}
@@ -0,0 +1,315 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <memory>
+#include <future>
+#include <chrono>
+#include <algorithm>
+#include "gl_debug.h"
+#include "gl_helper.h"
+#include "gl_base.h"
+#include "gl_image.h"
+#include "gl_thread.h"
+
+namespace jikoLib{
+	namespace GLLib{
+
+		/**
+		 * TextureLoader
+		 * asynchronous Texture2D loading. load() returns a handle at once and the file is decoded on the pool.
+		 * update() (once per frame on the GL thread) copies the decoded rows into a persistently mapped PBO ring
+		 * and uploads them with glTexSubImage2D within the time budget. the handle gives the placeholder until the last row is uploaded.
+		 *
+		 */
+
+		class TextureLoader
+		{
+			private:
+				enum Status
+				{
+					DECODING,
+					UPLOADING,
+					READY,
+					FAILED
+				};
+
+				//touched by the worker (no GL object in here)
+				struct Request
+				{
+					std::string path;
+					std::size_t channels;
+					ImageData image;
+				};
+
+				struct Job
+				{
+					explicit Job(const Texture<Texture2D> &placeholder)
+						:placeholder(placeholder)
+					{
+					}
+
+					Texture<Texture2D> texture;
+					Texture<Texture2D> placeholder;
+					Status status = DECODING;
+					GLenum int_format;
+					GLenum format;
+					std::size_t align;
+					GLsizei uploaded_rows = 0;
+					std::shared_ptr<Request> request;
+					std::future<bool> decoded;
+				};
+
+				using Clock = std::chrono::steady_clock;
+
+				//strip size of the upload without the ring
+				constexpr static std::size_t DIRECT_STRIP = 1024*1024;
+
+				ThreadPool &pool;
+				RingBuffer<PixelUnpackBuffer> staging;
+				Texture<Texture2D> placeholder;
+				std::vector<std::shared_ptr<Job>> jobs;
+
+				std::size_t uploaded_bytes = 0;
+
+				//decoded -> storage allocated
+				static void allocate(Job &job)
+				{
+					const ImageData &image = job.request->image;
+					job.texture.bind();
+					glTexImage2D(GL_TEXTURE_2D, 0, job.int_format, image.width, image.height, 0, job.format, GL_UNSIGNED_BYTE, nullptr);
+					CHECK_GL_ERROR;
+					job.texture.unbind();
+					job.status = UPLOADING;
+				}
+
+				//rows [uploaded_rows, uploaded_rows+rows) through the staging ring (direct: from the memory)
+				bool uploadRows(Job &job, GLsizei rows, bool direct)
+				{
+					const ImageData &image = job.request->image;
+					const std::size_t row_size = static_cast<std::size_t>(image.width)*image.channels;
+					const GLubyte* src = &image.pixels[job.uploaded_rows*row_size];
+					const GLvoid* pixels = src;
+					if(!direct)
+					{
+						std::size_t offset;
+						GLvoid* dst = staging.allocate(rows*row_size, 16, offset);
+						if(dst == nullptr)
+							return false;
+						std::memcpy(dst, src, rows*row_size);
+						staging.bind();
+						pixels = reinterpret_cast<const GLvoid*>(offset);
+					}
+					job.texture.bind();
+					//restored for the uploads that rely on the current alignment
+					GLint align;
+					glGetIntegerv(GL_UNPACK_ALIGNMENT, &align);
+					glPixelStorei(GL_UNPACK_ALIGNMENT, job.align);
+					glTexSubImage2D(GL_TEXTURE_2D, 0, 0, job.uploaded_rows, image.width, rows, job.format, GL_UNSIGNED_BYTE, pixels);
+					CHECK_GL_ERROR;
+					glPixelStorei(GL_UNPACK_ALIGNMENT, align);
+					job.texture.unbind();
+					if(!direct)
+						staging.unbind();
+					job.uploaded_rows += rows;
+					uploaded_bytes += rows*row_size;
+					return true;
+				}
+
+			public:
+
+				/**
+				 * AsyncTexture
+				 * handle returned by load(). copies share the load.
+				 *
+				 */
+
+				class AsyncTexture
+				{
+					private:
+						std::shared_ptr<Job> job;
+
+					public:
+						AsyncTexture() {}
+
+						explicit AsyncTexture(const std::shared_ptr<Job> &job)
+							:job(job)
+						{
+						}
+
+						inline bool isReady() const
+						{
+							return job != nullptr && job->status == READY;
+						}
+
+						inline bool isFailed() const
+						{
+							return job == nullptr || job->status == FAILED;
+						}
+
+						//the loaded texture, or the placeholder until it is ready.
+						//an empty texture for a default constructed handle
+						inline const Texture<Texture2D>& get() const
+						{
+							if(job == nullptr)
+							{
+								//never deleted: it may outlive the context
+								static const Texture<Texture2D>* empty = new Texture<Texture2D>();
+								return *empty;
+							}
+							return isReady() ? job->texture : job->placeholder;
+						}
+
+						inline void bind(std::size_t TexUnitNum = 0) const
+						{
+							get().bind(TexUnitNum);
+						}
+
+						inline void unbind() const
+						{
+							get().unbind();
+						}
+				};
+
+				//staging_size: bytes of the PBO ring per frame in flight
+				explicit TextureLoader(ThreadPool &pool = ThreadPool::getDefault(), std::size_t staging_size = 8*1024*1024)
+					:pool(pool), staging(staging_size)
+				{
+					//2x2 grey checker
+					const GLubyte checker[] =
+					{
+						160, 160, 160, 255,  96,  96,  96, 255,
+						 96,  96,  96, 255, 160, 160, 160, 255
+					};
+					placeholder.bind();
+					glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+					glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, 2, 2, 0, GL_RGBA, GL_UNSIGNED_BYTE, checker);
+					CHECK_GL_ERROR;
+					placeholder.unbind();
+				}
+
+				TextureLoader(const TextureLoader&) = delete;
+				TextureLoader& operator=(const TextureLoader&) = delete;
+
+				//the placeholder (to change the parameters or the image)
+				inline Texture<Texture2D>& getPlaceholder()
+				{
+					return placeholder;
+				}
+
+				//number of the loads in progress
+				inline std::size_t getNumPending() const
+				{
+					return jobs.size();
+				}
+
+				inline std::size_t getUploadedBytes() const
+				{
+					return uploaded_bytes;
+				}
+
+				//start loading path (call on the GL thread). the texture has the default parameters of Texture
+				template<typename int_format = RGBA, typename format = RGBA>
+					AsyncTexture load(const std::string &path)
+					{
+						static_assert(is_exist<format, RGB, RGBA>::value, "invalid format");
+						auto job = std::make_shared<Job>(placeholder);
+						job->int_format = int_format::TEXTURE_COLOR;
+						job->format = format::TEXTURE_COLOR;
+						job->align = format::ALIGN;
+						job->request = std::make_shared<Request>();
+						job->request->path = path;
+						job->request->channels = format::CHANNELS;
+						std::shared_ptr<Request> request = job->request;
+						job->decoded = pool.push([request]()
+								{
+								return ImageDecoder::decode(request->path, request->channels, request->image);
+								});
+						jobs.push_back(job);
+						return AsyncTexture(job);
+					}
+
+				//upload the decoded images for about budget_ms (at least one strip per call). call once per frame on the GL thread
+				void update(double budget_ms = 2.0)
+				{
+					const auto start = Clock::now();
+					staging.beginFrame();
+					bool out_of_budget = false;
+					bool uploaded = false;
+					for(auto&& job : jobs)
+					{
+						if(job->status == DECODING)
+						{
+							if(job->decoded.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+								continue;
+							if(!job->decoded.get())
+							{
+								std::cerr << "cannot load image " << job->request->path << " --did nothing" << std::endl;
+								job->status = FAILED;
+								continue;
+							}
+							allocate(*job);
+						}
+						const ImageData &image = job->request->image;
+						const std::size_t row_size = static_cast<std::size_t>(image.width)*image.channels;
+						while(job->status == UPLOADING && !out_of_budget)
+						{
+							if(uploaded && std::chrono::duration<double, std::milli>(Clock::now()-start).count() >= budget_ms)
+							{
+								out_of_budget = true;
+								break;
+							}
+							//a row larger than the region of the ring goes straight from the memory
+							const bool direct = !staging.isMapped() || staging.getFrameSize() < row_size+16;
+							std::size_t fit = DIRECT_STRIP/row_size;
+							if(!direct)
+							{
+								fit = (staging.getFreeSize() > 16) ? (staging.getFreeSize()-16)/row_size : 0;
+								if(fit == 0)
+								{
+									out_of_budget = true;
+									break;
+								}
+							}
+							const GLsizei rows = std::min<std::size_t>(image.height-job->uploaded_rows, std::max<std::size_t>(fit, 1));
+							if(!uploadRows(*job, rows, direct))
+							{
+								out_of_budget = true;
+								break;
+							}
+							uploaded = true;
+							if(job->uploaded_rows == image.height)
+							{
+								job->status = READY;
+								DEBUG_OUT("texture " << job->request->path << " loaded. id is " << job->texture.getID());
+								job->request.reset();
+							}
+						}
+						if(out_of_budget)
+							break;
+					}
+					staging.endFrame();
+
+					jobs.erase(std::remove_if(jobs.begin(), jobs.end(), [](const std::shared_ptr<Job> &job)
+								{
+								return job->status == READY || job->status == FAILED;
+								}), jobs.end());
+				}
+
+				//block until all the loads are done (loading screen etc.)
+				void finish()
+				{
+					while(!jobs.empty())
+					{
+						for(auto&& job : jobs)
+						{
+							if(job->status == DECODING)
+								job->decoded.wait();
+						}
+						update(1e9);
+					}
+				}
+		};
+	}
+}
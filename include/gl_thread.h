@@ -0,0 +1,164 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+#include <queue>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <atomic>
+#include <exception>
+
+namespace jikoLib{
+	namespace GLLib{
+
+		/**
+		 * ThreadPool
+		 * worker threads for the CPU side work (loading, converting, ...).
+		 * the tasks must not call OpenGL. the GL objects are made on the context thread.
+		 *
+		 */
+
+		class ThreadPool
+		{
+			private:
+				std::vector<std::thread> workers;
+				std::queue<std::function<void()>> tasks;
+
+				std::mutex mtx;
+				std::condition_variable cond;
+				bool stop = false;
+
+				void work()
+				{
+					while(true)
+					{
+						std::function<void()> task;
+						{
+							std::unique_lock<std::mutex> lock(mtx);
+							cond.wait(lock, [this](){ return stop || !tasks.empty(); });
+							if(stop && tasks.empty())
+								return;
+							task = std::move(tasks.front());
+							tasks.pop();
+						}
+						task();
+					}
+				}
+
+			public:
+				//num = 0: one thread per core
+				explicit ThreadPool(std::size_t num = 0)
+				{
+					if(num == 0)
+						num = std::thread::hardware_concurrency();
+					if(num == 0)
+						num = 1;
+					for(std::size_t i = 0; i < num; i++)
+					{
+						workers.emplace_back(&ThreadPool::work, this);
+					}
+				}
+
+				~ThreadPool()
+				{
+					{
+						std::lock_guard<std::mutex> lock(mtx);
+						stop = true;
+					}
+					cond.notify_all();
+					for(auto&& worker : workers)
+					{
+						worker.join();
+					}
+				}
+
+				ThreadPool(const ThreadPool&) = delete;
+				ThreadPool& operator=(const ThreadPool&) = delete;
+
+				inline std::size_t size() const
+				{
+					return workers.size();
+				}
+
+				template<typename Func>
+					auto push(Func&& func) -> std::future<decltype(func())>
+					{
+						using Result = decltype(func());
+						auto task = std::make_shared<std::packaged_task<Result()>>(std::forward<Func>(func));
+						std::future<Result> result = task->get_future();
+						{
+							std::lock_guard<std::mutex> lock(mtx);
+							tasks.push([task](){ (*task)(); });
+						}
+						cond.notify_one();
+						return result;
+					}
+
+				//func(i) for i in [0, num). the indices are taken in order (put the heavy ones first).
+				//returns after all are done (an exception of func is rethrown then). do not call from a task of the same pool.
+				template<typename Func>
+					void parallelFor(std::size_t num, Func func)
+					{
+						if(num == 0)
+							return;
+						auto next = std::make_shared<std::atomic<std::size_t>>(0);
+						auto loop = [next, num, &func]()
+						{
+							for(std::size_t i = (*next)++; i < num; i = (*next)++)
+							{
+								try
+								{
+									func(i);
+								}
+								catch(...)
+								{
+									//the other threads take no more indices
+									*next = num;
+									throw;
+								}
+							}
+						};
+						std::vector<std::future<void>> results;
+						for(std::size_t t = 0; t < size() && t+1 < num; t++)
+						{
+							results.push_back(push(loop));
+						}
+						//the caller works too. the tasks use func, so all of them are waited for before an exception leaves (the first one is rethrown)
+						std::exception_ptr error;
+						try
+						{
+							loop();
+						}
+						catch(...)
+						{
+							error = std::current_exception();
+						}
+						for(auto&& result : results)
+						{
+							try
+							{
+								result.get();
+							}
+							catch(...)
+							{
+								if(!error)
+									error = std::current_exception();
+							}
+						}
+						if(error)
+							std::rethrow_exception(error);
+					}
+
+				//shared by the loaders
+				static ThreadPool& getDefault()
+				{
+					static ThreadPool pool;
+					return pool;
+				}
+		};
+	}
+}
@@ -0,0 +1,374 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include <algorithm>
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <glm/gtx/quaternion.hpp>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+#ifdef __AVX__
+#include <immintrin.h>
+#endif
+#include "gl_thread.h"
+
+namespace jikoLib{
+	namespace GLLib{
+
+		//translate(pos)*mat4_cast(rot)*scale(scale) without the matrix products
+		inline glm::mat4 composeTRS(const glm::vec3 &pos, const glm::quat &rot, const glm::vec3 &scale)
+		{
+			const float x2 = rot.x+rot.x, y2 = rot.y+rot.y, z2 = rot.z+rot.z;
+			const float xx = rot.x*x2, yy = rot.y*y2, zz = rot.z*z2;
+			const float xy = rot.x*y2, xz = rot.x*z2, yz = rot.y*z2;
+			const float wx = rot.w*x2, wy = rot.w*y2, wz = rot.w*z2;
+			return glm::mat4(
+					glm::vec4((1.0f-(yy+zz))*scale.x, (xy+wz)*scale.x, (xz-wy)*scale.x, 0.0f),
+					glm::vec4((xy-wz)*scale.y, (1.0f-(xx+zz))*scale.y, (yz+wx)*scale.y, 0.0f),
+					glm::vec4((xz+wy)*scale.z, (yz-wx)*scale.z, (1.0f-(xx+yy))*scale.z, 0.0f),
+					glm::vec4(pos.x, pos.y, pos.z, 1.0f));
+		}
+
+		/**
+		 * Transform
+		 * position, rotation and scale with the model matrix cached until one of them changes.
+		 *
+		 */
+
+		class Transform
+		{
+			private:
+				glm::vec3 pos;
+				glm::quat rot;
+				glm::vec3 scale;
+
+				mutable glm::mat4 matrix;
+				mutable bool dirty = true;
+
+			public:
+				Transform()
+					:pos(0.0f, 0.0f, 0.0f),
+					rot(1.0f, 0.0f, 0.0f, 0.0f),
+					scale(1.0f, 1.0f, 1.0f) {}
+
+				inline void setPos(const glm::vec3 &vec)
+				{
+					pos = vec;
+					dirty = true;
+				}
+
+				inline const glm::vec3& getPos() const
+				{
+					return pos;
+				}
+
+				inline void setScale(const glm::vec3 &vec)
+				{
+					scale = vec;
+					dirty = true;
+				}
+
+				inline const glm::vec3& getScale() const
+				{
+					return scale;
+				}
+
+				inline void setRot(const glm::quat &quat)
+				{
+					rot = quat;
+					dirty = true;
+				}
+
+				inline void rotate(const glm::vec3 &axis, GLfloat angle)
+				{
+					rot = glm::rotate(rot, angle, glm::normalize(axis));
+					dirty = true;
+				}
+
+				inline void resetRot()
+				{
+					setRot(glm::quat(1.0f, 0.0f, 0.0f, 0.0f));
+				}
+
+				inline const glm::quat& getRot() const
+				{
+					return rot;
+				}
+
+				inline bool isDirty() const
+				{
+					return dirty;
+				}
+
+				inline const glm::mat4& getMatrix() const
+				{
+					if(dirty)
+					{
+						matrix = composeTRS(pos, rot, scale);
+						dirty = false;
+					}
+					return matrix;
+				}
+		};
+
+		/**
+		 * TransformBatch
+		 * many transforms in structure of arrays. update() recomputes the matrices of the changed ones
+		 * 4 (SSE2) or 8 (AVX, with -mavx) at a time on the pool. the matrices are contiguous (for an instance buffer).
+		 *
+		 */
+
+		class TransformBatch
+		{
+			private:
+				//objects per block (the arrays are padded to it)
+				constexpr static std::size_t BLOCK = 8;
+				//blocks per task of the pool
+				constexpr static std::size_t TASK_BLOCKS = 512;
+
+				std::size_t count = 0;
+				std::vector<float> px, py, pz;
+				std::vector<float> qx, qy, qz, qw;
+				std::vector<float> sx, sy, sz;
+				std::vector<std::uint8_t> dirty;
+				std::vector<glm::mat4> matrices;
+				std::size_t updated = 0;
+
+#ifdef __SSE2__
+				//4 columns of 4 objects (one lane each) -> 4 matrices
+				inline static void storeColumn(__m128 c0, __m128 c1, __m128 c2, __m128 c3, glm::mat4* out, std::size_t column)
+				{
+					_MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+					_mm_storeu_ps(&out[0][column][0], c0);
+					_mm_storeu_ps(&out[1][column][0], c1);
+					_mm_storeu_ps(&out[2][column][0], c2);
+					_mm_storeu_ps(&out[3][column][0], c3);
+				}
+
+				void compute4(std::size_t i)
+				{
+					const __m128 x = _mm_loadu_ps(&qx[i]), y = _mm_loadu_ps(&qy[i]), z = _mm_loadu_ps(&qz[i]), w = _mm_loadu_ps(&qw[i]);
+					const __m128 x2 = _mm_add_ps(x, x), y2 = _mm_add_ps(y, y), z2 = _mm_add_ps(z, z);
+					const __m128 xx = _mm_mul_ps(x, x2), yy = _mm_mul_ps(y, y2), zz = _mm_mul_ps(z, z2);
+					const __m128 xy = _mm_mul_ps(x, y2), xz = _mm_mul_ps(x, z2), yz = _mm_mul_ps(y, z2);
+					const __m128 wx = _mm_mul_ps(w, x2), wy = _mm_mul_ps(w, y2), wz = _mm_mul_ps(w, z2);
+					const __m128 one = _mm_set1_ps(1.0f), zero = _mm_setzero_ps();
+					const __m128 scale_x = _mm_loadu_ps(&sx[i]), scale_y = _mm_loadu_ps(&sy[i]), scale_z = _mm_loadu_ps(&sz[i]);
+					glm::mat4* out = &matrices[i];
+					storeColumn(
+							_mm_mul_ps(_mm_sub_ps(one, _mm_add_ps(yy, zz)), scale_x),
+							_mm_mul_ps(_mm_add_ps(xy, wz), scale_x),
+							_mm_mul_ps(_mm_sub_ps(xz, wy), scale_x),
+							zero, out, 0);
+					storeColumn(
+							_mm_mul_ps(_mm_sub_ps(xy, wz), scale_y),
+							_mm_mul_ps(_mm_sub_ps(one, _mm_add_ps(xx, zz)), scale_y),
+							_mm_mul_ps(_mm_add_ps(yz, wx), scale_y),
+							zero, out, 1);
+					storeColumn(
+							_mm_mul_ps(_mm_add_ps(xz, wy), scale_z),
+							_mm_mul_ps(_mm_sub_ps(yz, wx), scale_z),
+							_mm_mul_ps(_mm_sub_ps(one, _mm_add_ps(xx, yy)), scale_z),
+							zero, out, 2);
+					storeColumn(_mm_loadu_ps(&px[i]), _mm_loadu_ps(&py[i]), _mm_loadu_ps(&pz[i]), one, out, 3);
+				}
+#endif
+
+#ifdef __AVX__
+				//4 columns of 8 objects -> 8 matrices (two 4x4 transposes)
+				inline static void storeColumn(__m256 c0, __m256 c1, __m256 c2, __m256 c3, glm::mat4* out, std::size_t column)
+				{
+					storeColumn(_mm256_castps256_ps128(c0), _mm256_castps256_ps128(c1), _mm256_castps256_ps128(c2), _mm256_castps256_ps128(c3), out, column);
+					storeColumn(_mm256_extractf128_ps(c0, 1), _mm256_extractf128_ps(c1, 1), _mm256_extractf128_ps(c2, 1), _mm256_extractf128_ps(c3, 1), out+4, column);
+				}
+
+				void compute8(std::size_t i)
+				{
+					const __m256 x = _mm256_loadu_ps(&qx[i]), y = _mm256_loadu_ps(&qy[i]), z = _mm256_loadu_ps(&qz[i]), w = _mm256_loadu_ps(&qw[i]);
+					const __m256 x2 = _mm256_add_ps(x, x), y2 = _mm256_add_ps(y, y), z2 = _mm256_add_ps(z, z);
+					const __m256 xx = _mm256_mul_ps(x, x2), yy = _mm256_mul_ps(y, y2), zz = _mm256_mul_ps(z, z2);
+					const __m256 xy = _mm256_mul_ps(x, y2), xz = _mm256_mul_ps(x, z2), yz = _mm256_mul_ps(y, z2);
+					const __m256 wx = _mm256_mul_ps(w, x2), wy = _mm256_mul_ps(w, y2), wz = _mm256_mul_ps(w, z2);
+					const __m256 one = _mm256_set1_ps(1.0f), zero = _mm256_setzero_ps();
+					const __m256 scale_x = _mm256_loadu_ps(&sx[i]), scale_y = _mm256_loadu_ps(&sy[i]), scale_z = _mm256_loadu_ps(&sz[i]);
+					glm::mat4* out = &matrices[i];
+					storeColumn(
+							_mm256_mul_ps(_mm256_sub_ps(one, _mm256_add_ps(yy, zz)), scale_x),
+							_mm256_mul_ps(_mm256_add_ps(xy, wz), scale_x),
+							_mm256_mul_ps(_mm256_sub_ps(xz, wy), scale_x),
+							zero, out, 0);
+					storeColumn(
+							_mm256_mul_ps(_mm256_sub_ps(xy, wz), scale_y),
+							_mm256_mul_ps(_mm256_sub_ps(one, _mm256_add_ps(xx, zz)), scale_y),
+							_mm256_mul_ps(_mm256_add_ps(yz, wx), scale_y),
+							zero, out, 1);
+					storeColumn(
+							_mm256_mul_ps(_mm256_add_ps(xz, wy), scale_z),
+							_mm256_mul_ps(_mm256_sub_ps(yz, wx), scale_z),
+							_mm256_mul_ps(_mm256_sub_ps(one, _mm256_add_ps(xx, yy)), scale_z),
+							zero, out, 2);
+					storeColumn(_mm256_loadu_ps(&px[i]), _mm256_loadu_ps(&py[i]), _mm256_loadu_ps(&pz[i]), one, out, 3);
+				}
+#endif
+
+				void computeBlock(std::size_t i)
+				{
+#if defined(__AVX__)
+					compute8(i);
+#elif defined(__SSE2__)
+					compute4(i);
+					compute4(i+4);
+#else
+					for(std::size_t k = i; k < i+BLOCK; k++)
+						matrices[k] = composeTRS(glm::vec3(px[k], py[k], pz[k]), glm::quat(qw[k], qx[k], qy[k], qz[k]), glm::vec3(sx[k], sy[k], sz[k]));
+#endif
+				}
+
+				//blocks [begin, end). returns the number of the recomputed blocks
+				std::size_t updateBlocks(std::size_t begin, std::size_t end)
+				{
+					std::size_t computed = 0;
+					for(std::size_t b = begin; b < end; b++)
+					{
+						std::uint64_t flags;
+						static_assert(BLOCK == sizeof(flags), "one flag per byte");
+						std::memcpy(&flags, &dirty[b*BLOCK], sizeof(flags));
+						if(flags == 0)
+							continue;
+						computeBlock(b*BLOCK);
+						std::memset(&dirty[b*BLOCK], 0, BLOCK);
+						computed++;
+					}
+					return computed;
+				}
+
+			public:
+				TransformBatch() {}
+
+				explicit TransformBatch(std::size_t num)
+				{
+					resize(num);
+				}
+
+				//new transforms are identity
+				void resize(std::size_t num)
+				{
+					count = num;
+					const std::size_t padded = (num+BLOCK-1)/BLOCK*BLOCK;
+					for(auto&& v : {&px, &py, &pz, &qx, &qy, &qz})
+						v->resize(padded, 0.0f);
+					for(auto&& v : {&qw, &sx, &sy, &sz})
+						v->resize(padded, 1.0f);
+					dirty.resize(padded, 1);
+					matrices.resize(padded, glm::mat4(1.0f));
+				}
+
+				//returns the index
+				std::size_t add(const Transform &transform = Transform())
+				{
+					resize(count+1);
+					set(count-1, transform);
+					return count-1;
+				}
+
+				inline std::size_t size() const
+				{
+					return count;
+				}
+
+				inline void set(std::size_t i, const Transform &transform)
+				{
+					setPos(i, transform.getPos());
+					setRot(i, transform.getRot());
+					setScale(i, transform.getScale());
+				}
+
+				inline void setPos(std::size_t i, const glm::vec3 &vec)
+				{
+					px[i] = vec.x;
+					py[i] = vec.y;
+					pz[i] = vec.z;
+					dirty[i] = 1;
+				}
+
+				inline glm::vec3 getPos(std::size_t i) const
+				{
+					return glm::vec3(px[i], py[i], pz[i]);
+				}
+
+				inline void setRot(std::size_t i, const glm::quat &quat)
+				{
+					qx[i] = quat.x;
+					qy[i] = quat.y;
+					qz[i] = quat.z;
+					qw[i] = quat.w;
+					dirty[i] = 1;
+				}
+
+				inline glm::quat getRot(std::size_t i) const
+				{
+					return glm::quat(qw[i], qx[i], qy[i], qz[i]);
+				}
+
+				inline void rotate(std::size_t i, const glm::vec3 &axis, GLfloat angle)
+				{
+					setRot(i, glm::rotate(getRot(i), angle, glm::normalize(axis)));
+				}
+
+				inline void setScale(std::size_t i, const glm::vec3 &vec)
+				{
+					sx[i] = vec.x;
+					sy[i] = vec.y;
+					sz[i] = vec.z;
+					dirty[i] = 1;
+				}
+
+				inline glm::vec3 getScale(std::size_t i) const
+				{
+					return glm::vec3(sx[i], sy[i], sz[i]);
+				}
+
+				//recompute the changed matrices (by blocks) on the pool
+				void update(ThreadPool &pool = ThreadPool::getDefault())
+				{
+					const std::size_t blocks = (count+BLOCK-1)/BLOCK;
+					const std::size_t tasks = (blocks+TASK_BLOCKS-1)/TASK_BLOCKS;
+					if(tasks <= 1)
+					{
+						updated = updateBlocks(0, blocks)*BLOCK;
+						return;
+					}
+					std::vector<std::size_t> computed(tasks, 0);
+					pool.parallelFor(tasks, [&](std::size_t t)
+							{
+							computed[t] = updateBlocks(t*TASK_BLOCKS, std::min(blocks, (t+1)*TASK_BLOCKS));
+							});
+					updated = 0;
+					for(auto&& c : computed)
+						updated += c*BLOCK;
+				}
+
+				//matrices recomputed by the last update (multiple of the block)
+				inline std::size_t getNumUpdated() const
+				{
+					return updated;
+				}
+
+				//valid after update
+				inline const glm::mat4& getMatrix(std::size_t i) const
+				{
+					return matrices[i];
+				}
+
+				inline const glm::mat4* getMatrices() const
+				{
+					return matrices.data();
+				}
+		};
+	}
+}
@@ -0,0 +1,198 @@
+#include "../include/gl_all.h"
+#include <vector>
+#include <chrono>
+#include <SDL2/SDL.h>
+#include <IL/ilu.h>
+#include <SDL2/SDL_opengl.h>
+
+jikoLib::GLLib::GLObject obj;
+
+const std::string vshader_source = 
+#include "shader.vert"
+;
+const std::string fshader_source = 
+#include "shader.frag"
+;
+
+//the jpegs in build/ loaded with Texture::texImage2D (the frame stalls for all of them)
+//then with TextureLoader (the cubes show the placeholder until their image is uploaded).
+//prints the longest frame of each way.
+
+using Clock = std::chrono::steady_clock;
+
+inline double elapsed(Clock::time_point start)
+{
+	return std::chrono::duration<double, std::milli>(Clock::now()-start).count();
+}
+
+const std::vector<std::string> images =
+{
+	"arch-linux-226331.jpg", "negx.jpg", "posx.jpg", "negy.jpg", "posy.jpg", "negz.jpg", "posz.jpg"
+};
+
+int main(int argc, char* argv[])
+{
+	using namespace jikoLib::GLLib;
+
+
+	if(SDL_Init(SDL_INIT_EVERYTHING) < 0)
+	{
+		std::cerr << "Cannot Initialize SDL!: " << SDL_GetError() << std::endl;
+		return -1;
+	}
+
+	SDL_GL_SetAttribute(SDL_GL_RED_SIZE, 5);
+	SDL_GL_SetAttribute(SDL_GL_GREEN_SIZE, 5);
+	SDL_GL_SetAttribute(SDL_GL_BLUE_SIZE, 5);
+	SDL_GL_SetAttribute(SDL_GL_DEPTH_SIZE, 16);
+	SDL_GL_SetAttribute(SDL_GL_DOUBLEBUFFER, 1); 
+
+	SDL_Window* window = SDL_CreateWindow("SDL_Window", SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED, 400, 300, SDL_WINDOW_OPENGL);
+	if(window == NULL)
+	{
+		std::cerr << "Window could not be created!: " << SDL_GetError() << std::endl;
+	}
+
+	SDL_GLContext context;
+
+	context = SDL_GL_CreateContext(window);
+
+	obj << Begin();
+
+	SDL_GL_SetSwapInterval(0);
+
+	SDL_GL_MakeCurrent(window, context);
+
+	VShader vshader;
+	FShader fshader;
+
+	ShaderProgram program;
+
+	vshader << vshader_source;
+	fshader << fshader_source;
+
+	program << vshader << fshader << VertexLayout("vertex", "norm", "texcrd") << link_these();
+
+	Mesh3D cube;
+	MeshSample::Cube cubeHelper(0.4);
+	cube.copyData(cubeHelper.getVertex(), cubeHelper.getNormal(), cubeHelper.getTexcrd(), cubeHelper.getNumVertex());
+	cube.copyIndex(cubeHelper.getIndex(), cubeHelper.getNumIndex());
+
+	Camera camera;
+	camera.setPos(glm::vec3(0.0f, 2.0f, 6.0f));
+	camera.setDrct(glm::vec3(0.0f, 0.0f, 0.0f));
+	camera.setFar(20.0f);
+
+	int width, height;
+	SDL_GetWindowSize(window, &width, &height);
+	camera.setAspect(width, height);
+
+	program.setUniformMatrixXtv("view", glm::value_ptr(camera.getViewMatrix()), 1, 4);
+	program.setUniformMatrixXtv("projection", glm::value_ptr(camera.getProjectionMatrix()), 1, 4);
+
+	program.setUniformXt("light.ambient", 0.25f, 0.25f, 0.25f, 1.0f);
+	program.setUniformXt("light.diffuse", 1.0f, 1.0f, 1.0f, 1.0f);
+	program.setUniformXt("light.specular", 1.0f, 1.0f, 1.0f, 1.0f);
+	program.setUniformXt("light.position", 0.0f, 0.6f, 0.0f);
+
+	program.setUniformXt("material.ambient", 0.3f, 0.25f, 0.4f, 1.0f);
+	program.setUniformXt("material.diffuse", 0.75f, 0.0f, 1.0f, 1.0f);
+	program.setUniformXt("material.specular", 1.0f, 1.0f, 1.0f, 1.0f);
+	program.setUniformXt("material.shininess", 50.0f);
+
+	program.setUniformXt("textureobj", 0);
+
+	auto drawCubes = [&](const std::vector<const Texture<Texture2D>*> &textures)
+	{
+		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+		glEnable(GL_CULL_FACE);
+		glEnable(GL_DEPTH_TEST);
+		glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+		for(std::size_t i = 0; i < textures.size(); i++)
+		{
+			glm::mat4 model = glm::translate(glm::mat4(1.0f), glm::vec3(i*1.0f - (textures.size()-1)*0.5f, 0.0f, 0.0f))*cube.getModelMatrix();
+			program.setUniformMatrixXtv("model", glm::value_ptr(model), 1, 4);
+			textures[i]->bind(0);
+			obj.draw(cube, program);
+			textures[i]->unbind();
+		}
+		SDL_GL_SwapWindow( window );
+	};
+
+	//synchronous: one frame does all the loads
+	double sync_ms;
+	{
+		auto start = Clock::now();
+		std::vector<Texture<Texture2D>> textures(images.size());
+		std::vector<const Texture<Texture2D>*> bound;
+		for(std::size_t i = 0; i < images.size(); i++)
+		{
+			textures[i].texImage2D(images[i]);
+			bound.push_back(&textures[i]);
+		}
+		drawCubes(bound);
+		glFinish();
+		sync_ms = elapsed(start);
+	}
+
+	//asynchronous
+	TextureLoader loader;
+	std::vector<TextureLoader::AsyncTexture> handles;
+	double max_frame_ms = 0.0;
+	std::size_t frames = 0;
+	auto load_start = Clock::now();
+	for(auto&& image : images)
+	{
+		handles.push_back(loader.load(image));
+	}
+	double load_ms = 0.0;
+
+	bool quit = false;
+	SDL_Event e;
+
+	while( !quit )
+	{
+		//Handle events on queue
+		while( SDL_PollEvent( &e ) != 0 )
+		{
+			//User requests quit
+			if( e.type == SDL_QUIT )
+			{
+				quit = true;
+			}
+		}
+		CHECK_GL_ERROR;
+		auto frame_start = Clock::now();
+		loader.update(2.0);
+		std::vector<const Texture<Texture2D>*> bound;
+		for(auto&& handle : handles)
+		{
+			bound.push_back(&handle.get());
+		}
+		drawCubes(bound);
+		if(load_ms == 0.0)
+		{
+			max_frame_ms = std::max(max_frame_ms, elapsed(frame_start));
+			frames++;
+			if(loader.getNumPending() == 0)
+				load_ms = elapsed(load_start);
+		}
+	}
+
+	if(load_ms == 0.0)
+	{
+		//the window was closed first
+		loader.finish();
+		load_ms = elapsed(load_start);
+	}
+
+	std::cout << images.size() << " textures" << std::endl;
+	std::cout << "texImage2D (sync)    : " << sync_ms << " ms in one frame" << std::endl;
+	std::cout << "TextureLoader (async): " << load_ms << " ms over " << frames << " frames, longest frame " << max_frame_ms << " ms, "
+		<< loader.getUploadedBytes()/(1024*1024) << " MB uploaded" << std::endl;
+
+	SDL_GL_DeleteContext(context);
+	SDL_DestroyWindow(window);
+	SDL_Quit();
+	return 0;
+}
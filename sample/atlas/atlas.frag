@@ -0,0 +1,12 @@
+R"(
+#version 130
+in vec2 Texcrd;
+
+uniform sampler2DArray textureobj;
+uniform float atlas_layer;
+
+void main()
+{
+	gl_FragColor = texture(textureobj, vec3(Texcrd, atlas_layer));
+}
+)"
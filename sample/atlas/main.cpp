@@ -0,0 +1,210 @@
+#include "../include/gl_all.h"
+#include <vector>
+#include <chrono>
+#include <SDL2/SDL.h>
+#include <IL/ilu.h>
+#include <SDL2/SDL_opengl.h>
+
+jikoLib::GLLib::GLObject obj;
+
+const std::string vshader_source =
+#include "shader.vert"
+;
+const std::string fshader_source =
+#include "shader.frag"
+;
+const std::string atlas_fshader_source =
+#include "atlas.frag"
+;
+
+//many small materials: a Texture2D bind per object (before) vs one TextureAtlas texture and a uniform per object (after)
+
+const int MATERIAL_NUM = 64;
+const int OBJECT_NUM = 512;
+const int FRAME = 50;
+
+//CPU time of the submission only (glFinish is outside of the measurement)
+template<typename Func>
+double measure(Func func)
+{
+	double total = 0.0;
+	for(int f = 0; f < FRAME; f++)
+	{
+		glFinish();
+		auto start = std::chrono::steady_clock::now();
+		for(int i = 0; i < OBJECT_NUM; i++)
+		{
+			func(i);
+		}
+		auto end = std::chrono::steady_clock::now();
+		total += std::chrono::duration<double, std::nano>(end-start).count();
+	}
+	glFinish();
+	return total/(FRAME*OBJECT_NUM);
+}
+
+//checker of a random color, 16 to 256 pixels
+jikoLib::GLLib::ImageData makeImage(int seed)
+{
+	jikoLib::GLLib::ImageData image;
+	image.width = 16 << (seed % 5);
+	image.height = 16 << ((seed/5) % 5);
+	image.channels = 4;
+	image.pixels.resize(static_cast<std::size_t>(image.width)*image.height*4);
+	const GLubyte color[3] = {static_cast<GLubyte>(seed*97), static_cast<GLubyte>(seed*57), static_cast<GLubyte>(seed*31)};
+	for(GLsizei y = 0; y < image.height; y++)
+	{
+		for(GLsizei x = 0; x < image.width; x++)
+		{
+			GLubyte* p = &image.pixels[(static_cast<std::size_t>(y)*image.width + x)*4];
+			const bool odd = ((x/8) + (y/8)) % 2;
+			p[0] = odd ? color[0] : 255-color[0];
+			p[1] = odd ? color[1] : 255-color[1];
+			p[2] = odd ? color[2] : 255-color[2];
+			p[3] = 255;
+		}
+	}
+	return image;
+}
+
+int main(int argc, char* argv[])
+{
+	using namespace jikoLib::GLLib;
+
+
+	if(SDL_Init(SDL_INIT_EVERYTHING) < 0)
+	{
+		std::cerr << "Cannot Initialize SDL!: " << SDL_GetError() << std::endl;
+		return -1;
+	}
+
+	SDL_GL_SetAttribute(SDL_GL_RED_SIZE, 5);
+	SDL_GL_SetAttribute(SDL_GL_GREEN_SIZE, 5);
+	SDL_GL_SetAttribute(SDL_GL_BLUE_SIZE, 5);
+	SDL_GL_SetAttribute(SDL_GL_DEPTH_SIZE, 16);
+	SDL_GL_SetAttribute(SDL_GL_DOUBLEBUFFER, 1);
+
+	//small window: the cost of rasterization is not the point here
+	SDL_Window* window = SDL_CreateWindow("SDL_Window", SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED, 64, 64, SDL_WINDOW_OPENGL);
+	if(window == NULL)
+	{
+		std::cerr << "Window could not be created!: " << SDL_GetError() << std::endl;
+	}
+
+	SDL_GLContext context;
+
+	context = SDL_GL_CreateContext(window);
+
+	obj << Begin();
+
+	SDL_GL_MakeCurrent(window, context);
+
+	VShader vshader;
+	FShader fshader;
+	FShader atlas_fshader;
+
+	ShaderProgram program;
+	ShaderProgram atlas_program;
+
+	vshader << vshader_source;
+	fshader << fshader_source;
+	atlas_fshader << atlas_fshader_source;
+
+	program << vshader << fshader << VertexLayout("vertex", "normal", "texcrd") << link_these();
+	atlas_program << vshader << atlas_fshader << VertexLayout("vertex", "normal", "texcrd") << link_these();
+
+	Mesh3D cube;
+	MeshSample::Cube cubeHelper(0.1);
+	cube.copyData(cubeHelper.getVertex(), cubeHelper.getNormal(), cubeHelper.getTexcrd(), cubeHelper.getNumVertex());
+	cube.copyIndex(cubeHelper.getIndex(), cubeHelper.getNumIndex());
+
+	Camera camera;
+	camera.setPos(glm::vec3(0.0f, 0.0f, 5.0f));
+	camera.setDrct(glm::vec3(0.0f, 0.0f, 0.0f));
+	camera.setUp(glm::vec3(0.0f, 1.0f, 0.0f));
+	camera.setAspect(64, 64);
+
+	for(auto&& p : {&program, &atlas_program})
+	{
+		p->setUniformMatrixXtv("view", glm::value_ptr(camera.getViewMatrix()), 1, 4);
+		p->setUniformMatrixXtv("projection", glm::value_ptr(camera.getProjectionMatrix()), 1, 4);
+		p->setUniformMatrixXtv("model", glm::value_ptr(cube.getModelMatrix()), 1, 4);
+		p->setUniformXt("textureobj", 0);
+	}
+	program.setUniformXt("atlas_rect", 0.0f, 0.0f, 1.0f, 1.0f);
+
+	//a texture per material
+	std::vector<ImageData> images;
+	std::vector<std::vector<std::tuple<Texture<Texture2D>, std::size_t>>> materials(MATERIAL_NUM);
+	TextureAtlas atlas;
+	for(int m = 0; m < MATERIAL_NUM; m++)
+	{
+		ImageData image = makeImage(m);
+		Texture<Texture2D> texture;
+		texture.bind();
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, image.width, image.height, 0, GL_RGBA, GL_UNSIGNED_BYTE, image.pixels.data());
+		texture.unbind();
+		materials[m].push_back(std::make_tuple(texture, 0));
+		atlas.add("material" + std::to_string(m), std::move(image));
+	}
+
+	auto start = std::chrono::steady_clock::now();
+	Texture<Texture2DArray> array_texture;
+	atlas.build(TextureAtlas::ARRAY);
+	atlas.upload(array_texture, false);
+	double array_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now()-start).count();
+	std::vector<TextureAtlas::Region> array_regions;
+	for(int m = 0; m < MATERIAL_NUM; m++)
+		array_regions.push_back(atlas.getRegion(m));
+	std::cout << "ARRAY: " << atlas.getNumPages() << " layers of " << atlas.getPageWidth() << "x" << atlas.getPageHeight() << " (" << array_ms << " ms)" << std::endl;
+
+	start = std::chrono::steady_clock::now();
+	Texture<Texture2DArray> atlas_texture;
+	atlas.build(TextureAtlas::ATLAS, 1024);
+	atlas.upload(atlas_texture, false);
+	double atlas_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now()-start).count();
+	std::cout << "ATLAS: " << atlas.getNumPages() << " pages of " << atlas.getPageWidth() << "x" << atlas.getPageHeight() << " (" << atlas_ms << " ms)" << std::endl;
+
+	BindState &state = obj.getBindState();
+
+	//before: a bind per object
+	state.resetCount();
+	double before = measure([&](int i){
+			obj.draw(cube, program, materials[i % MATERIAL_NUM]);
+			});
+	double before_binds = static_cast<double>(state.getIssuedCount())/(FRAME*OBJECT_NUM);
+
+	//after: one bind, the layer and the uv rect per object
+	state.resetCount();
+	double array_after = measure([&](int i){
+			if(i == 0)
+				array_texture.bind(0);
+			const TextureAtlas::Region &region = array_regions[i % MATERIAL_NUM];
+			atlas_program.setUniformXt("atlas_rect", region.offset.x, region.offset.y, region.scale.x, region.scale.y);
+			atlas_program.setUniformXt("atlas_layer", static_cast<GLfloat>(region.layer));
+			obj.draw(cube, atlas_program);
+			});
+	double array_binds = static_cast<double>(state.getIssuedCount())/(FRAME*OBJECT_NUM);
+
+	state.resetCount();
+	double atlas_after = measure([&](int i){
+			if(i == 0)
+				atlas_texture.bind(0);
+			atlas.setUniform(atlas_program, i % MATERIAL_NUM);
+			obj.draw(cube, atlas_program);
+			});
+	double atlas_binds = static_cast<double>(state.getIssuedCount())/(FRAME*OBJECT_NUM);
+	atlas_texture.unbind();
+
+	std::cout << "per draw (" << OBJECT_NUM << " objects, " << MATERIAL_NUM << " materials x " << FRAME << " frames)" << std::endl;
+	std::cout << "                               ns    bind calls" << std::endl;
+	std::cout << "Texture2D per material      : " << before << "  " << before_binds << std::endl;
+	std::cout << "TextureAtlas (ARRAY)        : " << array_after << "  " << array_binds << std::endl;
+	std::cout << "TextureAtlas (ATLAS)        : " << atlas_after << "  " << atlas_binds << std::endl;
+
+	SDL_GL_DeleteContext(context);
+	SDL_DestroyWindow(window);
+	SDL_Quit();
+	return 0;
+}
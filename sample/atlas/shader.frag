@@ -0,0 +1,11 @@
+R"(
+#version 130
+in vec2 Texcrd;
+
+uniform sampler2D textureobj;
+
+void main()
+{
+	gl_FragColor = texture(textureobj, Texcrd);
+}
+)"
@@ -0,0 +1,21 @@
+R"(
+#version 130
+
+in vec3 vertex;
+in vec3 normal;
+in vec2 texcrd;
+
+uniform mat4 model;
+uniform mat4 view;
+uniform mat4 projection;
+//uv rect in the atlas (offset.xy, scale.zw)
+uniform vec4 atlas_rect;
+
+out vec2 Texcrd;
+
+void main()
+{
+	Texcrd = texcrd*atlas_rect.zw + atlas_rect.xy;
+	gl_Position = projection*view*model*vec4(vertex, 1.0);
+}
+)"
@@ -64,7 +64,7 @@ int main(int argc, char* argv[])
 	vshader << vshader_source;
 	fshader << fshader_source;
 
-	program << vshader << fshader << link_these();
+	program << vshader << fshader << VertexLayout("vertex", "norm", "texcrd") << link_these();
 
 	Texture<Texture2D> texture;
 	texture.texImage2D("texture.jpg");
@@ -73,6 +73,7 @@ int main(int argc, char* argv[])
 	MeshSample::Sphere sphereHelper(1.0, 30, 30);
 	MeshSample::Cube cubeHelper(1.0);
 	cube.copyData(cubeHelper.getVertex(), cubeHelper.getNormal(), cubeHelper.getTexcrd(), cubeHelper.getNumVertex());
+	cube.copyIndex(cubeHelper.getIndex(), cubeHelper.getNumIndex());
 
 	Camera camera;
 	camera.setPos(glm::vec3(3.0f, 3.0f, -2.0f));
@@ -84,10 +85,6 @@ int main(int argc, char* argv[])
 	SDL_GetWindowSize(window, &width, &height);
 	camera.setAspect(width, height);
 
-	obj.connectAttrib(program, cube.getNormal(), cube.getVArray(), "norm");
-	obj.connectAttrib(program, cube.getVertex(), cube.getVArray(), "vertex");
-	obj.connectAttrib(program, cube.getTexcrd(), cube.getVArray(), "texcrd");
-
 	program.setUniformMatrixXtv("model", glm::value_ptr(cube.getModelMatrix()), 1, 4);
 	program.setUniformMatrixXtv("view", glm::value_ptr(camera.getViewMatrix()), 1, 4);
 	program.setUniformMatrixXtv("projection", glm::value_ptr(camera.getProjectionMatrix()), 1, 4);
@@ -0,0 +1,142 @@
+#include "../include/gl_all.h"
+#include <vector>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <thread>
+#include <SDL2/SDL.h>
+#include <IL/ilu.h>
+#include <SDL2/SDL_opengl.h>
+
+jikoLib::GLLib::GLObject obj;
+
+//BlockCompressor: encode throughput (MPix/s) on 1..N threads, memory of the texture and the error (PSNR of RGB).
+//the blocks are decoded by the driver (glGetTexImage) when S3TC is supported, by BlockCompressor::decode otherwise.
+
+using Clock = std::chrono::steady_clock;
+
+inline double elapsed(Clock::time_point start)
+{
+	return std::chrono::duration<double, std::milli>(Clock::now()-start).count();
+}
+
+template<typename Func>
+double bestOf(int repeat, Func func)
+{
+	double best = 0.0;
+	for(int i = 0; i < repeat; i++)
+	{
+		auto start = Clock::now();
+		func();
+		double ms = elapsed(start);
+		if(i == 0 || ms < best)
+			best = ms;
+	}
+	return best;
+}
+
+double psnr(const jikoLib::GLLib::ImageData &source, const std::vector<GLubyte> &rgba)
+{
+	double error = 0.0;
+	const std::size_t pixels = static_cast<std::size_t>(source.width)*source.height;
+	for(std::size_t i = 0; i < pixels; i++)
+	{
+		for(std::size_t k = 0; k < 3; k++)
+		{
+			const double d = static_cast<double>(source.pixels[i*source.channels+k]) - rgba[i*4+k];
+			error += d*d;
+		}
+	}
+	error /= pixels*3;
+	if(error == 0.0)
+		return 99.0;
+	return 10.0*std::log10(255.0*255.0/error);
+}
+
+template<typename int_format>
+void bench(const std::string &label, const jikoLib::GLLib::ImageData &image, int repeat)
+{
+	using namespace jikoLib::GLLib;
+	const double megapixels = static_cast<double>(image.width)*image.height/1e6;
+	std::size_t max_threads = std::thread::hardware_concurrency();
+	if(max_threads == 0)
+		max_threads = 1;
+	CompressedImage blocks;
+	for(std::size_t threads = 1; threads <= max_threads; threads *= 2)
+	{
+		ThreadPool pool(threads);
+		double ms = bestOf(repeat, [&]()
+				{
+				blocks = BlockCompressor::encode<int_format>(image, pool);
+				});
+		std::cout << label << " " << threads << " threads: " << std::setw(8) << ms << " ms  " << std::setw(8) << megapixels*1000.0/ms << " MPix/s" << std::endl;
+	}
+
+	const std::size_t raw = static_cast<std::size_t>(image.width)*image.height*4;
+	std::vector<GLubyte> decoded(raw);
+	if(GLEW_EXT_texture_compression_s3tc)
+	{
+		Texture<Texture2D> texture;
+		texture.compressedTexImage2D<0, int_format>(blocks.width, blocks.height, blocks.data.size(), blocks.data.data());
+		texture.bind();
+		glPixelStorei(GL_PACK_ALIGNMENT, 1);
+		glGetTexImage(GL_TEXTURE_2D, 0, GL_RGBA, GL_UNSIGNED_BYTE, decoded.data());
+		CHECK_GL_ERROR;
+		texture.unbind();
+	}
+	else
+		decoded = BlockCompressor::decode(blocks).pixels;
+	std::cout << label << " " << raw << " B (RGBA8) -> " << blocks.data.size() << " B (" << static_cast<double>(raw)/blocks.data.size() << ":1)  PSNR " << psnr(image, decoded) << " dB" << std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+	using namespace jikoLib::GLLib;
+
+
+	if(SDL_Init(SDL_INIT_EVERYTHING) < 0)
+	{
+		std::cerr << "Cannot Initialize SDL!: " << SDL_GetError() << std::endl;
+		return -1;
+	}
+
+	SDL_GL_SetAttribute(SDL_GL_RED_SIZE, 5);
+	SDL_GL_SetAttribute(SDL_GL_GREEN_SIZE, 5);
+	SDL_GL_SetAttribute(SDL_GL_BLUE_SIZE, 5);
+	SDL_GL_SetAttribute(SDL_GL_DEPTH_SIZE, 16);
+	SDL_GL_SetAttribute(SDL_GL_DOUBLEBUFFER, 1);
+
+	SDL_Window* window = SDL_CreateWindow("SDL_Window", SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED, 64, 64, SDL_WINDOW_OPENGL);
+	if(window == NULL)
+	{
+		std::cerr << "Window could not be created!: " << SDL_GetError() << std::endl;
+	}
+
+	SDL_GLContext context;
+
+	context = SDL_GL_CreateContext(window);
+
+	obj << Begin();
+
+	SDL_GL_MakeCurrent(window, context);
+
+	//bcbench [image] [repeat]
+	const std::string path = (argc > 1) ? argv[1] : "arch-linux-226331.jpg";
+	const int repeat = (argc > 2) ? std::atoi(argv[2]) : 3;
+
+	ImageData image;
+	if(!ImageDecoder::decode(path, 4, image))
+	{
+		std::cerr << "cannot load image " << path << std::endl;
+		return -1;
+	}
+	std::cout << path << ": " << image.width << "x" << image.height << std::endl;
+
+	bench<BC1>("BC1", image, repeat);
+	bench<BC3>("BC3", image, repeat);
+
+	SDL_GL_DeleteContext(context);
+	SDL_DestroyWindow(window);
+	SDL_Quit();
+	return 0;
+}
@@ -0,0 +1,183 @@
+#include "../include/gl_all.h"
+#include <vector>
+#include <limits>
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <thread>
+
+//BVH over 10k and 1M boxes (clustered like a city of buildings):
+//build on 1..N threads, refit after all moved, update of 1% of them, and the queries
+//(frustum cull vs CullBatch, ray casts and nearest objects vs brute force).
+
+const float WORLD_SIZE = 1000.0f;
+const std::size_t QUERY_NUM = 10000;
+const int REPEAT = 5;
+
+using Clock = std::chrono::steady_clock;
+
+template<typename Func>
+double bestOf(int repeat, Func func)
+{
+	double best = 0.0;
+	for(int i = 0; i < repeat; i++)
+	{
+		auto start = Clock::now();
+		func();
+		double ms = std::chrono::duration<double, std::milli>(Clock::now()-start).count();
+		if(i == 0 || ms < best)
+			best = ms;
+	}
+	return best;
+}
+
+void printResult(const std::string &label, double ms, const std::string &note = "")
+{
+	std::cout << "  " << label << ms << " ms" << (note.empty() ? "" : "  ") << note << std::endl;
+}
+
+std::vector<jikoLib::GLLib::BoundingBox> makeBoxes(std::size_t num, std::mt19937 &rng)
+{
+	using namespace jikoLib::GLLib;
+	std::uniform_real_distribution<float> world_dist(-WORLD_SIZE, WORLD_SIZE);
+	std::normal_distribution<float> cluster_dist(0.0f, WORLD_SIZE/50.0f);
+	std::uniform_real_distribution<float> size_dist(0.5f, 5.0f);
+	std::vector<glm::vec3> clusters(64);
+	for(auto&& c : clusters)
+		c = glm::vec3(world_dist(rng), world_dist(rng)*0.1f, world_dist(rng));
+	std::vector<BoundingBox> boxes(num);
+	for(std::size_t i = 0; i < num; i++)
+	{
+		const glm::vec3 center = clusters[i%clusters.size()] + glm::vec3(cluster_dist(rng), cluster_dist(rng)*0.2f, cluster_dist(rng));
+		const glm::vec3 extent(size_dist(rng), size_dist(rng)*2.0f, size_dist(rng));
+		boxes[i] = BoundingBox(center-extent, center+extent);
+	}
+	return boxes;
+}
+
+bool run(std::size_t num)
+{
+	using namespace jikoLib::GLLib;
+
+	std::mt19937 rng(1);
+	std::vector<BoundingBox> boxes = makeBoxes(num, rng);
+	std::cout << num << " objects" << std::endl;
+
+	BVH bvh;
+	std::size_t max_threads = std::thread::hardware_concurrency();
+	if(max_threads == 0)
+		max_threads = 1;
+	for(std::size_t threads = 1; threads <= max_threads; threads *= 2)
+	{
+		ThreadPool pool(threads);
+		const double ms = bestOf(REPEAT, [&](){ bvh.build(boxes, pool); });
+		printResult("build (" + std::to_string(threads) + " threads)" + ((threads < 10) ? " " : "") + "  : ", ms, std::to_string(bvh.getNodes().size()) + " nodes");
+	}
+
+	//everything moved a little / 1% moved
+	std::uniform_real_distribution<float> move_dist(-1.0f, 1.0f);
+	std::vector<BoundingBox> moved = boxes;
+	for(auto&& box : moved)
+	{
+		const glm::vec3 d(move_dist(rng), move_dist(rng), move_dist(rng));
+		box = BoundingBox(box.min+d, box.max+d);
+	}
+	double ms = bestOf(REPEAT, [&](){ bvh.refit(moved); });
+	printResult("refit (all moved)   : ", ms);
+	ms = bestOf(REPEAT, [&]()
+			{
+			for(std::size_t i = 0; i < num; i += 100)
+				bvh.update(i, boxes[i]);
+			});
+	printResult("update (1% moved)   : ", ms);
+	bvh.refit(boxes);
+
+	bool ok = true;
+
+	//frustum from inside the world (sees a part of it): the same set as the flat test
+	Camera camera;
+	camera.setPos(glm::vec3(0.0f, 20.0f, 0.0f));
+	camera.setDrct(glm::vec3(WORLD_SIZE, 0.0f, WORLD_SIZE*0.3f));
+	camera.setFovy(M_PI/4.0);
+	camera.setAspect(1280.0f, 720.0f);
+	camera.setFar(WORLD_SIZE*0.5f);
+	const Frustum frustum = camera.getFrustum();
+	CullBatch batch(num);
+	for(std::size_t i = 0; i < num; i++)
+		batch.set(i, boxes[i]);
+	std::vector<std::uint32_t> flat, tree;
+	ms = bestOf(REPEAT, [&](){ batch.cull(frustum, flat, CullBatch::BOX); });
+	printResult("CullBatch cull      : ", ms, std::to_string(flat.size()) + " visible");
+	ms = bestOf(REPEAT, [&](){ bvh.cull(frustum, tree); });
+	printResult("BVH cull            : ", ms, std::to_string(tree.size()) + " visible");
+	std::sort(tree.begin(), tree.end());
+	if(tree != flat)
+	{
+		std::cout << "  BVH cull differs from CullBatch" << std::endl;
+		ok = false;
+	}
+
+	//rays from above the world to random points on the ground
+	std::uniform_real_distribution<float> world_dist(-WORLD_SIZE, WORLD_SIZE);
+	std::vector<BVH::Ray> rays(QUERY_NUM);
+	std::vector<glm::vec3> points(QUERY_NUM);
+	for(std::size_t i = 0; i < QUERY_NUM; i++)
+	{
+		const glm::vec3 origin(world_dist(rng), WORLD_SIZE, world_dist(rng));
+		const glm::vec3 target(world_dist(rng), -WORLD_SIZE, world_dist(rng));
+		rays[i] = BVH::Ray(origin, glm::normalize(target-origin));
+		points[i] = glm::vec3(world_dist(rng), world_dist(rng)*0.1f, world_dist(rng));
+	}
+	std::vector<BVH::RayHit> hits;
+	for(std::size_t threads = 1; threads <= max_threads; threads *= 2)
+	{
+		ThreadPool pool(threads);
+		ms = bestOf(REPEAT, [&](){ bvh.raycast(rays, hits, std::numeric_limits<float>::infinity(), pool); });
+		printResult(std::to_string(QUERY_NUM) + " rays (" + std::to_string(threads) + " threads): ", ms);
+	}
+	std::vector<std::uint32_t> nearest(QUERY_NUM);
+	ms = bestOf(REPEAT, [&]()
+			{
+			for(std::size_t i = 0; i < QUERY_NUM; i++)
+			{
+				float distance;
+				nearest[i] = bvh.nearest(points[i], distance);
+			}
+			});
+	printResult(std::to_string(QUERY_NUM) + " nearest      : ", ms);
+
+	//brute force on a part of the queries
+	const std::size_t check = std::min<std::size_t>(QUERY_NUM, 10000000/num + 1);
+	std::size_t ray_errors = 0, nearest_errors = 0;
+	for(std::size_t q = 0; q < check; q++)
+	{
+		const glm::vec3 inv_dir = glm::vec3(1.0f)/rays[q].direction;
+		float best_ray = std::numeric_limits<float>::infinity(), best_point = std::numeric_limits<float>::infinity();
+		for(std::size_t i = 0; i < num; i++)
+		{
+			const glm::vec3 t0 = (boxes[i].min-rays[q].origin)*inv_dir, t1 = (boxes[i].max-rays[q].origin)*inv_dir;
+			const glm::vec3 tmin = glm::min(t0, t1), tmax = glm::max(t0, t1);
+			const float enter = std::max(std::max(tmin.x, tmin.y), std::max(tmin.z, 0.0f));
+			const float exit = std::min(std::min(tmax.x, tmax.y), tmax.z);
+			if(enter <= exit)
+				best_ray = std::min(best_ray, enter);
+			const glm::vec3 d = glm::max(glm::max(boxes[i].min-points[q], points[q]-boxes[i].max), glm::vec3(0.0f));
+			best_point = std::min(best_point, glm::dot(d, d));
+		}
+		const float hit_distance = (hits[q].object == BVH::NONE) ? std::numeric_limits<float>::infinity() : hits[q].distance;
+		if(hit_distance != best_ray)
+			ray_errors++;
+		const glm::vec3 d = glm::max(glm::max(boxes[nearest[q]].min-points[q], points[q]-boxes[nearest[q]].max), glm::vec3(0.0f));
+		if(glm::dot(d, d) != best_point)
+			nearest_errors++;
+	}
+	std::cout << "  brute force check of " << check << " queries: " << ray_errors << " ray / " << nearest_errors << " nearest mismatches" << std::endl;
+	return ok && ray_errors == 0 && nearest_errors == 0;
+}
+
+int main(int argc, char* argv[])
+{
+	const bool ok_small = run(10000);
+	const bool ok_large = run(1000000);
+	return (ok_small && ok_large) ? 0 : 1;
+}
@@ -0,0 +1,122 @@
+#include "../include/gl_all.h"
+#include <vector>
+#include <chrono>
+#include <cstdio>
+#include <SDL2/SDL.h>
+#include <IL/ilu.h>
+#include <SDL2/SDL_opengl.h>
+
+jikoLib::GLLib::GLObject obj;
+
+//startup time of a model: AssimpLoader (parse every time) vs MeshCache
+//cold: no cache (parse with Assimp and cook the cache), warm: map the cache and upload
+//usage: prog [model file] (default: Porsche_911_GT2.obj)
+
+using Clock = std::chrono::steady_clock;
+
+inline double elapsed(Clock::time_point start)
+{
+	return std::chrono::duration<double, std::milli>(Clock::now()-start).count();
+}
+
+int main(int argc, char* argv[])
+{
+	using namespace jikoLib::GLLib;
+
+
+	if(SDL_Init(SDL_INIT_EVERYTHING) < 0)
+	{
+		std::cerr << "Cannot Initialize SDL!: " << SDL_GetError() << std::endl;
+		return -1;
+	}
+
+	SDL_GL_SetAttribute(SDL_GL_RED_SIZE, 5);
+	SDL_GL_SetAttribute(SDL_GL_GREEN_SIZE, 5);
+	SDL_GL_SetAttribute(SDL_GL_BLUE_SIZE, 5);
+	SDL_GL_SetAttribute(SDL_GL_DEPTH_SIZE, 16);
+	SDL_GL_SetAttribute(SDL_GL_DOUBLEBUFFER, 1);
+
+	SDL_Window* window = SDL_CreateWindow("SDL_Window", SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED, 64, 64, SDL_WINDOW_OPENGL);
+	if(window == NULL)
+	{
+		std::cerr << "Window could not be created!: " << SDL_GetError() << std::endl;
+	}
+
+	SDL_GLContext context;
+
+	context = SDL_GL_CreateContext(window);
+
+	obj << Begin();
+
+	SDL_GL_MakeCurrent(window, context);
+
+	std::string path = (argc > 1) ? argv[1] : "Porsche_911_GT2.obj";
+	std::string cache_path = path + ".jmesh";
+
+	//AssimpLoader
+	auto start = Clock::now();
+	std::size_t mesh_num = 0;
+	{
+		AssimpLoader loader(path);
+		if(loader.getScene() == nullptr)
+		{
+			std::cerr << path << " cannot be loaded." << std::endl;
+			SDL_GL_DeleteContext(context);
+			SDL_DestroyWindow(window);
+			SDL_Quit();
+			return -1;
+		}
+		std::vector<Mesh3D> meshes = AssimpLoader::upload(loader.convert());
+		mesh_num = meshes.size();
+		glFinish();
+	}
+	double assimp_ms = elapsed(start);
+
+	//cold
+	std::remove(cache_path.c_str());
+	start = Clock::now();
+	{
+		MeshCache cache;
+		cache.load(path, cache_path);
+		std::vector<Mesh3D> meshes = cache.upload();
+		glFinish();
+	}
+	double cold_ms = elapsed(start);
+
+	//warm
+	start = Clock::now();
+	std::size_t cache_size = 0;
+	{
+		MeshCache cache;
+		if(!cache.load(path, cache_path))
+			std::cerr << "cache cannot be loaded" << std::endl;
+		else
+			cache_size = cache.getHeader().file_size;
+		std::vector<Mesh3D> meshes = cache.upload();
+		glFinish();
+	}
+	double warm_ms = elapsed(start);
+
+	//warm, one pool
+	start = Clock::now();
+	{
+		MeshCache cache;
+		cache.load(path, cache_path);
+		MeshPool pool;
+		cache.upload(pool);
+		glFinish();
+	}
+	double pool_ms = elapsed(start);
+
+	std::cout << path << ": " << mesh_num << " meshes, cache " << cache_size/1024 << " KB" << std::endl;
+	std::cout << "                        ms" << std::endl;
+	std::cout << "AssimpLoader        : " << assimp_ms << std::endl;
+	std::cout << "MeshCache (cold)    : " << cold_ms << std::endl;
+	std::cout << "MeshCache (warm)    : " << warm_ms << std::endl;
+	std::cout << "MeshCache -> pool   : " << pool_ms << std::endl;
+
+	SDL_GL_DeleteContext(context);
+	SDL_DestroyWindow(window);
+	SDL_Quit();
+	return 0;
+}
@@ -1,5 +1,6 @@
 #include "../include/gl_all.h"
 #include <vector>
+#include <chrono>
 #include <SDL2/SDL.h>
 #include <IL/ilu.h>
 #include <SDL2/SDL_opengl.h>
@@ -65,25 +66,31 @@ int main(int argc, char* argv[])
 	vshader << vshader_source;
 	fshader << fshader_source;
 
-	program << vshader << fshader << link_these();
+	program << vshader << fshader << VertexLayout("vertex", "normal", "texcrd") << link_these();
 
 	Mesh3D mesh;
 	MeshSample::CubeMap cube(1024);
 	mesh.copyData(cube.getVertex(), cube.getNormal(), cube.getTexcrd(), cube.getNumVertex());
+	mesh.copyIndex(cube.getIndex(), cube.getNumIndex());
 
 	Mesh3D mesh_sp;
 	MeshSample::Sphere sphere(30.0f, 50, 50);
 	mesh_sp.copyData(sphere.getVertex(), sphere.getNormal(), sphere.getTexcrd(), sphere.getNumVertex());
+	mesh_sp.copyIndex(sphere.getIndex(), sphere.getNumIndex());
 	mesh_sp.setPos(glm::vec3(0.0f, 0.0f, -200.0f));
 
 	Camera camera;
 	camera.setUp(glm::vec3(0.0f, 1.0f, 0.0f));
 	camera.setFar(1024);
 
+	//skybox startup time (the faces are decoded in parallel)
+	auto load_start = std::chrono::steady_clock::now();
 	Texture<TextureCubeMap> texture;
 	texture.texImage2D("negx.jpg","posx.jpg","negy.jpg","posy.jpg","negz.jpg","posz.jpg");
 	texture.setParameter<Mag_Filter<GL_LINEAR>, Min_Filter<GL_LINEAR>>();
 	texture.generateMipmap();
+	glFinish();
+	std::cout << "skybox loaded in " << std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now()-load_start).count() << " ms" << std::endl;
 
 	program.setUniformXt("textureobj", 0);
 
@@ -183,14 +190,12 @@ int main(int argc, char* argv[])
 
 		program.setUniformMatrixXtv("model", glm::value_ptr(mesh.getModelMatrix()), 1, 4);
 		program.setUniformXt("drawsphere", 0);
-		obj.connectAttrib(program, mesh, "vertex", "normal", "texcrd");
 		texture.bind(0);
 		obj.draw(mesh, program);
 		texture.unbind();
 
 		program.setUniformMatrixXtv("model", glm::value_ptr(mesh_sp.getModelMatrix()), 1, 4);
 		program.setUniformXt("drawsphere", 1);
-		obj.connectAttrib(program, mesh_sp, "vertex", "normal", "texcrd");
 		texture.bind(0);
 		obj.draw(mesh_sp, program);
 		texture.unbind();
@@ -0,0 +1,102 @@
+#include "../include/gl_all.h"
+#include <vector>
+#include <chrono>
+#include <random>
+#include <thread>
+
+//frustum culling of 1M boxes scattered around the camera:
+//Frustum::isVisible per box (scalar) vs CullBatch (SSE 4 / AVX 8 boxes per instruction) on 1..N threads.
+//build with -mavx (or -march=native) for the AVX kernel.
+
+const std::size_t OBJECT_NUM = 1000000;
+const float WORLD_SIZE = 1000.0f;
+const int REPEAT = 20;
+
+using Clock = std::chrono::steady_clock;
+
+template<typename Func>
+double bestOf(int repeat, Func func)
+{
+	double best = 0.0;
+	for(int i = 0; i < repeat; i++)
+	{
+		auto start = Clock::now();
+		func();
+		double ms = std::chrono::duration<double, std::milli>(Clock::now()-start).count();
+		if(i == 0 || ms < best)
+			best = ms;
+	}
+	return best;
+}
+
+void printResult(const std::string &label, double ms, std::size_t visible)
+{
+	std::cout << label << ms << " ms  " << OBJECT_NUM/ms/1000.0 << " M boxes/s  (" << visible << " visible)" << std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+	using namespace jikoLib::GLLib;
+
+	std::mt19937 rng(1);
+	std::uniform_real_distribution<float> pos_dist(-WORLD_SIZE, WORLD_SIZE);
+	std::uniform_real_distribution<float> size_dist(0.5f, 5.0f);
+	std::vector<BoundingBox> boxes(OBJECT_NUM);
+	CullBatch batch(OBJECT_NUM);
+	for(std::size_t i = 0; i < OBJECT_NUM; i++)
+	{
+		const glm::vec3 center(pos_dist(rng), pos_dist(rng), pos_dist(rng));
+		const glm::vec3 extent(size_dist(rng), size_dist(rng), size_dist(rng));
+		boxes[i] = BoundingBox(center-extent, center+extent);
+		batch.set(i, boxes[i]);
+	}
+
+	Camera camera;
+	camera.setPos(glm::vec3(0.0f, 0.0f, 0.0f));
+	camera.setDrct(glm::vec3(1.0f, 0.2f, 0.3f));
+	camera.setFovy(M_PI/3.0);
+	camera.setAspect(1280.0f, 720.0f);
+	camera.setNear(0.1f);
+	camera.setFar(WORLD_SIZE);
+	const Frustum frustum = camera.getFrustum();
+
+	std::cout << OBJECT_NUM << " boxes" << std::endl;
+
+	std::vector<std::uint32_t> expected;
+	double ms = bestOf(REPEAT, [&]()
+			{
+			expected.clear();
+			for(std::size_t i = 0; i < OBJECT_NUM; i++)
+			{
+				if(frustum.isVisible(boxes[i]))
+					expected.push_back(i);
+			}
+			});
+	printResult("scalar box test         : ", ms, expected.size());
+
+	std::vector<std::uint32_t> visible;
+	std::size_t max_threads = std::thread::hardware_concurrency();
+	if(max_threads == 0)
+		max_threads = 1;
+	for(std::size_t threads = 1; threads <= max_threads; threads *= 2)
+	{
+		ThreadPool pool(threads);
+		ms = bestOf(REPEAT, [&]()
+				{
+				batch.cull(frustum, visible, CullBatch::BOX, pool);
+				});
+		printResult("CullBatch box (" + std::to_string(threads) + " threads)" + ((threads < 10) ? " " : "") + ": ", ms, visible.size());
+	}
+	//the same list as the scalar test
+	const bool same = (visible == expected);
+
+	std::vector<std::uint32_t> sphere_visible;
+	ms = bestOf(REPEAT, [&]()
+			{
+			batch.cull(frustum, sphere_visible, CullBatch::SPHERE);
+			});
+	printResult("CullBatch sphere        : ", ms, sphere_visible.size());
+
+	std::cout << "box result " << (same ? "matches" : "DIFFERS FROM") << " the scalar test" << std::endl;
+	return same ? 0 : 1;
+}
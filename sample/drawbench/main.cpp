@@ -0,0 +1,139 @@
+#include "../include/gl_all.h"
+#include <vector>
+#include <chrono>
+#include <SDL2/SDL.h>
+#include <IL/ilu.h>
+#include <SDL2/SDL_opengl.h>
+
+jikoLib::GLLib::GLObject obj;
+
+const std::string vshader_source =
+#include "shader.vert"
+;
+const std::string fshader_source =
+#include "shader.frag"
+;
+
+//per-draw submission cost: connectAttrib before every draw (before) vs attributes baked in the vertex array (after)
+
+const int MESH_NUM = 100;
+const int FRAME = 100;
+
+//CPU time of the submission only (glFinish is outside of the measurement)
+template<typename Func>
+double measure(Func func)
+{
+	double total = 0.0;
+	for(int f = 0; f < FRAME; f++)
+	{
+		glFinish();
+		auto start = std::chrono::steady_clock::now();
+		for(int i = 0; i < MESH_NUM; i++)
+		{
+			func(i);
+		}
+		auto end = std::chrono::steady_clock::now();
+		total += std::chrono::duration<double, std::nano>(end-start).count();
+	}
+	glFinish();
+	return total/(FRAME*MESH_NUM);
+}
+
+int main(int argc, char* argv[])
+{
+	using namespace jikoLib::GLLib;
+
+
+	if(SDL_Init(SDL_INIT_EVERYTHING) < 0)
+	{
+		std::cerr << "Cannot Initialize SDL!: " << SDL_GetError() << std::endl;
+		return -1;
+	}
+
+	SDL_GL_SetAttribute(SDL_GL_RED_SIZE, 5);
+	SDL_GL_SetAttribute(SDL_GL_GREEN_SIZE, 5);
+	SDL_GL_SetAttribute(SDL_GL_BLUE_SIZE, 5);
+	SDL_GL_SetAttribute(SDL_GL_DEPTH_SIZE, 16);
+	SDL_GL_SetAttribute(SDL_GL_DOUBLEBUFFER, 1);
+
+	//small window: the cost of rasterization is not the point here
+	SDL_Window* window = SDL_CreateWindow("SDL_Window", SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED, 64, 64, SDL_WINDOW_OPENGL);
+	if(window == NULL)
+	{
+		std::cerr << "Window could not be created!: " << SDL_GetError() << std::endl;
+	}
+
+	SDL_GLContext context;
+
+	context = SDL_GL_CreateContext(window);
+
+	obj << Begin();
+
+	SDL_GL_MakeCurrent(window, context);
+
+	VShader vshader;
+	FShader fshader;
+
+	ShaderProgram program;
+
+	vshader << vshader_source;
+	fshader << fshader_source;
+
+	program << vshader << fshader << VertexLayout("vertex", "normal", "texcrd") << link_these();
+
+	MeshSample::Sphere spherehelper(0.1, 8, 8);
+	std::vector<Mesh3D> meshes(MESH_NUM);
+	for(auto&& mesh : meshes)
+	{
+		mesh.copyData(spherehelper.getVertex(), spherehelper.getNormal(), spherehelper.getTexcrd(), spherehelper.getNumVertex());
+		mesh.copyIndex(spherehelper.getIndex(), spherehelper.getNumIndex());
+	}
+
+	Camera camera;
+	camera.setPos(glm::vec3(0.0f, 0.0f, 5.0f));
+	camera.setDrct(glm::vec3(0.0f, 0.0f, 0.0f));
+	camera.setUp(glm::vec3(0.0f, 1.0f, 0.0f));
+	camera.setAspect(64, 64);
+
+	program.setUniformMatrixXtv("view", glm::value_ptr(camera.getViewMatrix()), 1, 4);
+	program.setUniformMatrixXtv("projection", glm::value_ptr(camera.getProjectionMatrix()), 1, 4);
+	glm::mat4 model_mat = meshes[0].getModelMatrix();
+	program.setUniformMatrixXtv("model", glm::value_ptr(model_mat), 1, 4);
+
+	BindState &state = obj.getBindState();
+
+	//before: what the samples did in the render loop
+	state.resetCount();
+	double before = measure([&](int i){
+			obj.connectAttrib(program, meshes[i], "vertex", "normal", "texcrd");
+			obj.draw(meshes[i], program);
+			});
+	double before_binds = static_cast<double>(state.getIssuedCount())/(FRAME*MESH_NUM);
+
+	//after: the attributes are set once in copyData
+	state.resetCount();
+	double after = measure([&](int i){
+			obj.draw(meshes[i], program);
+			});
+	double after_binds = static_cast<double>(state.getIssuedCount())/(FRAME*MESH_NUM);
+
+	//after + objects are left bound
+	state.setUnbindToZero(false);
+	state.resetCount();
+	double lazy = measure([&](int i){
+			obj.draw(meshes[i], program);
+			});
+	double lazy_binds = static_cast<double>(state.getIssuedCount())/(FRAME*MESH_NUM);
+	state.setUnbindToZero(true);
+
+	std::cout << "per draw (" << MESH_NUM << " meshes x " << FRAME << " frames)" << std::endl;
+	std::cout << "                            ns    bind calls" << std::endl;
+	std::cout << "connectAttrib + draw     : " << before << "  " << before_binds << std::endl;
+	std::cout << "baked layout             : " << after << "  " << after_binds << std::endl;
+	std::cout << "baked layout (no unbind) : " << lazy << "  " << lazy_binds << std::endl;
+
+	SDL_GL_DeleteContext(context);
+	SDL_DestroyWindow(window);
+	SDL_Quit();
+	return 0;
+}
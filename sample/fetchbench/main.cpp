@@ -0,0 +1,180 @@
+#include "../include/gl_all.h"
+#include <vector>
+#include <chrono>
+#include <SDL2/SDL.h>
+#include <IL/ilu.h>
+#include <SDL2/SDL_opengl.h>
+
+jikoLib::GLLib::GLObject obj;
+
+const std::string vshader_source =
+#include "shader.vert"
+;
+const std::string fshader_source =
+#include "shader.frag"
+;
+
+//vertex fetch throughput: three VBOs per mesh (separate) vs one interleaved VBO
+//usage: prog [model file] (default: Porsche_911_GT2.obj)
+
+const int DRAW_NUM = 20;
+
+struct ModelData
+{
+	std::vector<GLfloat> vertex;
+	std::vector<GLfloat> normal;
+	std::vector<GLfloat> texcrd;
+	std::vector<GLuint> index;
+};
+
+//all meshes of the scene in one array
+bool loadModel(const std::string &path, ModelData &data)
+{
+	using namespace jikoLib::GLLib;
+	AssimpLoader loader(path);
+	const aiScene *scene = loader.getScene();
+	if(scene == nullptr || !scene->HasMeshes())
+		return false;
+
+	for(unsigned int m = 0; m < scene->mNumMeshes; m++)
+	{
+		const aiMesh *mesh = scene->mMeshes[m];
+		GLuint base = data.vertex.size()/3;
+		for(unsigned int v = 0; v < mesh->mNumVertices; v++)
+		{
+			data.vertex.insert(data.vertex.end(), {mesh->mVertices[v].x, mesh->mVertices[v].y, mesh->mVertices[v].z});
+			if(mesh->HasNormals())
+				data.normal.insert(data.normal.end(), {mesh->mNormals[v].x, mesh->mNormals[v].y, mesh->mNormals[v].z});
+			else
+				data.normal.insert(data.normal.end(), {0.0f, 0.0f, 1.0f});
+			if(mesh->HasTextureCoords(0))
+				data.texcrd.insert(data.texcrd.end(), {mesh->mTextureCoords[0][v].x, mesh->mTextureCoords[0][v].y});
+			else
+				data.texcrd.insert(data.texcrd.end(), {0.0f, 0.0f});
+		}
+		for(unsigned int f = 0; f < mesh->mNumFaces; f++)
+		{
+			const aiFace &face = mesh->mFaces[f];
+			if(face.mNumIndices != 3)
+				continue;
+			for(unsigned int i = 0; i < 3; i++)
+				data.index.push_back(base + face.mIndices[i]);
+		}
+	}
+	return true;
+}
+
+template<typename Func>
+double measure(Func func)
+{
+	func();
+	glFinish();
+	auto start = std::chrono::steady_clock::now();
+	for(int i = 0; i < DRAW_NUM; i++)
+	{
+		func();
+	}
+	glFinish();
+	auto end = std::chrono::steady_clock::now();
+	return std::chrono::duration<double, std::milli>(end-start).count()/DRAW_NUM;
+}
+
+int main(int argc, char* argv[])
+{
+	using namespace jikoLib::GLLib;
+
+
+	if(SDL_Init(SDL_INIT_EVERYTHING) < 0)
+	{
+		std::cerr << "Cannot Initialize SDL!: " << SDL_GetError() << std::endl;
+		return -1;
+	}
+
+	SDL_GL_SetAttribute(SDL_GL_RED_SIZE, 5);
+	SDL_GL_SetAttribute(SDL_GL_GREEN_SIZE, 5);
+	SDL_GL_SetAttribute(SDL_GL_BLUE_SIZE, 5);
+	SDL_GL_SetAttribute(SDL_GL_DEPTH_SIZE, 16);
+	SDL_GL_SetAttribute(SDL_GL_DOUBLEBUFFER, 1);
+
+	//small window: the cost of rasterization is not the point here
+	SDL_Window* window = SDL_CreateWindow("SDL_Window", SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED, 64, 64, SDL_WINDOW_OPENGL);
+	if(window == NULL)
+	{
+		std::cerr << "Window could not be created!: " << SDL_GetError() << std::endl;
+	}
+
+	SDL_GLContext context;
+
+	context = SDL_GL_CreateContext(window);
+
+	obj << Begin();
+
+	SDL_GL_MakeCurrent(window, context);
+
+	VShader vshader;
+	FShader fshader;
+
+	ShaderProgram program;
+
+	vshader << vshader_source;
+	fshader << fshader_source;
+
+	program << vshader << fshader << VertexLayout("vertex", "normal", "texcrd") << link_these();
+
+	ModelData data;
+	std::string path = (argc > 1) ? argv[1] : "Porsche_911_GT2.obj";
+	if(!loadModel(path, data))
+	{
+		std::cerr << path << " cannot be loaded. use a sphere instead." << std::endl;
+		MeshSample::Sphere spherehelper(1.0, 300, 300);
+		data.vertex.assign(spherehelper.getVertex(), spherehelper.getVertex()+spherehelper.getNumVertex()*3);
+		data.normal.assign(spherehelper.getNormal(), spherehelper.getNormal()+spherehelper.getNumVertex()*3);
+		data.texcrd.assign(spherehelper.getTexcrd(), spherehelper.getTexcrd()+spherehelper.getNumVertex()*2);
+		data.index.assign(spherehelper.getIndex(), spherehelper.getIndex()+spherehelper.getNumIndex());
+	}
+	std::size_t num_vertex = data.vertex.size()/3;
+	std::size_t num_draw_vertex = data.index.empty() ? num_vertex : data.index.size();
+
+	Mesh3D separate;
+	separate.copyData(data.vertex.data(), data.normal.data(), data.texcrd.data(), num_vertex);
+
+	Mesh3D interleaved;
+	interleaved.setInterleaved(true);
+	interleaved.copyData(data.vertex.data(), data.normal.data(), data.texcrd.data(), num_vertex);
+
+	if(!data.index.empty())
+	{
+		separate.copyIndex(data.index.data(), data.index.size());
+		interleaved.copyIndex(data.index.data(), data.index.size());
+	}
+
+	Camera camera;
+	camera.setPos(glm::vec3(0.0f, 0.0f, 5.0f));
+	camera.setDrct(glm::vec3(0.0f, 0.0f, 0.0f));
+	camera.setUp(glm::vec3(0.0f, 1.0f, 0.0f));
+	camera.setAspect(64, 64);
+
+	program.setUniformMatrixXtv("view", glm::value_ptr(camera.getViewMatrix()), 1, 4);
+	program.setUniformMatrixXtv("projection", glm::value_ptr(camera.getProjectionMatrix()), 1, 4);
+	glm::mat4 model_mat = separate.getModelMatrix();
+	program.setUniformMatrixXtv("model", glm::value_ptr(model_mat), 1, 4);
+
+	glEnable(GL_DEPTH_TEST);
+
+	double separate_ms = measure([&](){
+			obj.draw(separate, program);
+			});
+	double interleaved_ms = measure([&](){
+			obj.draw(interleaved, program);
+			});
+
+	std::cout << num_vertex << " vertices, " << num_draw_vertex << " vertices per draw" << std::endl;
+	std::cout << "              ms/draw   Mvertex/s" << std::endl;
+	std::cout << "separate    : " << separate_ms << "  " << num_draw_vertex/separate_ms/1000.0 << std::endl;
+	std::cout << "interleaved : " << interleaved_ms << "  " << num_draw_vertex/interleaved_ms/1000.0 << std::endl;
+
+	SDL_GL_DeleteContext(context);
+	SDL_DestroyWindow(window);
+	SDL_Quit();
+	return 0;
+}
@@ -64,7 +64,7 @@ int main(int argc, char* argv[])
 	vshader << vshader_source;
 	fshader << fshader_source;
 
-	program << vshader << fshader << link_these();
+	program << vshader << fshader << VertexLayout("vertex", "normal", "texcrd") << link_these();
 
 	Texture<Texture2D> texture;
 	texture.texImage2D("texture.jpg");
@@ -112,6 +112,7 @@ int main(int argc, char* argv[])
 	Mesh3D cube_mesh;
 	MeshSample::Sphere cubehelper(5.0, 50, 50);
 	cube_mesh.copyData(cubehelper.getVertex(), cubehelper.getNormal(), cubehelper.getTexcrd(), cubehelper.getNumVertex());
+	cube_mesh.copyIndex(cubehelper.getIndex(), cubehelper.getNumIndex());
 	cube_mesh.setPos(glm::vec3(0.0f, 0.0f, 5.0f));
 
 	Camera camera;
@@ -124,6 +125,7 @@ int main(int argc, char* argv[])
 
 	program.setUniformMatrixXtv("view", glm::value_ptr(camera.getViewMatrix()), 1, 4);
 	program.setUniformMatrixXtv("projection", glm::value_ptr(camera.getProjectionMatrix()), 1, 4);
+	const Frustum frustum = camera.getFrustum();
 
 	program.setUniformXt("light.ambient", 0.75f, 0.75f, 0.75f, 1.0f);
 	program.setUniformXt("light.diffuse", 1.0f, 1.0f, 1.0f, 1.0f);
@@ -161,14 +163,12 @@ int main(int argc, char* argv[])
 		glEnable(GL_CULL_FACE);
 		glEnable(GL_DEPTH_TEST);
 		glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
-		obj.connectAttrib(program, floor_mesh, "vertex", "normal", "texcrd");
 		program.setUniformMatrixXtv("model", glm::value_ptr(floor_mesh.getModelMatrix()), 1, 4);
 		texture.bind(0);
 		obj.draw(floor_mesh, program);
-		obj.connectAttrib(program, cube_mesh, "vertex", "normal", "texcrd");
 		program.setUniformMatrixXtv("model", glm::value_ptr(cube_mesh.getModelMatrix()), 1, 4);
 		texture.bind(0);
-		obj.draw(cube_mesh, program);
+		obj.draw(cube_mesh, program, frustum);
 		SDL_GL_SwapWindow( window );
 	}
 
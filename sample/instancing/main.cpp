@@ -0,0 +1,185 @@
+#include "../include/gl_all.h"
+#include <vector>
+#include <chrono>
+#include <cmath>
+#include <SDL2/SDL.h>
+#include <IL/ilu.h>
+#include <SDL2/SDL_opengl.h>
+
+jikoLib::GLLib::GLObject obj;
+
+const std::string vshader_source =
+#include "shader.vert"
+;
+const std::string single_vshader_source =
+#include "single.vert"
+;
+const std::string fshader_source =
+#include "shader.frag"
+;
+
+//GRID x GRID spheres in one glDrawElementsInstanced call
+//(compared with one uniform upload and one draw call per sphere)
+
+const int GRID = 64;
+const int MEASURE_FRAME = 20;
+
+template<typename Func>
+double measure(Func func)
+{
+	func();
+	glFinish();
+	auto start = std::chrono::steady_clock::now();
+	for(int i = 0; i < MEASURE_FRAME; i++)
+	{
+		func();
+	}
+	glFinish();
+	auto end = std::chrono::steady_clock::now();
+	return std::chrono::duration<double, std::milli>(end-start).count()/MEASURE_FRAME;
+}
+
+int main(int argc, char* argv[])
+{
+	using namespace jikoLib::GLLib;
+
+
+	if(SDL_Init(SDL_INIT_EVERYTHING) < 0)
+	{
+		std::cerr << "Cannot Initialize SDL!: " << SDL_GetError() << std::endl;
+		return -1;
+	}
+
+	SDL_GL_SetAttribute(SDL_GL_RED_SIZE, 5);
+	SDL_GL_SetAttribute(SDL_GL_GREEN_SIZE, 5);
+	SDL_GL_SetAttribute(SDL_GL_BLUE_SIZE, 5);
+	SDL_GL_SetAttribute(SDL_GL_DEPTH_SIZE, 16);
+	SDL_GL_SetAttribute(SDL_GL_DOUBLEBUFFER, 1);
+
+	SDL_Window* window = SDL_CreateWindow("SDL_Window", SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED, 1200, 800, SDL_WINDOW_OPENGL);
+	if(window == NULL)
+	{
+		std::cerr << "Window could not be created!: " << SDL_GetError() << std::endl;
+	}
+
+	SDL_GLContext context;
+
+	context = SDL_GL_CreateContext(window);
+
+	obj << Begin();
+
+	SDL_GL_SetSwapInterval(1);
+
+	SDL_GL_MakeCurrent(window, context);
+
+	VShader vshader;
+	VShader single_vshader;
+	FShader fshader;
+
+	ShaderProgram program;
+	ShaderProgram single_program;
+
+	vshader << vshader_source;
+	single_vshader << single_vshader_source;
+	fshader << fshader_source;
+
+	//instance_model takes INSTANCE..INSTANCE+3
+	program << vshader << fshader << VertexLayout("vertex", "normal", "texcrd").instance("instance_model").instance("instance_color", 4) << link_these();
+	single_program << single_vshader << fshader << VertexLayout("vertex", "normal", "texcrd") << link_these();
+
+	Mesh3D sphere_mesh;
+	MeshSample::Sphere spherehelper(0.4, 16, 16);
+	sphere_mesh.copyData(spherehelper.getVertex(), spherehelper.getNormal(), spherehelper.getTexcrd(), spherehelper.getNumVertex());
+	sphere_mesh.copyIndex(spherehelper.getIndex(), spherehelper.getNumIndex());
+
+	//per-instance data
+	std::vector<glm::mat4> models;
+	std::vector<glm::vec4> colors;
+	for(int y = 0; y < GRID; y++)
+	{
+		for(int x = 0; x < GRID; x++)
+		{
+			models.push_back(glm::translate(glm::mat4(1.0f), glm::vec3(x-GRID/2.0f, y-GRID/2.0f, 0.0f)));
+			colors.push_back(glm::vec4((GLfloat)(x)/GRID, (GLfloat)(y)/GRID, 1.0f-(GLfloat)(x)/GRID, 1.0f));
+		}
+	}
+
+	VBO instance_model;
+	instance_model.copyData(glm::value_ptr(models[0]), models.size(), 16);
+	VBO instance_color;
+	instance_color.copyData(glm::value_ptr(colors[0]), colors.size(), 4);
+
+	//set once. the instance attributes are stored in the vertex array of the mesh
+	sphere_mesh.setInstanceBuffer(instance_model, AttribLocation::INSTANCE);
+	sphere_mesh.setInstanceBuffer(instance_color, AttribLocation::INSTANCE+4);
+
+	Camera camera;
+	camera.setPos(glm::vec3(0.0f, -20.0f, 60.0f));
+	camera.setDrct(glm::vec3(0.0f, 0.0f, 0.0f));
+	camera.setUp(glm::vec3(0.0f, 1.0f, 0.0f));
+	camera.setAspect(1200, 800);
+	camera.setFar(1000.0f);
+
+	program.setUniformMatrixXtv("view", glm::value_ptr(camera.getViewMatrix()), 1, 4);
+	program.setUniformMatrixXtv("projection", glm::value_ptr(camera.getProjectionMatrix()), 1, 4);
+	single_program.setUniformMatrixXtv("view", glm::value_ptr(camera.getViewMatrix()), 1, 4);
+	single_program.setUniformMatrixXtv("projection", glm::value_ptr(camera.getProjectionMatrix()), 1, 4);
+
+	glEnable(GL_DEPTH_TEST);
+	glEnable(GL_CULL_FACE);
+	glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+
+	double single_ms = measure([&](){
+			glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+			for(std::size_t i = 0; i < models.size(); i++)
+			{
+				single_program.setUniformMatrixXtv("model", glm::value_ptr(models[i]), 1, 4);
+				single_program.setUniformXt("color", colors[i].x, colors[i].y, colors[i].z, colors[i].w);
+				obj.draw(sphere_mesh, single_program);
+			}
+			});
+	double instanced_ms = measure([&](){
+			glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+			obj.drawInstanced(sphere_mesh, program);
+			});
+
+	std::cout << models.size() << " spheres" << std::endl;
+	std::cout << "                  ms/frame" << std::endl;
+	std::cout << "draw per sphere : " << single_ms << std::endl;
+	std::cout << "drawInstanced   : " << instanced_ms << std::endl;
+
+	bool quit = false;
+	SDL_Event e;
+
+	std::size_t frame = 0;
+
+	while( !quit )
+	{
+		//Handle events on queue
+		while( SDL_PollEvent( &e ) != 0 )
+		{
+			//User requests quit
+			if( e.type == SDL_QUIT )
+			{
+				quit = true;
+			}
+		}
+		CHECK_GL_ERROR;
+
+		GLfloat angle = 0.01f*frame;
+		camera.setPos(glm::vec3(60.0f*std::sin(angle), -20.0f, 60.0f*std::cos(angle)));
+		program.setUniformMatrixXtv("view", glm::value_ptr(camera.getViewMatrix()), 1, 4);
+
+		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+		obj.drawInstanced(sphere_mesh, program);
+
+		SDL_GL_SwapWindow( window );
+		frame++;
+	}
+
+	SDL_GL_DeleteContext(context);
+	SDL_DestroyWindow(window);
+	SDL_Quit();
+	return 0;
+}
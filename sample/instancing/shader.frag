@@ -0,0 +1,12 @@
+R"(
+#version 120
+varying vec3 Normal;
+varying vec4 Color;
+
+void main()
+{
+	//light from the camera
+	float diffuse = max(dot(normalize(Normal), vec3(0.0, 0.0, 1.0)), 0.0);
+	gl_FragColor = vec4(Color.rgb*(0.2+0.8*diffuse), Color.a);
+}
+)"
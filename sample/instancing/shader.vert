@@ -0,0 +1,24 @@
+R"(
+#version 120
+
+attribute vec3 vertex;
+attribute vec3 normal;
+attribute vec2 texcrd;
+
+//per-instance
+attribute mat4 instance_model;
+attribute vec4 instance_color;
+
+uniform mat4 view;
+uniform mat4 projection;
+
+varying vec3 Normal;
+varying vec4 Color;
+
+void main()
+{
+	Normal = mat3(view*instance_model)*normal;
+	Color = instance_color;
+	gl_Position = projection*view*instance_model*vec4(vertex, 1.0);
+}
+)"
@@ -0,0 +1,22 @@
+R"(
+#version 120
+
+attribute vec3 vertex;
+attribute vec3 normal;
+attribute vec2 texcrd;
+
+uniform mat4 model;
+uniform vec4 color;
+uniform mat4 view;
+uniform mat4 projection;
+
+varying vec3 Normal;
+varying vec4 Color;
+
+void main()
+{
+	Normal = mat3(view*model)*normal;
+	Color = color;
+	gl_Position = projection*view*model*vec4(vertex, 1.0);
+}
+)"
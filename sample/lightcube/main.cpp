@@ -64,11 +64,12 @@ int main(int argc, char* argv[])
 	vshader << vshader_source;
 	fshader << fshader_source;
 
-	program << vshader << fshader << link_these();
+	program << vshader << fshader << VertexLayout("vertex", "norm") << link_these();
 
 	Mesh3D cube;
 	MeshSample::Cube cubeHelper(1.0);
 	cube.copyData(cubeHelper.getVertex(), cubeHelper.getNormal(), cubeHelper.getNumVertex());
+	cube.copyIndex(cubeHelper.getIndex(), cubeHelper.getNumIndex());
 
 	Camera camera;
 	camera.setPos(glm::vec3(3.0f, 3.0f, 3.0f));
@@ -79,9 +80,6 @@ int main(int argc, char* argv[])
 	SDL_GetWindowSize(window, &width, &height);
 	camera.setAspect(width, height);
 
-	obj.connectAttrib(program, cube.getNormal(), cube.getVArray(), "norm");
-	obj.connectAttrib(program, cube.getVertex(), cube.getVArray(), "vertex");
-
 	program.setUniformMatrixXtv("model", glm::value_ptr(cube.getModelMatrix()), 1, 4);
 	program.setUniformMatrixXtv("view", glm::value_ptr(camera.getViewMatrix()), 1, 4);
 	program.setUniformMatrixXtv("projection", glm::value_ptr(camera.getProjectionMatrix()), 1, 4);
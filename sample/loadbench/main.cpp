@@ -0,0 +1,111 @@
+#include "../include/gl_all.h"
+#include <vector>
+#include <chrono>
+#include <SDL2/SDL.h>
+#include <IL/ilu.h>
+#include <SDL2/SDL_opengl.h>
+
+jikoLib::GLLib::GLObject obj;
+
+//model load time: ReadFile with GenSmoothNormals + walking the meshes on one thread (before)
+//vs ReadFile without GenSmoothNormals + AssimpLoader::convert on 1..N threads (after)
+//usage: prog [model file] (default: Porsche_911_GT2.obj)
+
+using Clock = std::chrono::steady_clock;
+
+inline double elapsed(Clock::time_point start)
+{
+	return std::chrono::duration<double, std::milli>(Clock::now()-start).count();
+}
+
+int main(int argc, char* argv[])
+{
+	using namespace jikoLib::GLLib;
+
+
+	if(SDL_Init(SDL_INIT_EVERYTHING) < 0)
+	{
+		std::cerr << "Cannot Initialize SDL!: " << SDL_GetError() << std::endl;
+		return -1;
+	}
+
+	SDL_GL_SetAttribute(SDL_GL_RED_SIZE, 5);
+	SDL_GL_SetAttribute(SDL_GL_GREEN_SIZE, 5);
+	SDL_GL_SetAttribute(SDL_GL_BLUE_SIZE, 5);
+	SDL_GL_SetAttribute(SDL_GL_DEPTH_SIZE, 16);
+	SDL_GL_SetAttribute(SDL_GL_DOUBLEBUFFER, 1);
+
+	SDL_Window* window = SDL_CreateWindow("SDL_Window", SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED, 64, 64, SDL_WINDOW_OPENGL);
+	if(window == NULL)
+	{
+		std::cerr << "Window could not be created!: " << SDL_GetError() << std::endl;
+	}
+
+	SDL_GLContext context;
+
+	context = SDL_GL_CreateContext(window);
+
+	obj << Begin();
+
+	SDL_GL_MakeCurrent(window, context);
+
+	std::string path = (argc > 1) ? argv[1] : "Porsche_911_GT2.obj";
+
+	//before
+	auto start = Clock::now();
+	std::size_t before_vertices = 0;
+	{
+		AssimpLoader loader(path);
+		const aiScene *scene = loader.getScene();
+		if(scene == nullptr)
+		{
+			std::cerr << path << " cannot be loaded." << std::endl;
+			SDL_GL_DeleteContext(context);
+			SDL_DestroyWindow(window);
+			SDL_Quit();
+			return -1;
+		}
+		std::vector<MeshData> data(scene->mNumMeshes);
+		for(unsigned int m = 0; m < scene->mNumMeshes; m++)
+		{
+			data[m] = AssimpLoader::convertMesh(scene->mMeshes[m]);
+			before_vertices += data[m].vertices.size();
+		}
+	}
+	double before_ms = elapsed(start);
+
+	std::cout << path << std::endl;
+	std::cout << "                       read ms   convert ms   upload ms   total ms" << std::endl;
+	std::cout << "before (1 thread)    : " << before_ms << " (" << before_vertices << " vertices)" << std::endl;
+
+	//after
+	std::size_t max_threads = std::thread::hardware_concurrency();
+	if(max_threads == 0)
+		max_threads = 1;
+	for(std::size_t threads = 1; threads <= max_threads; threads *= 2)
+	{
+		ThreadPool pool(threads);
+
+		start = Clock::now();
+		AssimpLoader loader(path, AssimpLoader::CONVERT_FLAGS);
+		double read_ms = elapsed(start);
+
+		start = Clock::now();
+		std::vector<MeshData> data = loader.convert(pool);
+		double convert_ms = elapsed(start);
+
+		//only this part needs the context
+		start = Clock::now();
+		std::vector<Mesh3D> meshes = AssimpLoader::upload(data);
+		glFinish();
+		double upload_ms = elapsed(start);
+
+		std::cout << "after (" << threads << " threads)" << ((threads < 10) ? " " : "") << "  : "
+			<< read_ms << "  " << convert_ms << "  " << upload_ms << "  " << read_ms+convert_ms+upload_ms << std::endl;
+	}
+
+	SDL_GL_DeleteContext(context);
+	SDL_DestroyWindow(window);
+	SDL_Quit();
+	return 0;
+}
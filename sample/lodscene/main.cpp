@@ -0,0 +1,267 @@
+#include "../include/gl_all.h"
+#include <vector>
+#include <chrono>
+#include <SDL2/SDL.h>
+#include <IL/ilu.h>
+#include <SDL2/SDL_opengl.h>
+
+jikoLib::GLLib::GLObject obj;
+
+const std::string vshader_source =
+#include "shader.vert"
+;
+const std::string fshader_source =
+#include "shader.frag"
+;
+
+//LOD chains (quadric error simplification) of the 50x50 sphere and the Porsche,
+//and a field of them seen from 3 cameras: the triangles drawn at full detail vs
+//the level selected by the projected size of the bounding sphere (error under 1 pixel).
+//usage: prog [model file] (default: Porsche_911_GT2.obj)
+
+const int WIDTH = 1280;
+const int HEIGHT = 720;
+const int GRID = 20;
+const float SPACING = 10.0f;
+const float CAR_LENGTH = 4.5f;
+const float PIXEL_ERROR = 1.0f;
+const int REPEAT = 3;
+
+using Clock = std::chrono::steady_clock;
+
+template<typename Func>
+double bestOf(int repeat, Func func)
+{
+	double best = 0.0;
+	for(int i = 0; i < repeat; i++)
+	{
+		glFinish();
+		auto start = Clock::now();
+		func();
+		glFinish();
+		double ms = std::chrono::duration<double, std::milli>(Clock::now()-start).count();
+		if(i == 0 || ms < best)
+			best = ms;
+	}
+	return best;
+}
+
+//one LOD chain per sub mesh
+struct Model
+{
+	std::string name;
+	std::vector<jikoLib::GLLib::Mesh3D> meshes;
+	glm::mat4 matrix; //model space to the scene (scale of the model file)
+};
+
+struct Instance
+{
+	std::size_t model;
+	glm::mat4 matrix;
+};
+
+//the triangles of every level (a sub mesh with less levels stays at its last one)
+void printChain(const Model &model, double ms)
+{
+	std::size_t levels = 0;
+	for(auto&& mesh : model.meshes)
+		levels = std::max(levels, mesh.getNumLod());
+	std::cout << model.name << ": " << model.meshes.size() << " meshes, LOD chain in " << ms << " ms" << std::endl;
+	for(std::size_t l = 0; l < levels; l++)
+	{
+		std::size_t triangles = 0;
+		float error = 0.0f;
+		for(auto&& mesh : model.meshes)
+		{
+			if(mesh.getNumLod() == 0)
+				continue;
+			const jikoLib::GLLib::LodLevel &level = mesh.getLodLevels()[std::min(l, mesh.getNumLod()-1)];
+			triangles += level.count/3;
+			error = std::max(error, level.error);
+		}
+		std::cout << "  level " << l << ": " << triangles << " triangles  (max error " << error*100.0f << "% of the mesh radius)" << std::endl;
+	}
+}
+
+template<typename Program>
+std::size_t drawScene(std::vector<Model> &models, const std::vector<Instance> &instances, jikoLib::GLLib::Camera &camera, Program &program, bool lod)
+{
+	using namespace jikoLib::GLLib;
+	const Frustum frustum = camera.getFrustum();
+	program.setUniformMatrixXtv("view", glm::value_ptr(camera.getViewMatrix()), 1, 4);
+	program.setUniformMatrixXtv("projection", glm::value_ptr(camera.getProjectionMatrix()), 1, 4);
+	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+	std::size_t triangles = 0;
+	for(auto&& instance : instances)
+	{
+		Model &model = models[instance.model];
+		const glm::mat4 matrix = instance.matrix*model.matrix;
+		bool uniform_set = false;
+		for(auto&& mesh : model.meshes)
+		{
+			if(!mesh.getIsIndexSet())
+				continue;
+			const BoundingSphere sphere = mesh.getBoundingSphere().transformed(matrix);
+			if(!frustum.isVisible(sphere))
+				continue;
+			if(lod)
+				mesh.selectLod(camera.getScreenSize(sphere), HEIGHT, PIXEL_ERROR);
+			else
+				mesh.setLod(0);
+			if(!uniform_set)
+			{
+				program.setUniformMatrixXtv("model", glm::value_ptr(matrix), 1, 4);
+				uniform_set = true;
+			}
+			obj.draw(mesh, program);
+			triangles += mesh.getIndexCount()/3;
+		}
+	}
+	return triangles;
+}
+
+int main(int argc, char* argv[])
+{
+	using namespace jikoLib::GLLib;
+
+
+	if(SDL_Init(SDL_INIT_EVERYTHING) < 0)
+	{
+		std::cerr << "Cannot Initialize SDL!: " << SDL_GetError() << std::endl;
+		return -1;
+	}
+
+	SDL_GL_SetAttribute(SDL_GL_RED_SIZE, 5);
+	SDL_GL_SetAttribute(SDL_GL_GREEN_SIZE, 5);
+	SDL_GL_SetAttribute(SDL_GL_BLUE_SIZE, 5);
+	SDL_GL_SetAttribute(SDL_GL_DEPTH_SIZE, 16);
+	SDL_GL_SetAttribute(SDL_GL_DOUBLEBUFFER, 1);
+
+	SDL_Window* window = SDL_CreateWindow("SDL_Window", SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED, WIDTH, HEIGHT, SDL_WINDOW_OPENGL);
+	if(window == NULL)
+	{
+		std::cerr << "Window could not be created!: " << SDL_GetError() << std::endl;
+	}
+
+	SDL_GLContext context;
+
+	context = SDL_GL_CreateContext(window);
+
+	obj << Begin();
+
+	SDL_GL_MakeCurrent(window, context);
+
+	VShader vshader;
+	FShader fshader;
+
+	ShaderProgram program;
+
+	vshader << vshader_source;
+	fshader << fshader_source;
+
+	program << vshader << fshader << VertexLayout("vertex", "normal", "texcrd") << link_these();
+
+	std::vector<Model> models(2);
+
+	//sphere (as in cubemapandskymap)
+	{
+		Model &model = models[0];
+		model.name = "sphere 50x50";
+		model.matrix = glm::mat4(1.0f);
+		MeshSample::Sphere sphere(1.0f, 50, 50);
+		auto start = Clock::now();
+		const LodChain chain = buildLodChain(sphere.getVertex(), sphere.getNumVertex(), 3, sphere.getIndex(), sphere.getNumIndex());
+		const double ms = std::chrono::duration<double, std::milli>(Clock::now()-start).count();
+		model.meshes.resize(1);
+		model.meshes[0].copyData(sphere.getVertex(), sphere.getNormal(), sphere.getTexcrd(), sphere.getNumVertex());
+		model.meshes[0].copyLodChain(chain);
+		printChain(model, ms);
+	}
+
+	//car: the chains of the sub meshes are built on the pool at load time
+	const std::string path = (argc > 1) ? argv[1] : "Porsche_911_GT2.obj";
+	{
+		Model &model = models[1];
+		model.name = path;
+		ObjLoader loader;
+		if(loader.load(path))
+		{
+			auto start = Clock::now();
+			const std::vector<LodChain> chains = buildLodChains(loader.getMeshes());
+			const double ms = std::chrono::duration<double, std::milli>(Clock::now()-start).count();
+			model.meshes = uploadMeshData(loader.getMeshes(), chains);
+
+			glm::vec3 bound_min(0.0f), bound_max(0.0f);
+			for(std::size_t i = 0; i < loader.getMeshes().size(); i++)
+			{
+				const MeshData &data = loader.getMeshes()[i];
+				bound_min = (i == 0) ? data.bound_min : glm::min(bound_min, data.bound_min);
+				bound_max = (i == 0) ? data.bound_max : glm::max(bound_max, data.bound_max);
+			}
+			const glm::vec3 size = bound_max-bound_min;
+			const float scale = CAR_LENGTH/std::max(std::max(size.x, size.y), std::max(size.z, 1e-6f));
+			model.matrix = glm::scale(glm::mat4(1.0f), glm::vec3(scale))*glm::translate(glm::mat4(1.0f), -(bound_min+bound_max)*0.5f);
+			printChain(model, ms);
+		}
+		else
+		{
+			std::cout << path << ": cannot be loaded (spheres only)" << std::endl;
+		}
+	}
+
+	//GRID x GRID objects on the ground, spheres and cars in turn
+	std::vector<Instance> instances;
+	for(int i = 0; i < GRID; i++)
+	{
+		for(int j = 0; j < GRID; j++)
+		{
+			const std::size_t model = (models[1].meshes.empty() || (i+j)%2 == 0) ? 0 : 1;
+			const glm::vec3 pos((i-GRID/2)*SPACING, 1.0f, (j-GRID/2)*SPACING);
+			instances.push_back(Instance{model, glm::translate(glm::mat4(1.0f), pos)});
+		}
+	}
+
+	glEnable(GL_DEPTH_TEST);
+	glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+
+	Camera camera;
+	camera.setUp(glm::vec3(0.0f, 1.0f, 0.0f));
+	camera.setFovy(M_PI/4.0);
+	camera.setAspect(WIDTH, HEIGHT);
+	camera.setNear(0.5f);
+	camera.setFar(5000.0f);
+
+	const float half = GRID*SPACING*0.5f;
+	struct View
+	{
+		std::string label;
+		glm::vec3 pos;
+		glm::vec3 target;
+	};
+	const std::vector<View> views = {
+		{"street level", glm::vec3(-half-5.0f, 2.0f, 0.0f), glm::vec3(half, 0.0f, 0.0f)},
+		{"above       ", glm::vec3(0.0f, half, -half*2.0f), glm::vec3(0.0f, 0.0f, 0.0f)},
+		{"far away    ", glm::vec3(0.0f, half*2.0f, -half*10.0f), glm::vec3(0.0f, 0.0f, 0.0f)}
+	};
+
+	std::cout << instances.size() << " objects, " << WIDTH << "x" << HEIGHT << ", LOD error under " << PIXEL_ERROR << " pixel" << std::endl;
+	bool ok = true;
+	for(auto&& view : views)
+	{
+		camera.setPos(view.pos);
+		camera.setDrct(view.target);
+		std::size_t full = 0, lod = 0;
+		const double full_ms = bestOf(REPEAT, [&](){ full = drawScene(models, instances, camera, program, false); });
+		const double lod_ms = bestOf(REPEAT, [&](){ lod = drawScene(models, instances, camera, program, true); });
+		std::cout << "  " << view.label << ": " << full << " -> " << lod << " triangles ("
+			<< ((full == 0) ? 0.0 : 100.0*(full-lod)/full) << "% saved)  frame " << full_ms << " ms -> " << lod_ms << " ms" << std::endl;
+		if(lod > full)
+			ok = false;
+	}
+
+	SDL_GL_DeleteContext(context);
+	SDL_DestroyWindow(window);
+	SDL_Quit();
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,11 @@
+R"(
+#version 120
+varying vec3 Normal;
+
+void main()
+{
+	//headlight
+	float diffuse = abs(normalize(Normal).z);
+	gl_FragColor = vec4(vec3(0.2+0.8*diffuse), 1.0);
+}
+)"
@@ -0,0 +1,18 @@
+R"(
+#version 120
+
+attribute vec3 normal;
+attribute vec3 vertex;
+
+uniform mat4 model;
+uniform mat4 view;
+uniform mat4 projection;
+
+varying vec3 Normal;
+
+void main()
+{
+	Normal = mat3(view*model)*normal;
+	gl_Position = projection*view*model*vec4(vertex, 1.0);
+}
+)"
@@ -0,0 +1,206 @@
+#include "../include/gl_all.h"
+#include <vector>
+#include <chrono>
+#include <cmath>
+#include <SDL2/SDL.h>
+#include <IL/ilu.h>
+#include <SDL2/SDL_opengl.h>
+
+jikoLib::GLLib::GLObject obj;
+
+const std::string vshader_source =
+#include "shader.vert"
+;
+const std::string single_vshader_source =
+#include "single.vert"
+;
+const std::string fshader_source =
+#include "shader.frag"
+;
+
+//GRID x GRID objects of 3 kinds of meshes
+//Mesh3D (a vertex array and a draw call per object) vs MeshPool (one glMultiDrawElementsIndirect)
+
+const int GRID = 40;
+const int MEASURE_FRAME = 20;
+
+template<typename Func>
+double measure(Func func)
+{
+	func();
+	glFinish();
+	auto start = std::chrono::steady_clock::now();
+	for(int i = 0; i < MEASURE_FRAME; i++)
+	{
+		func();
+	}
+	glFinish();
+	auto end = std::chrono::steady_clock::now();
+	return std::chrono::duration<double, std::milli>(end-start).count()/MEASURE_FRAME;
+}
+
+int main(int argc, char* argv[])
+{
+	using namespace jikoLib::GLLib;
+
+
+	if(SDL_Init(SDL_INIT_EVERYTHING) < 0)
+	{
+		std::cerr << "Cannot Initialize SDL!: " << SDL_GetError() << std::endl;
+		return -1;
+	}
+
+	SDL_GL_SetAttribute(SDL_GL_RED_SIZE, 5);
+	SDL_GL_SetAttribute(SDL_GL_GREEN_SIZE, 5);
+	SDL_GL_SetAttribute(SDL_GL_BLUE_SIZE, 5);
+	SDL_GL_SetAttribute(SDL_GL_DEPTH_SIZE, 16);
+	SDL_GL_SetAttribute(SDL_GL_DOUBLEBUFFER, 1);
+
+	SDL_Window* window = SDL_CreateWindow("SDL_Window", SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED, 1200, 800, SDL_WINDOW_OPENGL);
+	if(window == NULL)
+	{
+		std::cerr << "Window could not be created!: " << SDL_GetError() << std::endl;
+	}
+
+	SDL_GLContext context;
+
+	context = SDL_GL_CreateContext(window);
+
+	obj << Begin();
+
+	SDL_GL_SetSwapInterval(1);
+
+	SDL_GL_MakeCurrent(window, context);
+
+	VShader vshader;
+	VShader single_vshader;
+	FShader fshader;
+
+	ShaderProgram program;
+	ShaderProgram single_program;
+
+	vshader << vshader_source;
+	single_vshader << single_vshader_source;
+	fshader << fshader_source;
+
+	program << vshader << fshader << VertexLayout("vertex", "normal", "texcrd").instance("instance_model") << link_these();
+	single_program << single_vshader << fshader << VertexLayout("vertex", "normal", "texcrd") << link_these();
+
+	MeshSample::Sphere spherehelper(0.4, 16, 16);
+	MeshSample::Cube cubehelper(0.6);
+	MeshSample::Sphere smallhelper(0.25, 8, 8);
+
+	//before: one Mesh3D per kind
+	std::vector<Mesh3D> meshes(3);
+	meshes[0].copyData(spherehelper.getVertex(), spherehelper.getNormal(), spherehelper.getTexcrd(), spherehelper.getNumVertex());
+	meshes[0].copyIndex(spherehelper.getIndex(), spherehelper.getNumIndex());
+	meshes[1].copyData(cubehelper.getVertex(), cubehelper.getNormal(), cubehelper.getTexcrd(), cubehelper.getNumVertex());
+	meshes[1].copyIndex(cubehelper.getIndex(), cubehelper.getNumIndex());
+	meshes[2].copyData(smallhelper.getVertex(), smallhelper.getNormal(), smallhelper.getTexcrd(), smallhelper.getNumVertex());
+	meshes[2].copyIndex(smallhelper.getIndex(), smallhelper.getNumIndex());
+
+	//after: all kinds in one pool
+	MeshPool pool;
+	pool.add(spherehelper.getVertex(), spherehelper.getNormal(), spherehelper.getTexcrd(), spherehelper.getNumVertex(), spherehelper.getIndex(), spherehelper.getNumIndex());
+	pool.add(cubehelper.getVertex(), cubehelper.getNormal(), cubehelper.getTexcrd(), cubehelper.getNumVertex(), cubehelper.getIndex(), cubehelper.getNumIndex());
+	pool.add(smallhelper.getVertex(), smallhelper.getNormal(), smallhelper.getTexcrd(), smallhelper.getNumVertex(), smallhelper.getIndex(), smallhelper.getNumIndex());
+	pool.upload();
+
+	std::vector<std::size_t> kinds;
+	std::vector<glm::mat4> models;
+	for(int y = 0; y < GRID; y++)
+	{
+		for(int x = 0; x < GRID; x++)
+		{
+			kinds.push_back((x+y)%3);
+			models.push_back(glm::translate(glm::mat4(1.0f), glm::vec3(x-GRID/2.0f, y-GRID/2.0f, 0.0f)));
+		}
+	}
+
+	for(std::size_t i = 0; i < models.size(); i++)
+	{
+		pool.addDraw(kinds[i], models[i]);
+	}
+	pool.submit();
+
+	Camera camera;
+	camera.setPos(glm::vec3(0.0f, -15.0f, 40.0f));
+	camera.setDrct(glm::vec3(0.0f, 0.0f, 0.0f));
+	camera.setUp(glm::vec3(0.0f, 1.0f, 0.0f));
+	camera.setAspect(1200, 800);
+	camera.setFar(1000.0f);
+
+	program.setUniformMatrixXtv("view", glm::value_ptr(camera.getViewMatrix()), 1, 4);
+	program.setUniformMatrixXtv("projection", glm::value_ptr(camera.getProjectionMatrix()), 1, 4);
+	single_program.setUniformMatrixXtv("view", glm::value_ptr(camera.getViewMatrix()), 1, 4);
+	single_program.setUniformMatrixXtv("projection", glm::value_ptr(camera.getProjectionMatrix()), 1, 4);
+
+	glEnable(GL_DEPTH_TEST);
+	glEnable(GL_CULL_FACE);
+	glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+
+	BindState &state = obj.getBindState();
+
+	state.resetCount();
+	double mesh_ms = measure([&](){
+			glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+			for(std::size_t i = 0; i < models.size(); i++)
+			{
+				single_program.setUniformMatrixXtv("model", glm::value_ptr(models[i]), 1, 4);
+				obj.draw(meshes[kinds[i]], single_program);
+			}
+			});
+	double mesh_binds = static_cast<double>(state.getIssuedCount())/(MEASURE_FRAME+1);
+
+	state.resetCount();
+	double pool_ms = measure([&](){
+			glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+			obj.draw(pool, program);
+			});
+	double pool_binds = static_cast<double>(state.getIssuedCount())/(MEASURE_FRAME+1);
+
+	std::cout << models.size() << " objects, " << pool.getNumMesh() << " meshes" << std::endl;
+	std::cout << "              ms/frame  bind calls/frame" << std::endl;
+	std::cout << "Mesh3D     : " << mesh_ms << "  " << mesh_binds << std::endl;
+	std::cout << "MeshPool   : " << pool_ms << "  " << pool_binds << std::endl;
+
+	bool quit = false;
+	SDL_Event e;
+
+	std::size_t frame = 0;
+
+	while( !quit )
+	{
+		//Handle events on queue
+		while( SDL_PollEvent( &e ) != 0 )
+		{
+			//User requests quit
+			if( e.type == SDL_QUIT )
+			{
+				quit = true;
+			}
+		}
+		CHECK_GL_ERROR;
+
+		//the draw list is rebuilt every frame
+		pool.clearDraws();
+		GLfloat angle = 0.01f*frame;
+		for(std::size_t i = 0; i < models.size(); i++)
+		{
+			pool.addDraw(kinds[i], glm::rotate(models[i], angle, glm::vec3(0.0f, 1.0f, 0.0f)));
+		}
+		pool.submit();
+
+		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+		obj.draw(pool, program);
+
+		SDL_GL_SwapWindow( window );
+		frame++;
+	}
+
+	SDL_GL_DeleteContext(context);
+	SDL_DestroyWindow(window);
+	SDL_Quit();
+	return 0;
+}
@@ -0,0 +1,11 @@
+R"(
+#version 120
+varying vec3 Normal;
+
+void main()
+{
+	vec3 N = normalize(Normal);
+	float diffuse = max(dot(N, vec3(0.0, 0.0, 1.0)), 0.0);
+	gl_FragColor = vec4((0.5*N+0.5)*(0.2+0.8*diffuse), 1.0);
+}
+)"
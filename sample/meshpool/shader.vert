@@ -0,0 +1,21 @@
+R"(
+#version 120
+
+attribute vec3 vertex;
+attribute vec3 normal;
+attribute vec2 texcrd;
+
+//per-draw (baseInstance of the indirect command)
+attribute mat4 instance_model;
+
+uniform mat4 view;
+uniform mat4 projection;
+
+varying vec3 Normal;
+
+void main()
+{
+	Normal = mat3(view*instance_model)*normal;
+	gl_Position = projection*view*instance_model*vec4(vertex, 1.0);
+}
+)"
@@ -0,0 +1,151 @@
+#include "../include/gl_all.h"
+#include <vector>
+#include <chrono>
+#include <sys/stat.h>
+#include <SDL2/SDL.h>
+#include <IL/ilu.h>
+#include <SDL2/SDL_opengl.h>
+
+jikoLib::GLLib::GLObject obj;
+
+//OBJ parse throughput (MB/s of the file): AssimpLoader (ReadFile + convert) vs ObjLoader on 1..N threads
+//usage: prog [obj file] [repeat] (default: Porsche_911_GT2.obj 5)
+
+using Clock = std::chrono::steady_clock;
+
+inline double elapsed(Clock::time_point start)
+{
+	return std::chrono::duration<double, std::milli>(Clock::now()-start).count();
+}
+
+//best of repeat (ms)
+template<typename Func>
+double bestOf(int repeat, Func func)
+{
+	double best = 0.0;
+	for(int i = 0; i < repeat; i++)
+	{
+		auto start = Clock::now();
+		func();
+		double ms = elapsed(start);
+		if(i == 0 || ms < best)
+			best = ms;
+	}
+	return best;
+}
+
+void printResult(const std::string &label, double ms, double megabytes, std::size_t meshes, std::size_t vertices, std::size_t indices)
+{
+	std::cout << label << ms << " ms  " << megabytes/(ms/1000.0) << " MB/s  ("
+		<< meshes << " meshes, " << vertices << " vertices, " << indices << " indices)" << std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+	using namespace jikoLib::GLLib;
+
+
+	if(SDL_Init(SDL_INIT_EVERYTHING) < 0)
+	{
+		std::cerr << "Cannot Initialize SDL!: " << SDL_GetError() << std::endl;
+		return -1;
+	}
+
+	SDL_GL_SetAttribute(SDL_GL_RED_SIZE, 5);
+	SDL_GL_SetAttribute(SDL_GL_GREEN_SIZE, 5);
+	SDL_GL_SetAttribute(SDL_GL_BLUE_SIZE, 5);
+	SDL_GL_SetAttribute(SDL_GL_DEPTH_SIZE, 16);
+	SDL_GL_SetAttribute(SDL_GL_DOUBLEBUFFER, 1);
+
+	SDL_Window* window = SDL_CreateWindow("SDL_Window", SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED, 64, 64, SDL_WINDOW_OPENGL);
+	if(window == NULL)
+	{
+		std::cerr << "Window could not be created!: " << SDL_GetError() << std::endl;
+	}
+
+	SDL_GLContext context;
+
+	context = SDL_GL_CreateContext(window);
+
+	obj << Begin();
+
+	SDL_GL_MakeCurrent(window, context);
+
+	std::string path = (argc > 1) ? argv[1] : "Porsche_911_GT2.obj";
+	int repeat = (argc > 2) ? std::atoi(argv[2]) : 5;
+	if(repeat < 1)
+		repeat = 1;
+
+	struct stat st;
+	if(stat(path.c_str(), &st) != 0)
+	{
+		std::cerr << path << " cannot be found." << std::endl;
+		SDL_GL_DeleteContext(context);
+		SDL_DestroyWindow(window);
+		SDL_Quit();
+		return -1;
+	}
+	const double megabytes = st.st_size/(1024.0*1024.0);
+	std::cout << path << " (" << megabytes << " MB, best of " << repeat << ")" << std::endl;
+
+	//Assimp
+	{
+		std::size_t meshes = 0, vertices = 0, indices = 0;
+		double ms = bestOf(repeat, [&]()
+				{
+				AssimpLoader loader(path, AssimpLoader::CONVERT_FLAGS);
+				std::vector<MeshData> data;
+				if(loader.getScene() != nullptr)
+					data = loader.convert();
+				meshes = data.size();
+				vertices = indices = 0;
+				for(auto&& mesh : data)
+				{
+					vertices += mesh.vertices.size();
+					indices += mesh.indices.size();
+				}
+				});
+		if(meshes == 0)
+			std::cout << "AssimpLoader          : cannot load " << path << std::endl;
+		else
+			printResult("AssimpLoader          : ", ms, megabytes, meshes, vertices, indices);
+	}
+
+	//ObjLoader
+	std::size_t max_threads = std::thread::hardware_concurrency();
+	if(max_threads == 0)
+		max_threads = 1;
+	ObjLoader loader;
+	for(std::size_t threads = 1; threads <= max_threads; threads *= 2)
+	{
+		ThreadPool pool(threads);
+		bool loaded = false;
+		double ms = bestOf(repeat, [&]()
+				{
+				loaded = loader.load(path, pool);
+				});
+		if(!loaded)
+		{
+			std::cout << "ObjLoader             : cannot load " << path << std::endl;
+			break;
+		}
+		std::size_t vertices = 0, indices = 0;
+		for(auto&& mesh : loader.getMeshes())
+		{
+			vertices += mesh.vertices.size();
+			indices += mesh.indices.size();
+		}
+		printResult("ObjLoader (" + std::to_string(threads) + " threads)" + ((threads < 10) ? " " : "") + ": ", ms, megabytes, loader.getMeshes().size(), vertices, indices);
+	}
+
+	//upload (context thread)
+	auto start = Clock::now();
+	std::vector<Mesh3D> meshes = loader.upload();
+	glFinish();
+	std::cout << "upload                : " << elapsed(start) << " ms" << std::endl;
+
+	SDL_GL_DeleteContext(context);
+	SDL_DestroyWindow(window);
+	SDL_Quit();
+	return 0;
+}
@@ -0,0 +1,154 @@
+#include "../include/gl_all.h"
+#include <vector>
+#include <chrono>
+#include <cstdlib>
+#include <SDL2/SDL.h>
+#include <IL/ilu.h>
+#include <SDL2/SDL_opengl.h>
+
+jikoLib::GLLib::GLObject obj;
+
+const std::string vshader_source =
+#include "shader.vert"
+;
+const std::string fshader_source =
+#include "shader.frag"
+;
+
+//startup cost of PROGRAM_NUM programs: compile + link every time (before) vs ProgramCache (cold: compile and store, warm: glProgramBinary)
+//Mesa keeps its own shader cache (~/.cache/mesa_shader_cache): compile + link is much faster from the second run on.
+
+const int PROGRAM_NUM = 32;
+
+using Clock = std::chrono::steady_clock;
+
+inline double elapsed(Clock::time_point start)
+{
+	return std::chrono::duration<double, std::milli>(Clock::now()-start).count();
+}
+
+//a distinct source per program (like the permutations of a material shader)
+std::string variant(const std::string &source, int n)
+{
+	std::size_t line = source.find('\n', source.find("#version"));
+	return source.substr(0, line+1) + "#define VARIANT " + std::to_string(n) + "\n" + source.substr(line+1);
+}
+
+//one frame of a sphere with program
+std::vector<GLubyte> render(jikoLib::GLLib::ShaderProgram &program, jikoLib::GLLib::Mesh3D &sphere)
+{
+	using namespace jikoLib::GLLib;
+	Camera camera;
+	camera.setPos(glm::vec3(0.0f, 0.0f, 3.0f));
+	camera.setDrct(glm::vec3(0.0f, 0.0f, 0.0f));
+	camera.setUp(glm::vec3(0.0f, 1.0f, 0.0f));
+	camera.setAspect(64, 64);
+	program.setUniformMatrixXtv("model", glm::value_ptr(sphere.getModelMatrix()), 1, 4);
+	program.setUniformMatrixXtv("view", glm::value_ptr(camera.getViewMatrix()), 1, 4);
+	program.setUniformMatrixXtv("projection", glm::value_ptr(camera.getProjectionMatrix()), 1, 4);
+	program.setUniformXt("light.ambient", 0.25f, 0.25f, 0.25f, 1.0f);
+	program.setUniformXt("light.diffuse", 1.0f, 1.0f, 1.0f, 1.0f);
+	program.setUniformXt("light.specular", 1.0f, 1.0f, 1.0f, 1.0f);
+	program.setUniformXt("light.position", 0.0f, 2.0f, 2.0f);
+	program.setUniformXt("material.specular", 1.0f, 1.0f, 1.0f, 1.0f);
+	program.setUniformXt("material.shininess", 50.0f);
+	program.setUniformXt("attenuation.constant", 1.0f);
+	program.setUniformXt("attenuation.linear", 0.0f);
+	program.setUniformXt("attenuation.quadratic", 0.0f);
+	glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+	obj.draw(sphere, program);
+	std::vector<GLubyte> pixels(64*64*4);
+	glReadPixels(0, 0, 64, 64, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+	return pixels;
+}
+
+int main(int argc, char* argv[])
+{
+	using namespace jikoLib::GLLib;
+
+
+	if(SDL_Init(SDL_INIT_EVERYTHING) < 0)
+	{
+		std::cerr << "Cannot Initialize SDL!: " << SDL_GetError() << std::endl;
+		return -1;
+	}
+
+	SDL_GL_SetAttribute(SDL_GL_RED_SIZE, 5);
+	SDL_GL_SetAttribute(SDL_GL_GREEN_SIZE, 5);
+	SDL_GL_SetAttribute(SDL_GL_BLUE_SIZE, 5);
+	SDL_GL_SetAttribute(SDL_GL_DEPTH_SIZE, 16);
+	SDL_GL_SetAttribute(SDL_GL_DOUBLEBUFFER, 1);
+
+	SDL_Window* window = SDL_CreateWindow("SDL_Window", SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED, 64, 64, SDL_WINDOW_OPENGL);
+	if(window == NULL)
+	{
+		std::cerr << "Window could not be created!: " << SDL_GetError() << std::endl;
+	}
+
+	SDL_GLContext context;
+
+	context = SDL_GL_CreateContext(window);
+
+	obj << Begin();
+
+	SDL_GL_MakeCurrent(window, context);
+
+	const std::string directory = "progcache_sample";
+	const VertexLayout layout("vertex", "normal", "texcrd");
+
+	ProgramCache cache(directory);
+	if(!cache.isSupported())
+		std::cout << "program binary is not supported by the driver. the cache compiles every time" << std::endl;
+	//start cold
+	for(int i = 0; i < PROGRAM_NUM; i++)
+	{
+		std::remove(cache.path(cache.key({ProgramCache::Source(GL_VERTEX_SHADER, variant(vshader_source, i)), ProgramCache::Source(GL_FRAGMENT_SHADER, variant(fshader_source, i))}, layout)).c_str());
+	}
+
+	//before
+	std::vector<ShaderProgram> compiled(PROGRAM_NUM);
+	auto start = Clock::now();
+	for(int i = 0; i < PROGRAM_NUM; i++)
+	{
+		VShader vshader;
+		FShader fshader;
+		vshader << variant(vshader_source, i);
+		fshader << variant(fshader_source, i);
+		compiled[i] << vshader << fshader << layout << link_these();
+	}
+	glFinish();
+	double before = elapsed(start);
+
+	//after
+	double after[2];
+	std::vector<ShaderProgram> cached(PROGRAM_NUM);
+	for(int pass = 0; pass < 2; pass++)
+	{
+		cached = std::vector<ShaderProgram>(PROGRAM_NUM);
+		start = Clock::now();
+		for(int i = 0; i < PROGRAM_NUM; i++)
+			cache.build(cached[i], variant(vshader_source, i), variant(fshader_source, i), layout);
+		glFinish();
+		after[pass] = elapsed(start);
+	}
+
+	//the cached program draws the same
+	MeshSample::Sphere spherehelper(1.0, 16, 16);
+	Mesh3D sphere;
+	sphere.copyData(spherehelper.getVertex(), spherehelper.getNormal(), spherehelper.getTexcrd(), spherehelper.getNumVertex());
+	sphere.copyIndex(spherehelper.getIndex(), spherehelper.getNumIndex());
+	glEnable(GL_DEPTH_TEST);
+	const bool same = (render(compiled[0], sphere) == render(cached[0], sphere));
+
+	std::cout << PROGRAM_NUM << " programs                ms" << std::endl;
+	std::cout << "compile + link           : " << before << std::endl;
+	std::cout << "ProgramCache (cold)      : " << after[0] << std::endl;
+	std::cout << "ProgramCache (warm)      : " << after[1] << std::endl;
+	std::cout << "hits " << cache.getHits() << ", misses " << cache.getMisses() << ", same image: " << (same ? "yes" : "no") << std::endl;
+
+	SDL_GL_DeleteContext(context);
+	SDL_DestroyWindow(window);
+	SDL_Quit();
+	return 0;
+}
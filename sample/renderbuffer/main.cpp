@@ -71,7 +71,7 @@ int main(int argc, char* argv[])
 	vshader << vshader_source;
 	fshader << fshader_source;
 
-	program << vshader << fshader << link_these();
+	program << vshader << fshader << VertexLayout("vertex", "normal", "texcrd") << link_these();
 
 	VShader simple_vshader;
 	FShader simple_fshader;
@@ -80,7 +80,7 @@ int main(int argc, char* argv[])
 	simple_vshader << simple_vshader_source;
 	simple_fshader << simple_fshader_source;
 
-	simple_program << simple_vshader << simple_fshader << link_these();
+	simple_program << simple_vshader << simple_fshader << VertexLayout("vertex", "normal", "texcrd") << link_these();
 
 	Texture<Texture2D> texture;
 	texture.texImage2D("texture.jpg");
@@ -123,6 +123,7 @@ int main(int argc, char* argv[])
 	Mesh3D sphere_mesh;
 	MeshSample::Sphere spherehelper(5.0, 50, 50);
 	sphere_mesh.copyData(spherehelper.getVertex(), spherehelper.getNormal(), spherehelper.getTexcrd(), spherehelper.getNumVertex());
+	sphere_mesh.copyIndex(spherehelper.getIndex(), spherehelper.getNumIndex());
 	sphere_mesh.setPos(glm::vec3(0.0f, 0.0f, 5.0f));
 
 	Camera camera;
@@ -205,12 +206,10 @@ int main(int argc, char* argv[])
 		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 		glEnable(GL_CULL_FACE);
 		glEnable(GL_DEPTH_TEST);
-		obj.connectAttrib(program, floor_mesh, "vertex", "normal", "texcrd");
 		program.setUniformMatrixXtv("model", glm::value_ptr(floor_mesh.getModelMatrix()), 1, 4);
 		texture.bind(0);
 		obj.draw(floor_mesh, program);
 		texture.unbind();
-		obj.connectAttrib(program, sphere_mesh, "vertex", "normal", "texcrd");
 		program.setUniformMatrixXtv("model", glm::value_ptr(sphere_mesh.getModelMatrix()), 1, 4);
 		texture.bind(0);
 		obj.draw(sphere_mesh, program);
@@ -224,7 +223,6 @@ int main(int argc, char* argv[])
 		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 		glEnable(GL_CULL_FACE);
 		glEnable(GL_DEPTH_TEST);
-		obj.connectAttrib(simple_program, floor_mesh, "vertex", "normal", "texcrd");
 		simple_program.setUniformMatrixXtv("model", glm::value_ptr(floor_mesh.getModelMatrix()), 1, 4);
 		canvas.bind(0);
 		obj.draw(floor_mesh, simple_program);
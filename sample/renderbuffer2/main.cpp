@@ -58,6 +58,8 @@ int main(int argc, char* argv[])
 	context = SDL_GL_CreateContext(window);
 
 	obj << Begin();
+	//leave objects bound after use. binds of the same object are skipped
+	obj.getBindState().setUnbindToZero(false);
 
 	SDL_GL_SetSwapInterval(1);
 
@@ -71,7 +73,7 @@ int main(int argc, char* argv[])
 	vshader << vshader_source;
 	fshader << fshader_source;
 
-	program << vshader << fshader << link_these();
+	program << vshader << fshader << VertexLayout("vertex", "normal", "texcrd") << link_these();
 
 	VShader simple_vshader;
 	FShader simple_fshader;
@@ -80,7 +82,7 @@ int main(int argc, char* argv[])
 	simple_vshader << simple_vshader_source;
 	simple_fshader << simple_fshader_source;
 
-	simple_program << simple_vshader << simple_fshader << link_these();
+	simple_program << simple_vshader << simple_fshader << VertexLayout("vertex", "normal", "texcrd") << link_these();
 
 	Texture<Texture2D> texture;
 	texture.texImage2D("texture.jpg");
@@ -123,6 +125,7 @@ int main(int argc, char* argv[])
 	Mesh3D sphere_mesh;
 	MeshSample::Sphere spherehelper(5.0, 50, 50);
 	sphere_mesh.copyData(spherehelper.getVertex(), spherehelper.getNormal(), spherehelper.getTexcrd(), spherehelper.getNumVertex());
+	sphere_mesh.copyIndex(spherehelper.getIndex(), spherehelper.getNumIndex());
 	sphere_mesh.setPos(glm::vec3(0.0f, 0.0f, 5.0f));
 
 	Camera camera;
@@ -180,9 +183,11 @@ int main(int argc, char* argv[])
 	SDL_Event e;
 	//	SDL_WaitThread(threadID, NULL);
 	
+	std::size_t issued = 0, skipped = 0;
 
 	while( !quit )
 	{
+		obj.getBindState().resetCount();
 
 		int width;
 		int height;
@@ -215,14 +220,12 @@ int main(int argc, char* argv[])
 		obj.clear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT, fbo);
 		glEnable(GL_CULL_FACE);
 		glEnable(GL_DEPTH_TEST);
-		obj.connectAttrib(program, floor_mesh, "vertex", "normal", "texcrd");
 		program.setUniformMatrixXtv("model", glm::value_ptr(floor_mesh.getModelMatrix()), 1, 4);
 		texture.bind(0);
 		fbo.bind();
 		obj.draw(floor_mesh, program);
 		fbo.unbind();
 		texture.unbind();
-		obj.connectAttrib(program, sphere_mesh, "vertex", "normal", "texcrd");
 		program.setUniformMatrixXtv("model", glm::value_ptr(sphere_mesh.getModelMatrix()), 1, 4);
 		texture.bind(0);
 		fbo.bind();
@@ -238,7 +241,6 @@ int main(int argc, char* argv[])
 		obj.clear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 		glEnable(GL_CULL_FACE);
 		glEnable(GL_DEPTH_TEST);
-		obj.connectAttrib(simple_program, floor_mesh, "vertex", "normal", "texcrd");
 		simple_program.setUniformMatrixXtv("model", glm::value_ptr(floor_mesh.getModelMatrix()), 1, 4);
 		camera.setAspect(width,height);
 		simple_program.setUniformMatrixXtv("projection", glm::value_ptr(camera.getProjectionMatrix()), 1, 4);
@@ -250,9 +252,14 @@ int main(int argc, char* argv[])
 		
 
 
+		issued = obj.getBindState().getIssuedCount();
+		skipped = obj.getBindState().getSkippedCount();
+
 		SDL_GL_SwapWindow( window );
 	}
 
+	std::cout << "bind calls per frame: issued " << issued << ", skipped " << skipped << std::endl;
+
 	//	obj << End();
 
 	SDL_GL_DeleteContext(context);
@@ -0,0 +1,185 @@
+#include "../include/gl_all.h"
+#include <vector>
+#include <memory>
+#include <chrono>
+#include <random>
+#include <cmath>
+
+//world matrices of a hierarchy of about 100k nodes (root -> 100 groups -> 10 -> 100 leaves):
+//a pointer tree recomputed recursively every frame vs SceneGraph::update (depth first arrays, only the dirty subtrees).
+//usage: scenebench [model file] (prints the node hierarchy of the model)
+
+const std::size_t GROUP_NUM = 100;
+const std::size_t SUBGROUP_NUM = 10;
+const std::size_t LEAF_NUM = 100;
+const int REPEAT = 20;
+
+using Clock = std::chrono::steady_clock;
+
+template<typename Func>
+double bestOf(int repeat, Func func)
+{
+	double best = 0.0;
+	for(int i = 0; i < repeat; i++)
+	{
+		auto start = Clock::now();
+		func();
+		double ms = std::chrono::duration<double, std::milli>(Clock::now()-start).count();
+		if(i == 0 || ms < best)
+			best = ms;
+	}
+	return best;
+}
+
+//one heap object per node
+struct TreeNode
+{
+	glm::mat4 local;
+	glm::mat4 world;
+	std::vector<std::unique_ptr<TreeNode>> children;
+};
+
+void computeWorld(TreeNode &node, const glm::mat4 &parent_world)
+{
+	node.world = parent_world*node.local;
+	for(auto&& child : node.children)
+		computeWorld(*child, node.world);
+}
+
+void printResult(const std::string &label, double ms, std::size_t updated)
+{
+	std::cout << label << ms << " ms  (" << updated << " matrices)" << std::endl;
+}
+
+void printHierarchy(const jikoLib::GLLib::SceneGraph &scene)
+{
+	for(std::size_t i = 0; i < scene.size(); i++)
+	{
+		std::size_t depth = 0;
+		for(std::size_t p = scene.getParent(i); p != jikoLib::GLLib::SceneGraph::NONE; p = scene.getParent(p))
+			depth++;
+		std::cout << std::string(depth*2, ' ') << scene.getName(i) << " (" << scene.getMeshes(i).size() << " meshes)" << std::endl;
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	using namespace jikoLib::GLLib;
+
+	if(argc > 1)
+	{
+		AssimpLoader loader(argv[1]);
+		SceneGraph scene;
+		if(scene.import(loader.getScene()) == SceneGraph::NONE)
+			return 1;
+		scene.update();
+		printHierarchy(scene);
+		return 0;
+	}
+
+	std::mt19937 rng(1);
+	std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+	auto randomLocal = [&]()
+	{
+		Transform t;
+		t.setPos(glm::vec3(dist(rng), dist(rng), dist(rng))*10.0f);
+		t.rotate(glm::vec3(dist(rng), dist(rng), dist(rng)+2.0f), dist(rng)*3.0f);
+		t.setScale(glm::vec3(1.0f+0.1f*dist(rng)));
+		return t.getMatrix();
+	};
+
+	//the same hierarchy in both
+	SceneGraph scene;
+	TreeNode root;
+	root.local = randomLocal();
+	const std::size_t scene_root = scene.addNode("root", SceneGraph::NONE, root.local);
+	std::vector<std::size_t> groups;
+	for(std::size_t g = 0; g < GROUP_NUM; g++)
+	{
+		root.children.emplace_back(new TreeNode());
+		TreeNode &group = *root.children.back();
+		group.local = randomLocal();
+		const std::size_t scene_group = scene.addNode("group" + std::to_string(g), scene_root, group.local);
+		groups.push_back(scene_group);
+		for(std::size_t s = 0; s < SUBGROUP_NUM; s++)
+		{
+			group.children.emplace_back(new TreeNode());
+			TreeNode &subgroup = *group.children.back();
+			subgroup.local = randomLocal();
+			const std::size_t scene_subgroup = scene.addNode("sub", scene_group, subgroup.local);
+			for(std::size_t l = 0; l < LEAF_NUM; l++)
+			{
+				subgroup.children.emplace_back(new TreeNode());
+				subgroup.children.back()->local = randomLocal();
+				scene.addNode("leaf", scene_subgroup, subgroup.children.back()->local);
+			}
+		}
+	}
+	std::cout << scene.size() << " nodes" << std::endl;
+
+	double ms = bestOf(REPEAT, [&]()
+			{
+			computeWorld(root, glm::mat4(1.0f));
+			});
+	printResult("pointer tree (all)          : ", ms, scene.size());
+
+	ms = bestOf(REPEAT, [&]()
+			{
+			scene.setLocal(scene_root, scene.getLocal(scene_root));
+			scene.update();
+			});
+	printResult("SceneGraph (root moved)     : ", ms, scene.getNumUpdated());
+
+	//one group moved: 1% of the tree
+	ms = bestOf(REPEAT, [&]()
+			{
+			scene.setLocal(groups[GROUP_NUM/2], scene.getLocal(groups[GROUP_NUM/2]));
+			scene.update();
+			});
+	printResult("SceneGraph (1 group moved)  : ", ms, scene.getNumUpdated());
+
+	//100 scattered leaves moved
+	std::vector<std::size_t> leaves;
+	for(std::size_t i = 0; i < scene.size() && leaves.size() < 100; i += scene.size()/100)
+	{
+		while(scene.getSubtreeEnd(i) != i+1)
+			i++;
+		leaves.push_back(i);
+	}
+	ms = bestOf(REPEAT, [&]()
+			{
+			for(auto&& i : leaves)
+				scene.setLocal(i, scene.getLocal(i));
+			scene.update();
+			});
+	printResult("SceneGraph (100 nodes moved): ", ms, scene.getNumUpdated());
+
+	ms = bestOf(REPEAT, [&]()
+			{
+			scene.update();
+			});
+	printResult("SceneGraph (nothing moved)  : ", ms, scene.getNumUpdated());
+
+	//the same world matrices (the depth first order is the order of construction here)
+	float max_error = 0.0f;
+	std::size_t index = 0;
+	std::vector<const TreeNode*> stack(1, &root);
+	while(!stack.empty())
+	{
+		const TreeNode* node = stack.back();
+		stack.pop_back();
+		for(auto it = node->children.rbegin(); it != node->children.rend(); ++it)
+			stack.push_back(it->get());
+		for(int c = 0; c < 4; c++)
+		{
+			for(int r = 0; r < 4; r++)
+			{
+				const float scale = std::max(1.0f, std::fabs(node->world[c][r]));
+				max_error = std::max(max_error, std::fabs(scene.getWorld(index)[c][r]-node->world[c][r])/scale);
+			}
+		}
+		index++;
+	}
+	std::cout << "max relative error vs pointer tree: " << max_error << std::endl;
+	return 0;
+}
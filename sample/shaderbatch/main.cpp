@@ -0,0 +1,119 @@
+#include "../include/gl_all.h"
+#include <vector>
+#include <chrono>
+#include <SDL2/SDL.h>
+#include <IL/ilu.h>
+#include <SDL2/SDL_opengl.h>
+
+jikoLib::GLLib::GLObject obj;
+
+const std::string vshader_source =
+#include "shader.vert"
+;
+const std::string fshader_source =
+#include "shader.frag"
+;
+
+//PROGRAM_NUM programs: compile + link one after another (before) vs ShaderBatch (after).
+//the sources have a per-run seed, so the shader cache of the driver does not hide the compile.
+
+const int PROGRAM_NUM = 32;
+
+using Clock = std::chrono::steady_clock;
+
+inline double elapsed(Clock::time_point start)
+{
+	return std::chrono::duration<double, std::milli>(Clock::now()-start).count();
+}
+
+std::string variant(const std::string &source, long long seed, int n)
+{
+	std::size_t line = source.find('\n', source.find("#version"));
+	return source.substr(0, line+1) + "#define SEED " + std::to_string(seed) + "\n#define VARIANT " + std::to_string(n) + "\n" + source.substr(line+1);
+}
+
+int main(int argc, char* argv[])
+{
+	using namespace jikoLib::GLLib;
+
+
+	if(SDL_Init(SDL_INIT_EVERYTHING) < 0)
+	{
+		std::cerr << "Cannot Initialize SDL!: " << SDL_GetError() << std::endl;
+		return -1;
+	}
+
+	SDL_GL_SetAttribute(SDL_GL_RED_SIZE, 5);
+	SDL_GL_SetAttribute(SDL_GL_GREEN_SIZE, 5);
+	SDL_GL_SetAttribute(SDL_GL_BLUE_SIZE, 5);
+	SDL_GL_SetAttribute(SDL_GL_DEPTH_SIZE, 16);
+	SDL_GL_SetAttribute(SDL_GL_DOUBLEBUFFER, 1);
+
+	SDL_Window* window = SDL_CreateWindow("SDL_Window", SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED, 64, 64, SDL_WINDOW_OPENGL);
+	if(window == NULL)
+	{
+		std::cerr << "Window could not be created!: " << SDL_GetError() << std::endl;
+	}
+
+	SDL_GLContext context;
+
+	context = SDL_GL_CreateContext(window);
+
+	obj << Begin();
+
+	SDL_GL_MakeCurrent(window, context);
+
+	const VertexLayout layout("vertex", "normal", "texcrd");
+	const long long seed = Clock::now().time_since_epoch().count();
+	std::cout << "KHR_parallel_shader_compile: " << ((GLEW_KHR_parallel_shader_compile || GLEW_ARB_parallel_shader_compile) ? "yes" : "no") << std::endl;
+	ShaderBatch::setMaxThreads();
+
+	//before
+	std::vector<ShaderProgram> serial(PROGRAM_NUM);
+	auto start = Clock::now();
+	for(int i = 0; i < PROGRAM_NUM; i++)
+	{
+		VShader vshader;
+		FShader fshader;
+		vshader << variant(vshader_source, seed, i);
+		fshader << variant(fshader_source, seed, i);
+		serial[i] << vshader << fshader << layout << link_these();
+	}
+	glFinish();
+	double before = elapsed(start);
+
+	//after. the frames go on while the driver compiles
+	std::vector<ShaderProgram> batched(PROGRAM_NUM);
+	ShaderBatch batch;
+	for(int i = 0; i < PROGRAM_NUM; i++)
+		batch.add(batched[i], variant(vshader_source, seed, PROGRAM_NUM+i), variant(fshader_source, seed, PROGRAM_NUM+i), layout);
+	start = Clock::now();
+	batch.submit();
+	double submit_ms = elapsed(start);
+	int frames = 0;
+	double longest_poll = 0.0;
+	while(true)
+	{
+		auto poll_start = Clock::now();
+		bool done = batch.poll();
+		longest_poll = std::max(longest_poll, elapsed(poll_start));
+		if(done)
+			break;
+		glClear(GL_COLOR_BUFFER_BIT);
+		SDL_GL_SwapWindow(window);
+		frames++;
+	}
+	double after = elapsed(start);
+
+	std::cout << PROGRAM_NUM << " programs                        ms" << std::endl;
+	std::cout << "compile + link (serial)          : " << before << std::endl;
+	std::cout << "ShaderBatch (until all linked)   : " << after << std::endl;
+	std::cout << "ShaderBatch submit               : " << submit_ms << std::endl;
+	std::cout << "ShaderBatch longest poll         : " << longest_poll << " (" << frames << " frames while compiling)" << std::endl;
+	std::cout << "failed: " << batch.getNumFailed() << std::endl;
+
+	SDL_GL_DeleteContext(context);
+	SDL_DestroyWindow(window);
+	SDL_Quit();
+	return 0;
+}
@@ -1,5 +1,6 @@
 #include "../include/gl_all.h"
 #include <vector>
+#include <chrono>
 #include <SDL2/SDL.h>
 #include <IL/ilu.h>
 #include <SDL2/SDL_opengl.h>
@@ -65,21 +66,25 @@ int main(int argc, char* argv[])
 	vshader << vshader_source;
 	fshader << fshader_source;
 
-	program << vshader << fshader << link_these();
+	program << vshader << fshader << VertexLayout("vertex", "normal", "texcrd") << link_these();
 
 	Mesh3D mesh;
 	MeshSample::CubeMap cube(1024);
 	mesh.copyData(cube.getVertex(), cube.getNormal(), cube.getTexcrd(), cube.getNumVertex());
+	mesh.copyIndex(cube.getIndex(), cube.getNumIndex());
 
 	Camera camera;
 	camera.setPos(glm::vec3(0.0f, 0.0f, 0.0f));
 	camera.setUp(glm::vec3(0.0f, 1.0f, 0.0f));
 	camera.setFar(1024);
 
+	//skybox startup time (the faces are decoded in parallel)
+	auto load_start = std::chrono::steady_clock::now();
 	Texture<TextureCubeMap> texture;
 	texture.texImage2D("negx.jpg","posx.jpg","negy.jpg","posy.jpg","negz.jpg","posz.jpg");
 	texture.setParameter<Mag_Filter<GL_LINEAR>, Min_Filter<GL_LINEAR>>();
-	obj.connectAttrib(program, mesh, "vertex", "normal", "texcrd");
+	glFinish();
+	std::cout << "skybox loaded in " << std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now()-load_start).count() << " ms" << std::endl;
 	program.setUniformMatrixXtv("model", glm::value_ptr(mesh.getModelMatrix()), 1, 4);
 	program.setUniformMatrixXtv("projection", glm::value_ptr(camera.getProjectionMatrix()), 1, 4);
 
@@ -0,0 +1,167 @@
+#include "../include/gl_all.h"
+#include <vector>
+#include <chrono>
+#include <cmath>
+#include <SDL2/SDL.h>
+#include <IL/ilu.h>
+#include <SDL2/SDL_opengl.h>
+
+jikoLib::GLLib::GLObject obj;
+
+const std::string vshader_source =
+#include "shader.vert"
+;
+const std::string fshader_source =
+#include "shader.frag"
+;
+
+//per-frame geometry: rewritten every frame on the CPU and uploaded
+//StaticDraw (reallocate) vs StreamDraw (orphan) vs DynamicDraw (overwrite) vs persistently mapped ring buffer
+
+const int PARTICLE_NUM = 10000;
+const int FRAME = 200;
+
+using Vertex = jikoLib::GLLib::VertexPNT;
+
+//one small triangle per particle
+void updateParticles(std::vector<Vertex> &vertices, int frame)
+{
+	for(int i = 0; i < PARTICLE_NUM; i++)
+	{
+		GLfloat t = 0.01f*frame + 0.1f*i;
+		GLfloat x = 4.0f*std::cos(t)*std::sin(0.37f*i);
+		GLfloat y = 4.0f*std::sin(t)*std::sin(0.37f*i);
+		GLfloat z = 4.0f*std::cos(0.37f*i);
+		const GLfloat corner[3][2] = {{0.0f, 0.05f}, {-0.05f, -0.05f}, {0.05f, -0.05f}};
+		for(int k = 0; k < 3; k++)
+		{
+			Vertex &v = vertices[3*i+k];
+			v.vertex[0] = x + corner[k][0];
+			v.vertex[1] = y + corner[k][1];
+			v.vertex[2] = z;
+			v.normal[0] = std::cos(0.37f*i);
+			v.normal[1] = std::sin(0.37f*i);
+			v.normal[2] = 0.0f;
+			v.texcrd[0] = 0.0f;
+			v.texcrd[1] = 0.0f;
+		}
+	}
+}
+
+template<typename Func>
+double measure(Func func)
+{
+	glFinish();
+	auto start = std::chrono::steady_clock::now();
+	for(int f = 0; f < FRAME; f++)
+	{
+		func(f);
+	}
+	glFinish();
+	auto end = std::chrono::steady_clock::now();
+	return std::chrono::duration<double, std::milli>(end-start).count()/FRAME;
+}
+
+//copyData every frame
+template<typename UsageType>
+double uploadTest(const jikoLib::GLLib::ShaderProgram &program, std::vector<Vertex> &vertices)
+{
+	using namespace jikoLib::GLLib;
+	const std::size_t FLOAT_NUM = sizeof(Vertex)/sizeof(GLfloat);
+	VertexBuffer<ArrayBuffer, UsageType> vbo;
+	VAO varray;
+	updateParticles(vertices, 0);
+	vbo.copyData(reinterpret_cast<const GLfloat*>(vertices.data()), vertices.size(), FLOAT_NUM);
+	varray.setAttrib<Vertex>(vbo);
+	return measure([&](int f){
+			updateParticles(vertices, f);
+			vbo.copyData(reinterpret_cast<const GLfloat*>(vertices.data()), vertices.size(), FLOAT_NUM);
+			glClear(GL_COLOR_BUFFER_BIT);
+			obj.draw(varray, program, vbo);
+			});
+}
+
+int main(int argc, char* argv[])
+{
+	using namespace jikoLib::GLLib;
+
+
+	if(SDL_Init(SDL_INIT_EVERYTHING) < 0)
+	{
+		std::cerr << "Cannot Initialize SDL!: " << SDL_GetError() << std::endl;
+		return -1;
+	}
+
+	SDL_GL_SetAttribute(SDL_GL_RED_SIZE, 5);
+	SDL_GL_SetAttribute(SDL_GL_GREEN_SIZE, 5);
+	SDL_GL_SetAttribute(SDL_GL_BLUE_SIZE, 5);
+	SDL_GL_SetAttribute(SDL_GL_DEPTH_SIZE, 16);
+	SDL_GL_SetAttribute(SDL_GL_DOUBLEBUFFER, 1);
+
+	//small window: the cost of rasterization is not the point here
+	SDL_Window* window = SDL_CreateWindow("SDL_Window", SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED, 64, 64, SDL_WINDOW_OPENGL);
+	if(window == NULL)
+	{
+		std::cerr << "Window could not be created!: " << SDL_GetError() << std::endl;
+	}
+
+	SDL_GLContext context;
+
+	context = SDL_GL_CreateContext(window);
+
+	obj << Begin();
+
+	SDL_GL_MakeCurrent(window, context);
+
+	VShader vshader;
+	FShader fshader;
+
+	ShaderProgram program;
+
+	vshader << vshader_source;
+	fshader << fshader_source;
+
+	program << vshader << fshader << VertexLayout("vertex", "normal", "texcrd") << link_these();
+
+	Camera camera;
+	camera.setPos(glm::vec3(0.0f, 0.0f, 10.0f));
+	camera.setDrct(glm::vec3(0.0f, 0.0f, 0.0f));
+	camera.setUp(glm::vec3(0.0f, 1.0f, 0.0f));
+	camera.setAspect(64, 64);
+
+	program.setUniformMatrixXtv("view", glm::value_ptr(camera.getViewMatrix()), 1, 4);
+	program.setUniformMatrixXtv("projection", glm::value_ptr(camera.getProjectionMatrix()), 1, 4);
+	program.setUniformMatrixXtv("model", glm::value_ptr(glm::mat4(1.0f)), 1, 4);
+
+	std::vector<Vertex> vertices(3*PARTICLE_NUM);
+
+	double static_ms = uploadTest<StaticDraw>(program, vertices);
+	double stream_ms = uploadTest<StreamDraw>(program, vertices);
+	double dynamic_ms = uploadTest<DynamicDraw>(program, vertices);
+
+	//3 frames in flight
+	RingVBO ring(vertices.size()*sizeof(Vertex), 3);
+	VAO ring_varray;
+	ring_varray.setAttrib<Vertex>(ring);
+	double ring_ms = measure([&](int f){
+			ring.beginFrame();
+			updateParticles(vertices, f);
+			std::size_t offset = ring.write(vertices.data(), vertices.size());
+			glClear(GL_COLOR_BUFFER_BIT);
+			if(offset != RingVBO::npos)
+				obj.draw(ring_varray, program, offset/sizeof(Vertex), vertices.size());
+			ring.endFrame();
+			});
+
+	std::cout << PARTICLE_NUM << " particles, " << vertices.size()*sizeof(Vertex)/1024 << " KB per frame (" << FRAME << " frames)" << std::endl;
+	std::cout << "                    ms/frame" << std::endl;
+	std::cout << "StaticDraw        : " << static_ms << std::endl;
+	std::cout << "StreamDraw        : " << stream_ms << std::endl;
+	std::cout << "DynamicDraw       : " << dynamic_ms << std::endl;
+	std::cout << "ring buffer       : " << ring_ms << " (waited " << ring.getWaitCount() << " times)" << std::endl;
+
+	SDL_GL_DeleteContext(context);
+	SDL_DestroyWindow(window);
+	SDL_Quit();
+	return 0;
+}
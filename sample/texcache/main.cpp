@@ -0,0 +1,99 @@
+#include "../include/gl_all.h"
+#include <vector>
+#include <chrono>
+#include <SDL2/SDL.h>
+#include <IL/ilu.h>
+#include <SDL2/SDL_opengl.h>
+
+jikoLib::GLLib::GLObject obj;
+
+//texture startup: decode + glGenerateMipmap (before) vs the cooked TextureCache (after).
+//the caches are written next to the images on the first run (.jtex).
+
+using Clock = std::chrono::steady_clock;
+
+inline double elapsed(Clock::time_point start)
+{
+	return std::chrono::duration<double, std::milli>(Clock::now()-start).count();
+}
+
+int main(int argc, char* argv[])
+{
+	using namespace jikoLib::GLLib;
+
+
+	if(SDL_Init(SDL_INIT_EVERYTHING) < 0)
+	{
+		std::cerr << "Cannot Initialize SDL!: " << SDL_GetError() << std::endl;
+		return -1;
+	}
+
+	SDL_GL_SetAttribute(SDL_GL_RED_SIZE, 5);
+	SDL_GL_SetAttribute(SDL_GL_GREEN_SIZE, 5);
+	SDL_GL_SetAttribute(SDL_GL_BLUE_SIZE, 5);
+	SDL_GL_SetAttribute(SDL_GL_DEPTH_SIZE, 16);
+	SDL_GL_SetAttribute(SDL_GL_DOUBLEBUFFER, 1);
+
+	SDL_Window* window = SDL_CreateWindow("SDL_Window", SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED, 64, 64, SDL_WINDOW_OPENGL);
+	if(window == NULL)
+	{
+		std::cerr << "Window could not be created!: " << SDL_GetError() << std::endl;
+	}
+
+	SDL_GLContext context;
+
+	context = SDL_GL_CreateContext(window);
+
+	obj << Begin();
+
+	SDL_GL_MakeCurrent(window, context);
+
+	const std::vector<std::string> faces = {"negx.jpg", "posx.jpg", "negy.jpg", "posy.jpg", "negz.jpg", "posz.jpg"};
+	const std::string image = "arch-linux-226331.jpg";
+
+	std::cout << "                        2D ms   cubemap ms" << std::endl;
+
+	//before
+	{
+		auto start = Clock::now();
+		Texture<Texture2D> texture;
+		texture.texImage2D(image);
+		texture.generateMipmap();
+		glFinish();
+		double texture_ms = elapsed(start);
+
+		start = Clock::now();
+		Texture<TextureCubeMap> cubemap;
+		cubemap.texImage2D<0, RGB, RGB>(faces[0], faces[1], faces[2], faces[3], faces[4], faces[5]);
+		cubemap.generateMipmap();
+		glFinish();
+		double cubemap_ms = elapsed(start);
+		std::cout << "decode + generateMipmap: " << texture_ms << "  " << cubemap_ms << std::endl;
+	}
+
+	//after. the first load cooks the caches if they are missing or older than the images
+	for(int pass = 0; pass < 2; pass++)
+	{
+		auto start = Clock::now();
+		TextureCache texture_cache;
+		Texture<Texture2D> texture;
+		if(texture_cache.load<RGBA>({image}))
+			texture_cache.upload(texture);
+		glFinish();
+		double texture_ms = elapsed(start);
+
+		start = Clock::now();
+		TextureCache cubemap_cache;
+		Texture<TextureCubeMap> cubemap;
+		if(cubemap_cache.load<RGB>(faces))
+			cubemap_cache.upload(cubemap);
+		glFinish();
+		double cubemap_ms = elapsed(start);
+		std::cout << ((pass == 0) ? "TextureCache (1st)     : " : "TextureCache (mapped)  : ") << texture_ms << "  " << cubemap_ms << std::endl;
+	}
+
+	SDL_GL_DeleteContext(context);
+	SDL_DestroyWindow(window);
+	SDL_Quit();
+	return 0;
+}
@@ -0,0 +1,130 @@
+#include "../include/gl_all.h"
+#include <vector>
+#include <chrono>
+#include <random>
+#include <thread>
+#include <cmath>
+
+//model matrices per second for OBJECT_NUM objects:
+//the old Mesh3D::getModelMatrix (mat4_cast, scale, inverse(mat3), translate) vs the cached Transform vs TransformBatch (SoA, SSE/AVX).
+//build with -mavx (or -march=native) for the AVX kernel.
+
+const std::size_t OBJECT_NUM = 100000;
+const int REPEAT = 20;
+
+using Clock = std::chrono::steady_clock;
+
+template<typename Func>
+double bestOf(int repeat, Func func)
+{
+	double best = 0.0;
+	for(int i = 0; i < repeat; i++)
+	{
+		auto start = Clock::now();
+		func();
+		double ms = std::chrono::duration<double, std::milli>(Clock::now()-start).count();
+		if(i == 0 || ms < best)
+			best = ms;
+	}
+	return best;
+}
+
+//what Mesh3D::getModelMatrix did
+inline glm::mat4 oldModelMatrix(const glm::vec3 &pos, const glm::quat &rot, const glm::vec3 &scale)
+{
+	glm::mat4 mat = glm::mat4_cast(rot);
+	glm::mat4 rs = mat*glm::scale(glm::mat4(), scale);
+	return glm::translate(rs, glm::inverse(glm::mat3(rs))*pos);
+}
+
+void printResult(const std::string &label, double ms, std::size_t matrices)
+{
+	std::cout << label << ms << " ms  " << matrices/ms/1000.0 << " M matrices/s" << std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+	using namespace jikoLib::GLLib;
+
+	std::mt19937 rng(1);
+	std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+	std::vector<Transform> transforms(OBJECT_NUM);
+	TransformBatch batch(OBJECT_NUM);
+	for(std::size_t i = 0; i < OBJECT_NUM; i++)
+	{
+		transforms[i].setPos(glm::vec3(dist(rng), dist(rng), dist(rng))*100.0f);
+		transforms[i].rotate(glm::vec3(dist(rng), dist(rng), dist(rng)+2.0f), dist(rng)*3.0f);
+		transforms[i].setScale(glm::vec3(1.5f+dist(rng), 1.5f+dist(rng), 1.5f+dist(rng)));
+		batch.set(i, transforms[i]);
+	}
+	std::vector<glm::mat4> out(OBJECT_NUM);
+
+	std::cout << OBJECT_NUM << " objects" << std::endl;
+
+	//before
+	double ms = bestOf(REPEAT, [&]()
+			{
+			for(std::size_t i = 0; i < OBJECT_NUM; i++)
+				out[i] = oldModelMatrix(transforms[i].getPos(), transforms[i].getRot(), transforms[i].getScale());
+			});
+	printResult("old getModelMatrix          : ", ms, OBJECT_NUM);
+
+	//Transform: every object moved / nothing moved
+	ms = bestOf(REPEAT, [&]()
+			{
+			for(std::size_t i = 0; i < OBJECT_NUM; i++)
+			{
+				transforms[i].setPos(transforms[i].getPos());
+				out[i] = transforms[i].getMatrix();
+			}
+			});
+	printResult("Transform (all dirty)       : ", ms, OBJECT_NUM);
+	ms = bestOf(REPEAT, [&]()
+			{
+			for(std::size_t i = 0; i < OBJECT_NUM; i++)
+				out[i] = transforms[i].getMatrix();
+			});
+	printResult("Transform (cached)          : ", ms, OBJECT_NUM);
+
+	//TransformBatch
+	std::size_t max_threads = std::thread::hardware_concurrency();
+	if(max_threads == 0)
+		max_threads = 1;
+	for(std::size_t threads = 1; threads <= max_threads; threads *= 2)
+	{
+		ThreadPool pool(threads);
+		ms = bestOf(REPEAT, [&]()
+				{
+				for(std::size_t i = 0; i < OBJECT_NUM; i++)
+					batch.setPos(i, batch.getPos(i));
+				batch.update(pool);
+				});
+		printResult("TransformBatch (" + std::to_string(threads) + " threads)" + ((threads < 10) ? " " : "") + ": ", ms, OBJECT_NUM);
+	}
+	//10% moved each frame
+	ms = bestOf(REPEAT, [&]()
+			{
+			for(std::size_t i = 0; i < OBJECT_NUM; i += 10)
+				batch.setPos(i, batch.getPos(i));
+			batch.update();
+			});
+	printResult("TransformBatch (10% dirty)  : ", ms, OBJECT_NUM);
+
+	//the same matrices as before
+	float max_error = 0.0f;
+	for(std::size_t i = 0; i < OBJECT_NUM; i++)
+	{
+		const glm::mat4 expected = oldModelMatrix(transforms[i].getPos(), transforms[i].getRot(), transforms[i].getScale());
+		for(int c = 0; c < 4; c++)
+		{
+			for(int r = 0; r < 4; r++)
+			{
+				const float scale = std::max(1.0f, std::fabs(expected[c][r]));
+				max_error = std::max(max_error, std::fabs(batch.getMatrix(i)[c][r]-expected[c][r])/scale);
+				max_error = std::max(max_error, std::fabs(transforms[i].getMatrix()[c][r]-expected[c][r])/scale);
+			}
+		}
+	}
+	std::cout << "max relative error vs old getModelMatrix: " << max_error << std::endl;
+	return 0;
+}
@@ -0,0 +1,124 @@
+#include "../include/gl_all.h"
+#include <vector>
+#include <chrono>
+#include <SDL2/SDL.h>
+#include <IL/ilu.h>
+#include <SDL2/SDL_opengl.h>
+
+jikoLib::GLLib::GLObject obj;
+
+const std::string vshader_source =
+#include "shader.vert"
+;
+const std::string fshader_source =
+#include "shader.frag"
+;
+
+//per-call cost of setUniform*: glGetUniformLocation + bind/unbind (before) vs cached location (after)
+
+const int LOOP = 100000;
+
+template<typename Func>
+double measure(Func func)
+{
+	glFinish();
+	auto start = std::chrono::steady_clock::now();
+	for(int i = 0; i < LOOP; i++)
+	{
+		func(i);
+	}
+	glFinish();
+	auto end = std::chrono::steady_clock::now();
+	return std::chrono::duration<double, std::nano>(end-start).count()/LOOP;
+}
+
+int main(int argc, char* argv[])
+{
+	using namespace jikoLib::GLLib;
+
+
+	if(SDL_Init(SDL_INIT_EVERYTHING) < 0)
+	{
+		std::cerr << "Cannot Initialize SDL!: " << SDL_GetError() << std::endl;
+		return -1;
+	}
+
+	SDL_GL_SetAttribute(SDL_GL_RED_SIZE, 5);
+	SDL_GL_SetAttribute(SDL_GL_GREEN_SIZE, 5);
+	SDL_GL_SetAttribute(SDL_GL_BLUE_SIZE, 5);
+	SDL_GL_SetAttribute(SDL_GL_DEPTH_SIZE, 16);
+	SDL_GL_SetAttribute(SDL_GL_DOUBLEBUFFER, 1);
+
+	SDL_Window* window = SDL_CreateWindow("SDL_Window", SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED, 400, 300, SDL_WINDOW_OPENGL);
+	if(window == NULL)
+	{
+		std::cerr << "Window could not be created!: " << SDL_GetError() << std::endl;
+	}
+
+	SDL_GLContext context;
+
+	context = SDL_GL_CreateContext(window);
+
+	obj << Begin();
+
+	SDL_GL_MakeCurrent(window, context);
+
+	VShader vshader;
+	FShader fshader;
+
+	ShaderProgram program;
+
+	vshader << vshader_source;
+	fshader << fshader_source;
+
+	program << vshader << fshader << link_these();
+
+	Mesh3D cube;
+	glm::mat4 model_mat = cube.getModelMatrix();
+	const GLfloat *model = glm::value_ptr(model_mat);
+
+	//before: what every setter did until the location table was added
+	double before_mat = measure([&](int){
+			glUseProgram(program.getID());
+			GLint loc = glGetUniformLocation(program.getID(), "model");
+			glUniformMatrix4fv(loc, 1, GL_FALSE, model);
+			glUseProgram(0);
+			});
+	double before_vec = measure([&](int i){
+			glUseProgram(program.getID());
+			GLint loc = glGetUniformLocation(program.getID(), "material.diffuse");
+			glUniform4f(loc, 0.75f, 0.0f, 1.0f, static_cast<GLfloat>(i&1));
+			glUseProgram(0);
+			});
+	//raw glUseProgram calls above are not known to the bind state
+	obj.getBindState().invalidate();
+
+	//after: name hashed at each call
+	double after_mat = measure([&](int){
+			program.setUniformMatrixXtv("model", model, 1, 4);
+			});
+	double after_vec = measure([&](int i){
+			program.setUniformXt("material.diffuse", 0.75f, 0.0f, 1.0f, static_cast<GLfloat>(i&1));
+			});
+
+	//after: precomputed name hash
+	constexpr UniformName u_model("model");
+	constexpr UniformName u_diffuse("material.diffuse");
+	double hashed_mat = measure([&](int){
+			program.setUniformMatrixXtv(u_model, model, 1, 4);
+			});
+	double hashed_vec = measure([&](int i){
+			program.setUniformXt(u_diffuse, 0.75f, 0.0f, 1.0f, static_cast<GLfloat>(i&1));
+			});
+
+	std::cout << "ns per call (" << LOOP << " calls)" << std::endl;
+	std::cout << "                      mat4     vec4" << std::endl;
+	std::cout << "before              : " << before_mat << "  " << before_vec << std::endl;
+	std::cout << "cached (string)     : " << after_mat << "  " << after_vec << std::endl;
+	std::cout << "cached (UniformName): " << hashed_mat << "  " << hashed_vec << std::endl;
+
+	SDL_GL_DeleteContext(context);
+	SDL_DestroyWindow(window);
+	SDL_Quit();
+	return 0;
+}
@@ -0,0 +1,244 @@
+#include "../include/gl_all.h"
+#include <vector>
+#include <SDL2/SDL.h>
+#include <IL/ilu.h>
+#include <SDL2/SDL_opengl.h>
+
+jikoLib::GLLib::GLObject obj;
+
+const std::string vshader_source =
+#include "shader.vert"
+;
+const std::string fshader_source =
+#include "shader.frag"
+;
+const std::string simple_vshader_source =
+#include "simple2.vert"
+;
+const std::string simple_fshader_source =
+#include "simple2.frag"
+;
+
+//binding points of the uniform blocks
+const GLuint CAMERA_BINDING = 0;
+const GLuint LIGHT_BINDING = 1;
+const GLuint MATERIAL_BINDING = 2;
+
+int main(int argc, char* argv[])
+{
+	using namespace jikoLib::GLLib;
+
+
+	if(SDL_Init(SDL_INIT_EVERYTHING) < 0)
+	{
+		std::cerr << "Cannot Initialize SDL!: " << SDL_GetError() << std::endl;
+		return -1;
+	}
+
+	SDL_GL_SetAttribute(SDL_GL_RED_SIZE, 5);
+	SDL_GL_SetAttribute(SDL_GL_GREEN_SIZE, 5);
+	SDL_GL_SetAttribute(SDL_GL_BLUE_SIZE, 5);
+	SDL_GL_SetAttribute(SDL_GL_DEPTH_SIZE, 16);
+	SDL_GL_SetAttribute(SDL_GL_DOUBLEBUFFER, 1);
+
+	SDL_Window* window = SDL_CreateWindow("SDL_Window", SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED, 1200, 800, SDL_WINDOW_OPENGL);
+	if(window == NULL)
+	{
+		std::cerr << "Window could not be created!: " << SDL_GetError() << std::endl;
+	}
+
+	SDL_GLContext context;
+
+	context = SDL_GL_CreateContext(window);
+
+	obj << Begin();
+
+	SDL_GL_SetSwapInterval(1);
+
+	SDL_GL_MakeCurrent(window, context);
+
+	VShader vshader;
+	FShader fshader;
+
+	ShaderProgram program;
+
+	vshader << vshader_source;
+	fshader << fshader_source;
+
+	program << vshader << fshader << VertexLayout("vertex", "normal", "texcrd") << link_these();
+
+	VShader simple_vshader;
+	FShader simple_fshader;
+
+	ShaderProgram simple_program;
+	simple_vshader << simple_vshader_source;
+	simple_fshader << simple_fshader_source;
+
+	simple_program << simple_vshader << simple_fshader << VertexLayout("vertex", "normal", "texcrd") << link_these();
+
+	//both programs read the same camera block
+	program.bindUniformBlock("CameraBlock", CAMERA_BINDING);
+	program.bindUniformBlock("LightBlock", LIGHT_BINDING);
+	program.bindUniformBlock("MaterialBlock", MATERIAL_BINDING);
+	simple_program.bindUniformBlock("CameraBlock", CAMERA_BINDING);
+
+	//camera block
+	Std140Layout camera_layout;
+	const std::size_t camera_view = camera_layout.push<glm::mat4>();
+	const std::size_t camera_projection = camera_layout.push<glm::mat4>();
+
+	//light block
+	Std140Layout light_layout;
+	light_layout.beginStruct();
+	const std::size_t light_ambient = light_layout.push<glm::vec4>();
+	const std::size_t light_diffuse = light_layout.push<glm::vec4>();
+	const std::size_t light_specular = light_layout.push<glm::vec4>();
+	const std::size_t light_position = light_layout.push<glm::vec3>();
+	light_layout.endStruct();
+
+	//material block
+	Std140Layout material_layout;
+	material_layout.beginStruct();
+	const std::size_t material_ambient = material_layout.push<glm::vec4>();
+	const std::size_t material_diffuse = material_layout.push<glm::vec4>();
+	const std::size_t material_specular = material_layout.push<glm::vec4>();
+	const std::size_t material_shininess = material_layout.push<GLfloat>();
+	material_layout.endStruct();
+	material_layout.beginStruct();
+	const std::size_t attenuation_constant = material_layout.push<GLfloat>();
+	const std::size_t attenuation_linear = material_layout.push<GLfloat>();
+	const std::size_t attenuation_quadratic = material_layout.push<GLfloat>();
+	material_layout.endStruct();
+
+	if(program.getUniformBlockSize("CameraBlock") != static_cast<GLint>(camera_layout.size()) ||
+			program.getUniformBlockSize("LightBlock") != static_cast<GLint>(light_layout.size()) ||
+			program.getUniformBlockSize("MaterialBlock") != static_cast<GLint>(material_layout.size()))
+	{
+		std::cerr << "uniform block size mismatch!" << std::endl;
+	}
+
+	UBO camera_block(camera_layout);
+	UBO light_block(light_layout);
+	UBO material_block(material_layout);
+
+	light_block.set(light_ambient, glm::vec4(0.75f, 0.75f, 0.75f, 1.0f));
+	light_block.set(light_diffuse, glm::vec4(1.0f, 1.0f, 1.0f, 1.0f));
+	light_block.set(light_specular, glm::vec4(1.0f, 1.0f, 1.0f, 1.0f));
+	light_block.set(light_position, glm::vec3(-1.0f, -1.0f, 10.0f));
+
+	material_block.set(material_ambient, glm::vec4(0.3f, 0.25f, 0.4f, 1.0f));
+	material_block.set(material_diffuse, glm::vec4(0.75f, 0.0f, 1.0f, 1.0f));
+	material_block.set(material_specular, glm::vec4(1.0f, 1.0f, 1.0f, 1.0f));
+	material_block.set(material_shininess, 32.0f);
+	material_block.set(attenuation_constant, 0.0f);
+	material_block.set(attenuation_linear, 0.0f);
+	material_block.set(attenuation_quadratic, 0.05f);
+
+	camera_block.bindBase(CAMERA_BINDING);
+	light_block.bindBase(LIGHT_BINDING);
+	material_block.bindBase(MATERIAL_BINDING);
+
+	simple_program.setUniformXt("textureobj", 0);
+
+	Texture<Texture2D> texture;
+	texture.texImage2D("texture.jpg");
+	texture.setParameter<Wrap_S<GL_REPEAT>, Wrap_T<GL_REPEAT>>();
+
+	GLfloat floor_vertex[][3] =
+	{
+		{ 100.0f,  100.0f, 0.0f},
+		{-100.0f,  100.0f, 0.0f},
+		{-100.0f, -100.0f, 0.0f},
+		{ 100.0f, -100.0f, 0.0f}
+	};
+
+	const GLfloat floor_normal[][3] =
+	{
+		{0.0f, 0.0f, 1.0f},
+		{0.0f, 0.0f, 1.0f},
+		{0.0f, 0.0f, 1.0f},
+		{0.0f, 0.0f, 1.0f}
+	};
+
+	const GLfloat floor_texcrd[][2] =
+	{
+		{10.0f, 10.0f},
+		{0.0f, 10.0f},
+		{0.0f, 0.0f},
+		{10.0f, 0.0f}
+	};
+
+	const GLushort floor_index[] =
+	{
+		0,1,2,0,2,3
+	};
+
+	Mesh3D floor_mesh;
+	floor_mesh.copyData(floor_vertex, floor_normal, floor_texcrd);
+	floor_mesh.copyIndex(floor_index);
+
+	Mesh3D sphere_mesh;
+	MeshSample::Sphere spherehelper(5.0, 50, 50);
+	sphere_mesh.copyData(spherehelper.getVertex(), spherehelper.getNormal(), spherehelper.getTexcrd(), spherehelper.getNumVertex());
+	sphere_mesh.copyIndex(spherehelper.getIndex(), spherehelper.getNumIndex());
+	sphere_mesh.setPos(glm::vec3(0.0f, 0.0f, 5.0f));
+
+	Camera camera;
+	camera.setDrct(glm::vec3(0.0f, 0.0f, 0.0f));
+	camera.setAspect(1200, 800);
+	camera.setFar(1000.0f);
+	camera.setUp(glm::vec3(0.0f, 0.0f, 1.0f));
+
+	bool quit = false;
+	SDL_Event e;
+
+	std::size_t frame = 0;
+	std::size_t uploads[3] = {0, 0, 0};
+
+	while( !quit )
+	{
+		//Handle events on queue
+		while( SDL_PollEvent( &e ) != 0 )
+		{
+			//User requests quit
+			if( e.type == SDL_QUIT )
+			{
+				quit = true;
+			}
+		}
+		CHECK_GL_ERROR;
+
+		//camera moves every frame. light and material are not changed.
+		GLfloat angle = 0.01f*frame;
+		camera.setPos(glm::vec3(50.0f*std::cos(angle), 50.0f*std::sin(angle), 13.0f));
+		camera_block.set(camera_view, camera.getViewMatrix());
+		camera_block.set(camera_projection, camera.getProjectionMatrix());
+
+		uploads[0] += camera_block.update();
+		uploads[1] += light_block.update();
+		uploads[2] += material_block.update();
+
+		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+		glEnable(GL_CULL_FACE);
+		glEnable(GL_DEPTH_TEST);
+		glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+
+		program.setUniformMatrixXtv("model", glm::value_ptr(floor_mesh.getModelMatrix()), 1, 4);
+		obj.draw(floor_mesh, program);
+
+		simple_program.setUniformMatrixXtv("model", glm::value_ptr(sphere_mesh.getModelMatrix()), 1, 4);
+		texture.bind(0);
+		obj.draw(sphere_mesh, simple_program);
+		texture.unbind();
+
+		SDL_GL_SwapWindow( window );
+		frame++;
+	}
+
+	std::cout << "uniform block uploads in " << frame << " frames: camera " << uploads[0] << ", light " << uploads[1] << ", material " << uploads[2] << std::endl;
+
+	SDL_GL_DeleteContext(context);
+	SDL_DestroyWindow(window);
+	SDL_Quit();
+	return 0;
+}
@@ -0,0 +1,25 @@
+R"(
+#version 120
+#extension GL_ARB_uniform_buffer_object : require
+
+attribute vec3 vertex;
+attribute vec3 normal;
+attribute vec2 texcrd;
+
+uniform mat4 model;
+
+//shared by all programs (binding point 0)
+layout(std140) uniform CameraBlock
+{
+	mat4 view;
+	mat4 projection;
+};
+
+varying vec2 Texcrd;
+
+void main()
+{
+	Texcrd = texcrd;
+	gl_Position = projection * view * model * vec4(vertex, 1.0);
+}
+)"
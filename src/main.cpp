@@ -65,15 +65,17 @@ int main(int argc, char* argv[])
 	vshader << vshader_source;
 	fshader << fshader_source;
 
-	program << vshader << fshader << link_these();
+	program << vshader << fshader << VertexLayout("vertex", "normal", "texcrd") << link_these();
 
 	Mesh3D mesh;
 	MeshSample::CubeMap cube(1024);
 	mesh.copyData(cube.getVertex(), cube.getNormal(), cube.getTexcrd(), cube.getNumVertex());
+	mesh.copyIndex(cube.getIndex(), cube.getNumIndex());
 
 	Mesh3D mesh_sp;
 	MeshSample::Sphere sphere(30.0f, 50, 50);
 	mesh_sp.copyData(sphere.getVertex(), sphere.getNormal(), sphere.getTexcrd(), sphere.getNumVertex());
+	mesh_sp.copyIndex(sphere.getIndex(), sphere.getNumIndex());
 	mesh_sp.setPos(glm::vec3(0.0f, 0.0f, -200.0f));
 
 	Camera camera;
@@ -183,14 +185,12 @@ int main(int argc, char* argv[])
 
 		program.setUniformMatrixXtv("model", glm::value_ptr(mesh.getModelMatrix()), 1, 4);
 		program.setUniformXt("drawsphere", 0);
-		obj.connectAttrib(program, mesh, "vertex", "normal", "texcrd");
 		texture.bind(0);
 		obj.draw(mesh, program);
 		texture.unbind();
 
 		program.setUniformMatrixXtv("model", glm::value_ptr(mesh_sp.getModelMatrix()), 1, 4);
 		program.setUniformXt("drawsphere", 1);
-		obj.connectAttrib(program, mesh_sp, "vertex", "normal", "texcrd");
 		texture.bind(0);
 		obj.draw(mesh_sp, program);
 		texture.unbind();